@@ -0,0 +1,122 @@
+/* Actor sets that overlays can be bound to, and batched sampling of their stats.
+ * ----------
+ * Stats of every actor in a set are sampled in one pass per tick into contiguous per-stat arrays (structure of
+ * arrays), and the min/max/average and the lowest-health actor's stats are aggregated in that same pass.
+*/
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace actors
+{
+    enum Stat { Health, Stamina, Magicka, StatCount };
+
+    // which actor(s) an overlay follows
+    enum class Target { Player, CombatTarget, Followers };
+
+    // how the stats of a multi-actor target are combined into one value
+    enum class Aggregate { Min, Max, Average, LowestHealth };
+
+    // per-actor stat percentages, one contiguous array per stat
+    struct SampleBatch {
+        std::array<std::vector<float>, StatCount> values;
+
+        std::size_t size() const { return values[Health].size(); }
+        void clear() { for (auto &v: values) { v.clear(); } }
+        void reserve(std::size_t n) { for (auto &v: values) { v.reserve(n); } }
+        void push(float health, float stamina, float magicka) {
+            values[Health].push_back(health);
+            values[Stamina].push_back(stamina);
+            values[Magicka].push_back(magicka);
+        }
+    };
+
+    // aggregated stats of a batch. An empty batch reads as full stats (no effect)
+    struct Aggregates {
+        std::size_t count = 0;
+        std::array<float, StatCount> min = {1.0f, 1.0f, 1.0f};
+        std::array<float, StatCount> max = {1.0f, 1.0f, 1.0f};
+        std::array<float, StatCount> average = {1.0f, 1.0f, 1.0f};
+        std::array<float, StatCount> lowestHealth = {1.0f, 1.0f, 1.0f};
+
+        float get(Aggregate aggregate, Stat stat) const {
+            switch (aggregate) {
+                case Aggregate::Max: return max[stat];
+                case Aggregate::Average: return average[stat];
+                case Aggregate::LowestHealth: return lowestHealth[stat];
+                default: return min[stat];
+            }
+        }
+    };
+
+    // single pass over the batch computing every aggregate
+    inline Aggregates aggregate(const SampleBatch &batch) {
+        Aggregates out;
+        out.count = batch.size();
+        if (out.count == 0) { return out; }
+        std::array<float, StatCount> sum = {0.0f, 0.0f, 0.0f};
+        out.min = {2.0f, 2.0f, 2.0f};
+        out.max = {-1.0f, -1.0f, -1.0f};
+        std::size_t lowest = 0;
+        const float *health = batch.values[Health].data();
+        for (std::size_t i = 0; i < out.count; i++) {
+            for (int s = 0; s < StatCount; s++) {
+                float v = batch.values[s][i];
+                out.min[s] = std::min(out.min[s], v);
+                out.max[s] = std::max(out.max[s], v);
+                sum[s] += v;
+            }
+            if (health[i] < health[lowest]) { lowest = i; }
+        }
+        for (int s = 0; s < StatCount; s++) {
+            out.average[s] = sum[s] / static_cast<float>(out.count);
+            out.lowestHealth[s] = batch.values[s][lowest];
+            // min and max skip a NaN read, so carry it through every aggregate of that stat for the tick to fault on
+            if (std::isnan(sum[s])) { out.min[s] = out.max[s] = sum[s]; }
+        }
+        // and without every actor's health there's no telling who has the least
+        if (std::isnan(sum[Health])) { out.lowestHealth = {sum[Health], sum[Health], sum[Health]}; }
+        return out;
+    }
+
+    // get target from its name (case insensitive, the settings reader has already removed spaces). Returns Player if unrecognized
+    inline Target getTargetString(std::string name, Aggregate *impliedAggregate = nullptr) {
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        if (name == "combattarget" || name == "target" || name == "enemy" || name == "opponent") { return Target::CombatTarget; }
+        if (name == "followers" || name == "follower" || name == "teammates" || name == "teammate" || name == "party") { return Target::Followers; }
+        if (name == "lowesthealthteammate" || name == "lowestteammate" || name == "weakestfollower" || name == "lowesthealthfollower") {
+            if (impliedAggregate) { *impliedAggregate = Aggregate::LowestHealth; }
+            return Target::Followers;
+        }
+        return Target::Player;
+    }
+
+    // get aggregate from its name (case insensitive, the settings reader has already removed spaces). Returns Min if unrecognized
+    inline Aggregate getAggregateString(std::string name) {
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        if (name == "max" || name == "highest" || name == "maximum") { return Aggregate::Max; }
+        if (name == "average" || name == "avg" || name == "mean") { return Aggregate::Average; }
+        if (name == "lowesthealth" || name == "weakest") { return Aggregate::LowestHealth; }
+        return Aggregate::Min;
+    }
+
+    inline const char* getStringTarget(Target target) {
+        switch (target) {
+            case Target::CombatTarget: return "combattarget";
+            case Target::Followers: return "followers";
+            default: return "player";
+        }
+    }
+
+    inline const char* getStringAggregate(Aggregate aggregate) {
+        switch (aggregate) {
+            case Aggregate::Max: return "max";
+            case Aggregate::Average: return "average";
+            case Aggregate::LowestHealth: return "lowesthealth";
+            default: return "min";
+        }
+    }
+}
@@ -0,0 +1,46 @@
+/* Per-overlay fault isolation: a circuit breaker with exponential backoff.
+ * ----------
+ * Each failure backs the overlay off for twice as many ticks as the previous one (up to a cap). Once the overlay
+ * has used up its fault budget it trips and stays off until the settings are reloaded. A long healthy streak
+ * forgives one fault, so a rare hiccup does not eventually disable an overlay for good.
+*/
+#pragma once
+#include <algorithm>
+#include <cstdint>
+
+namespace breaker
+{
+    struct Settings {
+        int budget = 10;           // faults allowed before the overlay is disabled
+        int backoffTicks = 10;     // ticks to skip after the first fault, doubled for each one after
+        int maxBackoffTicks = 400; // cap on the backoff
+        int forgiveTicks = 2400;   // healthy ticks in a row that forgive one fault
+    };
+
+    struct CircuitBreaker {
+        int faults = 0;
+        int backoff = 0;
+        int healthyTicks = 0;
+        std::uint64_t retryAt = 0;
+        bool tripped = false;
+
+        // check if the overlay may run on this tick
+        bool allow(std::uint64_t tick) const { return !tripped && tick >= retryAt; }
+
+        void success(const Settings &settings) {
+            backoff = 0;
+            if (faults > 0 && ++healthyTicks >= settings.forgiveTicks) { faults--; healthyTicks = 0; }
+        }
+
+        // record a fault on this tick. Returns true if it used up the budget and tripped the breaker
+        bool failure(std::uint64_t tick, const Settings &settings) {
+            healthyTicks = 0;
+            backoff = backoff == 0 ? settings.backoffTicks : std::min(backoff * 2, settings.maxBackoffTicks);
+            retryAt = tick + static_cast<std::uint64_t>(backoff);
+            tripped = ++faults >= settings.budget;
+            return tripped;
+        }
+
+        void reset() { *this = CircuitBreaker(); }
+    };
+}
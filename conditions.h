@@ -0,0 +1,114 @@
+/* Conditions that gate overlays on the player's situation (in combat, weapon drawn, sneaking, in a menu).
+ * ----------
+ * The player's situation is kept as a bitmask that game events refresh as it changes, so checking an overlay's
+ * condition each tick is two bit tests and never touches the game. The main thread can also park on the mask
+ * until a flag clears (e.g. while a menu that pauses the game is open).
+ *
+ * usage:
+ * conditions::Condition condition;
+ * conditions::parse("combat,!sneaking", condition);
+ * if (condition.allows(playerState.load())) { ... }
+*/
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace conditions
+{
+    enum Flag : std::uint32_t {
+        InCombat = 1 << 0,
+        WeaponDrawn = 1 << 1,
+        Sneaking = 1 << 2,
+        InMenu = 1 << 3
+    };
+
+    // flags that must all be set, and flags that must all be clear. The default allows everything
+    struct Condition {
+        std::uint32_t require = 0;
+        std::uint32_t forbid = 0;
+
+        bool allows(std::uint32_t state) const { return (state & require) == require && (state & forbid) == 0; }
+        bool always() const { return require == 0 && forbid == 0; }
+    };
+
+    // get a flag from its name (lowercase, spaces removed). Returns 0 if unrecognized
+    inline std::uint32_t getFlagString(std::string_view name) {
+        if (name == "combat" || name == "incombat" || name == "fighting") { return InCombat; }
+        if (name == "weapondrawn" || name == "weaponout" || name == "drawn" || name == "weapon" || name == "armed") { return WeaponDrawn; }
+        if (name == "sneaking" || name == "sneak" || name == "stealth") { return Sneaking; }
+        if (name == "menu" || name == "inmenu" || name == "menuopen") { return InMenu; }
+        return 0;
+    }
+
+    // parse a comma separated list of flag names (lowercase, spaces removed), each optionally negated with '!' or 'not',
+    // e.g. "combat,!sneaking". "always" or an empty list clears the condition. Returns false on an unknown name
+    inline bool parse(std::string_view value, Condition &out) {
+        out = Condition();
+        if (value.empty() || value == "always" || value == "none") { return true; }
+        while (!value.empty()) {
+            auto comma = value.find_first_of(",&+");
+            auto token = value.substr(0, comma);
+            value = comma == std::string_view::npos ? std::string_view() : value.substr(comma + 1);
+            bool negated = false;
+            if (token.starts_with("!")) { token.remove_prefix(1); negated = true; }
+            else if (token.starts_with("not")) { token.remove_prefix(3); negated = true; }
+            auto flag = getFlagString(token);
+            if (!flag) { out = Condition(); return false; }
+            (negated ? out.forbid : out.require) |= flag;
+        }
+        return true;
+    }
+
+    // the condition written back out for the log, e.g. "combat,!sneaking"
+    inline std::string describe(const Condition &condition) {
+        if (condition.always()) { return "always"; }
+        std::string out;
+        for (auto [flag, name]: {std::pair{InCombat, "combat"}, std::pair{WeaponDrawn, "weapondrawn"}, std::pair{Sneaking, "sneaking"}, std::pair{InMenu, "menu"}}) {
+            if (condition.require & flag) { out += out.empty() ? "" : ","; out += name; }
+            if (condition.forbid & flag) { out += out.empty() ? "!" : ",!"; out += name; }
+        }
+        return out;
+    }
+
+    // the player's current flags. Written by event sinks, read by the main thread
+    class PlayerState {
+    public:
+        std::uint32_t load() const { return bits.load(std::memory_order_acquire); }
+
+        void set(Flag flag, bool on) {
+            std::lock_guard guard(lock);
+            auto previous = on ? bits.fetch_or(flag, std::memory_order_acq_rel) : bits.fetch_and(~static_cast<std::uint32_t>(flag), std::memory_order_acq_rel);
+            if (((previous & flag) != 0) != on) { changed.notify_all(); }
+        }
+
+        // block while any of flags is set, as long as keepWaiting() holds (checked again on every wake)
+        template <class Pred>
+        void waitWhile(std::uint32_t flags, Pred keepWaiting) {
+            std::unique_lock guard(lock);
+            changed.wait(guard, [&]() { return (load() & flags) == 0 || !keepWaiting(); });
+        }
+
+        // sleep until deadline, or until woken while keepWaiting() no longer holds
+        template <class Clock, class Duration, class Pred>
+        void sleepUntil(const std::chrono::time_point<Clock, Duration> &deadline, Pred keepWaiting) {
+            std::unique_lock guard(lock);
+            changed.wait_until(guard, deadline, [&]() { return !keepWaiting(); });
+        }
+
+        // wake waiters so they re-check keepWaiting (e.g. after a state change)
+        void wake() {
+            std::lock_guard guard(lock);
+            changed.notify_all();
+        }
+
+    private:
+        std::atomic<std::uint32_t> bits = 0;
+        std::mutex lock;
+        std::condition_variable changed;
+    };
+}
@@ -0,0 +1,10 @@
+/* Logging for the core library's translation units.
+ * ----------
+ * The plugin logs through SKSE::log (logger.h), which the core can't depend on. Core .cpp files log straight to
+ * spdlog's default logger instead: the same logger SetupLog installs in game, and the console anywhere else.
+ * Only include this from core .cpp files, its logger alias would clash with the plugin's.
+*/
+#pragma once
+#include <spdlog/spdlog.h>
+
+namespace logger = spdlog;
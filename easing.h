@@ -5,6 +5,8 @@
  * auto easingFunction = getEasingFunction( easing_functions::{name} );
  * progress = easingFunction( {float linear input between 0 and 1} ); // returns eased float between 0 and 1
 */
+#pragma once
+#include <algorithm>
 #include <cmath>
 #include <map>
 #ifndef PI
@@ -50,94 +52,103 @@ namespace easing
 
     typedef double(*easingFunction)(double);
 
-    easingFunction getEasingFunction( easing_functions function );
+    inline easingFunction getEasingFunction( easing_functions function );
 
-    double easeInSine( double t ) {
+    inline double easeInSine( double t ) {
         return sin( 1.5707963 * t );
     }
 
-    double easeOutSine( double t ) {
+    inline double easeOutSine( double t ) {
         return 1 + sin( 1.5707963 * (--t) );
     }
 
-    double easeInOutSine( double t ) {
+    inline double easeInOutSine( double t ) {
         return 0.5 * (1 + sin( 3.1415926 * (t - 0.5) ) );
     }
 
-    double easeInQuad( double t ) {
+    inline double easeInQuad( double t ) {
         return t * t;
     }
 
-    double easeOutQuad( double t ) {
+    inline double easeOutQuad( double t ) {
         return t * (2 - t);
     }
 
-    double easeInOutQuad( double t ) {
+    inline double easeInOutQuad( double t ) {
         return t < 0.5 ? 2 * t * t : t * (4 - 2 * t) - 1;
     }
 
-    double easeInCubic( double t ) {
+    inline double easeInCubic( double t ) {
         return t * t * t;
     }
 
-    double easeOutCubic( double t ) {
-        return 1 + (--t) * t * t;
+    inline double easeOutCubic( double t ) {
+        --t;
+        return 1 + t * t * t;
     }
 
-    double easeInOutCubic( double t ) {
-        return t < 0.5 ? 4 * t * t * t : 1 + (--t) * (2 * (--t)) * (2 * t);
+    inline double easeInOutCubic( double t ) {
+        if( t < 0.5 ) {
+            return 4 * t * t * t;
+        }
+        --t;
+        return 1 + t * (2 * t) * (2 * t);
     }
 
-    double easeInQuart( double t ) {
+    inline double easeInQuart( double t ) {
         t *= t;
         return t * t;
     }
 
-    double easeOutQuart( double t ) {
-        t = (--t) * t;
+    inline double easeOutQuart( double t ) {
+        --t;
+        t *= t;
         return 1 - t * t;
     }
 
-    double easeInOutQuart( double t ) {
+    inline double easeInOutQuart( double t ) {
         if( t < 0.5 ) {
             t *= t;
             return 8 * t * t;
         } else {
-            t = (--t) * t;
+            --t;
+            t *= t;
             return 1 - 8 * t * t;
         }
     }
 
-    double easeInQuint( double t ) {
+    inline double easeInQuint( double t ) {
         double t2 = t * t;
         return t * t2 * t2;
     }
 
-    double easeOutQuint( double t ) {
-        double t2 = (--t) * t;
+    inline double easeOutQuint( double t ) {
+        --t;
+        double t2 = t * t;
         return 1 + t * t2 * t2;
     }
 
-    double easeInOutQuint( double t ) {
+    inline double easeInOutQuint( double t ) {
         double t2;
         if( t < 0.5 ) {
             t2 = t * t;
             return 16 * t * t2 * t2;
         } else {
-            t2 = (--t) * t;
+            --t;
+            t2 = t * t;
             return 1 + 16 * t * t2 * t2;
         }
     }
 
-    double easeInExpo( double t ) {
+    inline double easeInExpo( double t ) {
         return (pow( 2, 8 * t ) - 1) / 255;
     }
 
-    double easeOutExpo( double t ) {
+    inline double easeOutExpo( double t ) {
         return 1 - pow( 2, -8 * t );
     }
 
-    double easeInOutExpo( double t ) {
+    inline double easeInOutExpo( double t ) {
         if( t < 0.5 ) {
             return (pow( 2, 16 * t ) - 1) / 510;
         } else {
@@ -145,15 +156,15 @@ namespace easing
         }
     }
 
-    double easeInCirc( double t ) {
+    inline double easeInCirc( double t ) {
         return 1 - sqrt( 1 - t );
     }
 
-    double easeOutCirc( double t ) {
+    inline double easeOutCirc( double t ) {
         return sqrt( t );
     }
 
-    double easeInOutCirc( double t ) {
+    inline double easeInOutCirc( double t ) {
         if( t < 0.5 ) {
             return (1 - sqrt( 1 - 2 * t )) * 0.5;
         } else {
@@ -161,33 +172,35 @@ namespace easing
         }
     }
 
-    double easeInBack( double t ) {
+    inline double easeInBack( double t ) {
         return t * t * (2.70158 * t - 1.70158);
     }
 
-    double easeOutBack( double t ) {
-        return 1 + (--t) * t * (2.70158 * t + 1.70158);
+    inline double easeOutBack( double t ) {
+        --t;
+        return 1 + t * t * (2.70158 * t + 1.70158);
     }
 
-    double easeInOutBack( double t ) {
+    inline double easeInOutBack( double t ) {
         if( t < 0.5 ) {
             return t * t * (7 * t - 2.5) * 2;
         } else {
-            return 1 + (--t) * t * 2 * (7 * t + 2.5);
+            --t;
+            return 1 + t * t * 2 * (7 * t + 2.5);
         }
     }
 
-    double easeInElastic( double t ) {
+    inline double easeInElastic( double t ) {
         double t2 = t * t;
         return t2 * t2 * sin( t * PI * 4.5 );
     }
 
-    double easeOutElastic( double t ) {
+    inline double easeOutElastic( double t ) {
         double t2 = (t - 1) * (t - 1);
         return 1 - t2 * t2 * cos( t * PI * 4.5 );
     }
 
-    double easeInOutElastic( double t ) {
+    inline double easeInOutElastic( double t ) {
         double t2;
         if( t < 0.45 ) {
             t2 = t * t;
@@ -200,28 +213,28 @@ namespace easing
         }
     }
 
-    double easeInBounce( double t ) {
-        return pow( 2, 6 * (t - 1) ) * abs( sin( t * PI * 3.5 ) );
+    inline double easeInBounce( double t ) {
+        return pow( 2, 6 * (t - 1) ) * std::abs( sin( t * PI * 3.5 ) );
     }
 
-    double easeOutBounce( double t ) {
-        return 1 - pow( 2, -6 * t ) * abs( cos( t * PI * 3.5 ) );
+    inline double easeOutBounce( double t ) {
+        return 1 - pow( 2, -6 * t ) * std::abs( cos( t * PI * 3.5 ) );
     }
 
-    double easeInOutBounce( double t ) {
+    inline double easeInOutBounce( double t ) {
         if( t < 0.5 ) {
-            return 8 * pow( 2, 8 * (t - 1) ) * abs( sin( t * PI * 7 ) );
+            return 8 * pow( 2, 8 * (t - 1) ) * std::abs( sin( t * PI * 7 ) );
         } else {
-            return 1 - 8 * pow( 2, -8 * t ) * abs( sin( t * PI * 7 ) );
+            return 1 - 8 * pow( 2, -8 * t ) * std::abs( sin( t * PI * 7 ) );
         }
     }
 
-    double linear( double t ) {
+    inline double linear( double t ) {
         return t;
     }
 
     // get easing function from string name. See https://easings.net/ for valid names (case insensitive). Returns linear if unrecognized
-    easingFunction getEasingFunctionString( std::string name ) {
+    inline easingFunction getEasingFunctionString( std::string name ) {
         std::map< std::string, easing_functions > easingStrToFunc = {
             {"easeinsine", EaseInSine}, {"sine", EaseInSine}, {"sin(x)", EaseInSine}, {"1", EaseInSine},
             {"easeoutsine", EaseOutSine},
@@ -260,7 +273,7 @@ namespace easing
         return getEasingFunction( easingStrToFunc.at(name) );
     }
 
-    const char* getStringEasingFunction( easingFunction function ) {
+    inline const char* getStringEasingFunction( easingFunction function ) {
         // return string name of passed function
         if (function == easeInSine) { return "easeInSine"; }
         else if (function == easeOutSine) { return "easeOutSine"; }
@@ -296,7 +309,7 @@ namespace easing
 
     }
 
-    easingFunction getEasingFunction( easing_functions function )
+    inline easingFunction getEasingFunction( easing_functions function )
     {
         static std::map< easing_functions, easingFunction > easingFunctions;
         if( easingFunctions.empty() )
@@ -0,0 +1,180 @@
+/* Float32 approximations of the transcendental easing curves (the Sine, Expo, Elastic and Bounce families).
+ * ----------
+ * Same shapes as the double precision curves in easing.h, which stay the reference. Everything is evaluated in
+ * float, with near-minimax polynomials (Chebyshev fits) in place of the libm calls:
+ *   sin: reduced by multiples of pi to [-pi/2, pi/2], then an odd degree 9 polynomial (cos(x) = sin(x + pi/2))
+ *   exp2: 2^n built straight into the exponent bits, times a degree 5 polynomial for 2^f on [0, 1)
+ * The largest absolute difference of each curve from its reference over t in [0, 1] is listed in curves below
+ * (the easing tests hold each curve to it, and StatFXEasingBench times both versions). Elastic and Bounce are mostly limited by float
+ * rounding of their large sin arguments, not by the polynomials.
+ *
+ * Build with STATFX_EASING_APPROX to use them for every overlay by default, or set EasingApprox per overlay.
+ *
+ * usage:
+ * auto easeF = easingf::approximate( easing::easeOutBounce ); // easingf::easeOutBounce, same signature
+*/
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include "easing.h"
+
+namespace easingf
+{
+#ifdef STATFX_EASING_APPROX
+    constexpr bool byDefault = true;
+#else
+    constexpr bool byDefault = false;
+#endif
+
+    namespace detail
+    {
+        constexpr float pi = 3.14159265f;
+        constexpr float halfPi = 1.57079633f;
+        constexpr float invPi = 0.318309886f;
+        // pi split into parts with few mantissa bits, so k * part is exact during range reduction (Cody-Waite)
+        constexpr float piA = 3.140625f, piB = 9.67502593994140625e-4f, piC = 1.509957990978376432e-7f;
+
+        inline float sin(float x) {
+            float k = std::nearbyint(x * invPi);
+            float r = ((x - k * piA) - k * piB) - k * piC;
+            float u = r * r;
+            float s = r * (9.999999957e-01f + u * (-1.666665797e-01f + u * (8.333050617e-03f + u * (-1.980904636e-04f + u * 2.605166276e-06f))));
+            return (static_cast<int>(k) & 1) ? -s : s;
+        }
+
+        inline float cos(float x) { return sin(x + halfPi); }
+
+        inline float exp2(float x) {
+            x = std::clamp(x, -126.0f, 127.0f);
+            float n = std::floor(x);
+            float f = x - n;
+            float p = 9.999998958e-01f + f * (6.931546200e-01f + f * (2.401407701e-01f + f * (5.586328266e-02f + f * (8.946214666e-03f + f * 1.895107291e-03f))));
+            return p * std::bit_cast<float>(static_cast<std::uint32_t>(static_cast<int>(n) + 127) << 23);
+        }
+    }
+
+    inline double easeInSine( double td ) {
+        float t = static_cast<float>(td);
+        return detail::sin( detail::halfPi * t );
+    }
+
+    inline double easeOutSine( double td ) {
+        float t = static_cast<float>(td);
+        return 1.0f + detail::sin( detail::halfPi * (t - 1.0f) );
+    }
+
+    inline double easeInOutSine( double td ) {
+        float t = static_cast<float>(td);
+        return 0.5f * (1.0f + detail::sin( detail::pi * (t - 0.5f) ));
+    }
+
+    inline double easeInExpo( double td ) {
+        float t = static_cast<float>(td);
+        return (detail::exp2( 8.0f * t ) - 1.0f) / 255.0f;
+    }
+
+    inline double easeOutExpo( double td ) {
+        float t = static_cast<float>(td);
+        return 1.0f - detail::exp2( -8.0f * t );
+    }
+
+    inline double easeInOutExpo( double td ) {
+        float t = static_cast<float>(td);
+        if( t < 0.5f ) {
+            return (detail::exp2( 16.0f * t ) - 1.0f) / 510.0f;
+        } else {
+            return 1.0f - 0.5f * detail::exp2( -16.0f * (t - 0.5f) );
+        }
+    }
+
+    inline double easeInElastic( double td ) {
+        float t = static_cast<float>(td);
+        float t2 = t * t;
+        return t2 * t2 * detail::sin( t * detail::pi * 4.5f );
+    }
+
+    inline double easeOutElastic( double td ) {
+        float t = static_cast<float>(td);
+        float t2 = (t - 1.0f) * (t - 1.0f);
+        return 1.0f - t2 * t2 * detail::cos( t * detail::pi * 4.5f );
+    }
+
+    inline double easeInOutElastic( double td ) {
+        float t = static_cast<float>(td);
+        float t2;
+        if( t < 0.45f ) {
+            t2 = t * t;
+            return 8.0f * t2 * t2 * detail::sin( t * detail::pi * 9.0f );
+        } else if( t < 0.55f ) {
+            return 0.5f + 0.75f * detail::sin( t * detail::pi * 4.0f );
+        } else {
+            t2 = (t - 1.0f) * (t - 1.0f);
+            return 1.0f - 8.0f * t2 * t2 * detail::sin( t * detail::pi * 9.0f );
+        }
+    }
+
+    inline double easeInBounce( double td ) {
+        float t = static_cast<float>(td);
+        return detail::exp2( 6.0f * (t - 1.0f) ) * std::abs( detail::sin( t * detail::pi * 3.5f ) );
+    }
+
+    inline double easeOutBounce( double td ) {
+        float t = static_cast<float>(td);
+        return 1.0f - detail::exp2( -6.0f * t ) * std::abs( detail::cos( t * detail::pi * 3.5f ) );
+    }
+
+    inline double easeInOutBounce( double td ) {
+        float t = static_cast<float>(td);
+        if( t < 0.5f ) {
+            return 8.0f * detail::exp2( 8.0f * (t - 1.0f) ) * std::abs( detail::sin( t * detail::pi * 7.0f ) );
+        } else {
+            return 1.0f - 8.0f * detail::exp2( -8.0f * t ) * std::abs( detail::sin( t * detail::pi * 7.0f ) );
+        }
+    }
+
+    // each approximated curve, its reference, and the stated max absolute error against it over [0, 1]
+    struct Curve {
+        easing::easingFunction reference;
+        easing::easingFunction approx;
+        float maxError;
+    };
+
+    inline const std::array<Curve, 12> curves = {{
+        {easing::easeInSine, easeInSine, 2e-7f},
+        {easing::easeOutSine, easeOutSine, 2e-7f},
+        {easing::easeInOutSine, easeInOutSine, 2e-7f},
+        {easing::easeInExpo, easeInExpo, 5e-7f},
+        {easing::easeOutExpo, easeOutExpo, 5e-7f},
+        {easing::easeInOutExpo, easeInOutExpo, 5e-7f},
+        {easing::easeInElastic, easeInElastic, 2e-6f},
+        {easing::easeOutElastic, easeOutElastic, 2e-6f},
+        {easing::easeInOutElastic, easeInOutElastic, 2e-6f},
+        {easing::easeInBounce, easeInBounce, 1e-6f},
+        {easing::easeOutBounce, easeOutBounce, 1e-6f},
+        {easing::easeInOutBounce, easeInOutBounce, 1e-6f}
+    }};
+
+    // float32 version of a curve. Curves without one (the polynomial families, already cheap) are returned as they are
+    inline easing::easingFunction approximate(easing::easingFunction function) {
+        for (auto &curve: curves) { if (curve.reference == function) { return curve.approx; } }
+        return function;
+    }
+
+    // double precision reference of a curve (itself if it is not an approximation)
+    inline easing::easingFunction reference(easing::easingFunction function) {
+        for (auto &curve: curves) { if (curve.approx == function) { return curve.reference; } }
+        return function;
+    }
+
+    inline bool isApprox(easing::easingFunction function) { return reference(function) != function; }
+
+    // name of a curve for the log, e.g. "easeOutBounce (f32)"
+    inline std::string describe(easing::easingFunction function) {
+        std::string name = easing::getStringEasingFunction(reference(function));
+        return isApprox(function) ? name + " (f32)" : name;
+    }
+}
@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <string>
+#include <utility>
+#include "expr.h"
+#include "conditions.h"
+
+namespace expr
+{
+    namespace
+    {
+        // recursive descent over the expression, emitting ops as it goes and folding constant parts right away
+        class Compiler {
+        public:
+            Compiler(std::string_view source, const Context &context) : source(source), context(context) {}
+
+            std::expected<Program, Error> run() {
+                skipSpace();
+                if (at >= source.size()) { return std::unexpected(Error{Errc::Empty, 0}); }
+                if (!expression()) { return std::unexpected(error); }
+                skipSpace();
+                if (at < source.size()) { return std::unexpected(Error{Errc::TrailingCharacters, at}); }
+                program.source = std::string(source);
+                program.dynamic = std::any_of(program.ops.begin(), program.ops.end(), [](const Op &op) { return op.code == Code::Load && op.slot != Stat; });
+                return std::move(program);
+            }
+
+        private:
+            std::string_view source;
+            const Context &context;
+            std::size_t at = 0;
+            int depth = 0;
+            Program program;
+            Error error{Errc::Syntax, 0};
+
+            bool fail(Errc code, std::size_t position) { error = Error{code, position}; return false; }
+
+            void skipSpace() { while (at < source.size() && std::isspace(static_cast<unsigned char>(source[at]))) { at++; } }
+
+            bool accept(char c) {
+                skipSpace();
+                if (at < source.size() && source[at] == c) { at++; return true; }
+                return false;
+            }
+
+            bool expect(char c) { return accept(c) || fail(Errc::Syntax, at); }
+
+            std::string_view name() {
+                skipSpace();
+                auto start = at;
+                while (at < source.size() && (std::isalnum(static_cast<unsigned char>(source[at])) || source[at] == '_')) { at++; }
+                return source.substr(start, at - start);
+            }
+
+            // emit an op taking inputs values off the stack and leaving one, folding it if all of its inputs are constants
+            bool emit(Op op, int inputs) {
+                depth += 1 - inputs;
+                if (depth > maxDepth) { return fail(Errc::TooDeep, at); }
+                auto &ops = program.ops;
+                bool constant = op.code != Code::Load && static_cast<int>(ops.size()) >= inputs &&
+                    std::all_of(ops.end() - inputs, ops.end(), [](const Op &input) { return input.code == Code::Const; });
+                if (!constant || op.code == Code::Const) {
+                    ops.push_back(op);
+                    return true;
+                }
+                Program folded;
+                folded.ops.assign(ops.end() - inputs, ops.end());
+                folded.ops.push_back(op);
+                ops.resize(ops.size() - inputs);
+                ops.push_back(Op{Code::Const, 0, folded.run(Vars{})});
+                return true;
+            }
+
+            bool expression() {
+                if (!additive()) { return false; }
+                while (true) {
+                    skipSpace();
+                    Code code;
+                    if (source.substr(at, 2) == "<=") { code = Code::LessEqual; at += 2; }
+                    else if (source.substr(at, 2) == ">=") { code = Code::GreaterEqual; at += 2; }
+                    else if (accept('<')) { code = Code::Less; }
+                    else if (accept('>')) { code = Code::Greater; }
+                    else { return true; }
+                    if (!additive() || !emit(Op{code}, 2)) { return false; }
+                }
+            }
+
+            bool additive() {
+                if (!term()) { return false; }
+                while (true) {
+                    Code code;
+                    if (accept('+')) { code = Code::Add; }
+                    else if (accept('-')) { code = Code::Sub; }
+                    else { return true; }
+                    if (!term() || !emit(Op{code}, 2)) { return false; }
+                }
+            }
+
+            bool term() {
+                if (!unary()) { return false; }
+                while (true) {
+                    Code code;
+                    if (accept('*')) { code = Code::Mul; }
+                    else if (accept('/')) { code = Code::Div; }
+                    else { return true; }
+                    if (!unary() || !emit(Op{code}, 2)) { return false; }
+                }
+            }
+
+            bool unary() {
+                if (accept('-')) { return unary() && emit(Op{Code::Neg}, 1); }
+                if (accept('+')) { return unary(); }
+                return primary();
+            }
+
+            bool primary() {
+                skipSpace();
+                if (at >= source.size()) { return fail(Errc::Syntax, at); }
+                if (accept('(')) { return expression() && expect(')'); }
+                char c = source[at];
+                if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+                    float value = 0.0f;
+                    auto [end, ec] = std::from_chars(source.data() + at, source.data() + source.size(), value);
+                    if (ec != std::errc()) { return fail(Errc::Syntax, at); }
+                    at = static_cast<std::size_t>(end - source.data());
+                    return emit(Op{Code::Const, 0, value}, 0);
+                }
+                auto position = at;
+                auto word = lower(name());
+                if (word.empty()) { return fail(Errc::Syntax, position); }
+                skipSpace();
+                if (at < source.size() && source[at] == '(') {
+                    at++;
+                    return call(word, position);
+                }
+                const std::pair<const char*, Slot> names[] = {
+                    {"stat", Stat}, {"actual", Actual}, {"health", Health}, {"stamina", Stamina}, {"magicka", Magicka},
+                    {"combat", Combat}, {"weapondrawn", WeaponDrawn}, {"sneaking", Sneaking}
+                };
+                for (auto [known, slot]: names) {
+                    if (word == known) { return emit(Op{Code::Load, slot}, 0); }
+                }
+                return fail(Errc::UnknownName, position);
+            }
+
+            // arguments up to the closing parenthesis. Returns how many, or -1 on an error
+            int arguments() {
+                if (accept(')')) { return 0; }
+                int count = 0;
+                do {
+                    if (!expression()) { return -1; }
+                    count++;
+                } while (accept(','));
+                return expect(')') ? count : -1;
+            }
+
+            // the constant the last op leaves, taken back off the stack
+            bool takeConstant(float &value, std::size_t position) {
+                if (program.ops.empty() || program.ops.back().code != Code::Const) { return fail(Errc::NotConstant, position); }
+                value = program.ops.back().a;
+                program.ops.pop_back();
+                depth--;
+                return true;
+            }
+
+            bool call(const std::string &function, std::size_t position) {
+                // ease(curve, x) starts with a curve name, ease(x) uses the section's curve
+                auto curve = context.curve;
+                if (function == "ease") {
+                    auto save = at;
+                    auto word = lower(name());
+                    if (!word.empty() && accept(',')) {
+                        curve = easing::getEasingFunctionString(word);
+                        if (curve == easing::linear && word != "linear") { return fail(Errc::UnknownCurve, save); }
+                    } else {
+                        at = save;
+                    }
+                }
+                auto count = arguments();
+                if (count < 0) { return false; }
+                auto need = [&](int wanted) { return count == wanted || fail(Errc::ArgumentCount, position); };
+                if (function == "ease") {
+                    Op op{Code::Ease};
+                    op.curve = curve;
+                    return need(1) && emit(op, 1);
+                }
+                if (function == "range") {
+                    // range(x, end, start) with number bounds, or range(x) with the section's Range
+                    Op op{Code::Range, 0, context.start, context.end};
+                    if (count == 3) {
+                        if (!takeConstant(op.a, position) || !takeConstant(op.b, position)) { return false; }
+                        if (op.a < op.b) { std::swap(op.a, op.b); }
+                    } else if (!need(1)) {
+                        return false;
+                    }
+                    return emit(op, 1);
+                }
+                if (function == "min") { return need(2) && emit(Op{Code::Min}, 2); }
+                if (function == "max") { return need(2) && emit(Op{Code::Max}, 2); }
+                if (function == "clamp") { return need(3) && emit(Op{Code::Clamp}, 3); }
+                if (function == "abs") { return need(1) && emit(Op{Code::Abs}, 1); }
+                return fail(Errc::UnknownName, position);
+            }
+
+            static std::string lower(std::string_view text) {
+                std::string out(text);
+                std::transform(out.begin(), out.end(), out.begin(), ::tolower);
+                return out;
+            }
+        };
+    }
+
+    std::expected<Program, Error> compile(std::string_view source, const Context &context) {
+        return Compiler(source, context).run();
+    }
+
+    Program defaultProgram(const Context &context) {
+        Program program;
+        program.ops.push_back(Op{Code::Load, Stat});
+        program.ops.push_back(Op{Code::Range, 0, context.start, context.end});
+        Op ease{Code::Ease};
+        ease.curve = context.curve;
+        program.ops.push_back(ease);
+        program.source = "ease(range(stat))";
+        program.native = true;
+        return program;
+    }
+
+    void setShared(Vars &vars, float health, float stamina, float magicka, std::uint32_t situation) {
+        vars[Health] = health;
+        vars[Stamina] = stamina;
+        vars[Magicka] = magicka;
+        vars[Combat] = situation & conditions::InCombat ? 1.0f : 0.0f;
+        vars[WeaponDrawn] = situation & conditions::WeaponDrawn ? 1.0f : 0.0f;
+        vars[Sneaking] = situation & conditions::Sneaking ? 1.0f : 0.0f;
+    }
+}
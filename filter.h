@@ -0,0 +1,92 @@
+/* Noise filter on an overlay's sampled stat, between sampling and the delta smoothing.
+ * ----------
+ * Regeneration, and mods that nudge actor values every frame, make the sampled stat creep and jitter in tiny steps
+ * that keep crossing MinDelta and re-trigger the imod. A filter takes the jitter out of what the effect follows:
+ *   ema: exponential moving average with a time constant (FilterTime seconds)
+ *   oneeuro: One-Euro filter, an EMA whose cutoff rises with the stat's speed (FilterCutoff Hz, FilterBeta), so slow
+ *            drift is smoothed hard and fast movement barely lags
+ *   hysteresis: holds the value until the stat has moved a whole band (FilterBand) away, then jumps to it
+ * Whatever the filter, a change of at least FilterSpike in one sample (a big hit, a potion) passes straight through.
+ * Only hysteresis makes fewer imod updates. The creep itself still crosses MinDelta as often, so ema and oneeuro at
+ * their defaults update about as often as no filter (StatFXFilterReplay's regen trace: ema 102%, oneeuro 103%,
+ * hysteresis 64% of the unfiltered updates). Slowed down far enough to update less (ema 4 s: 73%), they visibly lag regen.
+ *
+ * usage:
+ * filter::Filter health;
+ * float filtered = health.step(settings.health.filter, sampled, 0.025f);
+*/
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace filter
+{
+    enum class Kind { None, Ema, OneEuro, Hysteresis };
+
+    struct Settings {
+        Kind kind = Kind::None;
+        float time = 0.5f;    // ema time constant, seconds
+        float cutoff = 0.5f;  // oneeuro cutoff at rest, Hz
+        float beta = 4.0f;    // oneeuro cutoff added per unit of stat change per second
+        float band = 0.03f;   // hysteresis band, fraction of the stat
+        float spike = 0.1f;   // a change this big in one sample skips the filter (0 = never)
+    };
+
+    // get filter kind from its name (case insensitive). Returns None if unrecognized
+    inline Kind getKindString(std::string name) {
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        if (name == "ema" || name == "average" || name == "smooth") { return Kind::Ema; }
+        if (name == "oneeuro" || name == "1euro" || name == "euro" || name == "adaptive") { return Kind::OneEuro; }
+        if (name == "hysteresis" || name == "band" || name == "deadband" || name == "steps") { return Kind::Hysteresis; }
+        return Kind::None;
+    }
+
+    inline const char* getStringKind(Kind kind) {
+        switch (kind) {
+            case Kind::Ema: return "ema";
+            case Kind::OneEuro: return "oneeuro";
+            case Kind::Hysteresis: return "hysteresis";
+            default: return "none";
+        }
+    }
+
+    struct Filter {
+        bool primed = false; // false until the first sample, which is taken as it is
+        float value = 0.0f;
+        float raw = 0.0f;    // previous sample, unfiltered (oneeuro)
+        float speed = 0.0f;  // smoothed rate of change per second of the raw samples (oneeuro)
+
+        // filter one sample taken dt seconds after the previous one
+        float step(const Settings &settings, float sample, float dt) {
+            if (settings.kind == Kind::None || !primed || dt <= 0.0f || (settings.spike > 0.0f && std::abs(sample - value) >= settings.spike)) {
+                primed = true;
+                value = raw = sample;
+                speed = 0.0f;
+                return value;
+            }
+            // smoothing factor of a first order low pass at a cutoff frequency
+            auto alpha = [dt](float cutoff) { float tau = 1.0f / (6.2831853f * cutoff); return 1.0f / (1.0f + tau / dt); };
+            switch (settings.kind) {
+                case Kind::Ema:
+                    value += (sample - value) * (1.0f - std::exp(-dt / std::max(settings.time, 1e-3f)));
+                    break;
+                case Kind::OneEuro: {
+                    // speed from successive samples: the distance to the filtered value would count the filter's own lag as speed
+                    speed += ((sample - raw) / dt - speed) * alpha(1.0f);
+                    raw = sample;
+                    value += (sample - value) * alpha(std::max(settings.cutoff, 1e-3f) + settings.beta * std::abs(speed));
+                    break;
+                }
+                case Kind::Hysteresis:
+                    // the ends always come through, so a full stat never sits a band short of full
+                    if (std::abs(sample - value) >= settings.band || sample >= 1.0f || sample <= 0.0f) { value = sample; }
+                    break;
+                default: break;
+            }
+            return value;
+        }
+
+        void reset() { *this = Filter(); }
+    };
+}
@@ -0,0 +1,64 @@
+/* Cache of resolved forms, keyed by the reference the ini names them with.
+ * ----------
+ * A reference is either an editor ID or a plugin-qualified FormID ("StatFX.esp|0x801", see parse::formRef). Forms
+ * live as long as the game's data, so once a reference has resolved it is never looked up again: a reload with the
+ * same references costs one hash lookup per form. Equivalent spellings of a reference (case, 0x prefix, load order
+ * byte, either separator order) share one entry. Lookups that find nothing aren't cached, so they are retried.
+ *
+ * Single threaded: the plugin resolves forms on the game's main thread only.
+ *
+ * usage:
+ * static forms::Cache<RE::TESImageSpaceModifier> cache;
+ * auto imod = cache.resolve(settings.health.editorID, LookupImod);
+*/
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "parse.h"
+
+namespace forms
+{
+    // canonical cache key of a reference: "statfx.esp|000801" for a FormID, the lowercased editor ID otherwise
+    inline std::string key(std::string_view reference) {
+        auto lower = [](std::string_view text) {
+            std::string out(text);
+            for (auto &c: out) { if (c >= 'A' && c <= 'Z') { c = static_cast<char>(c - 'A' + 'a'); } }
+            return out;
+        };
+        if (auto ref = parse::formRef(reference)) {
+            auto out = lower(ref->plugin) + "|000000";
+            for (std::size_t i = 0; i < 6; i++) { out[out.size() - 1 - i] = "0123456789abcdef"[(ref->localID >> (4 * i)) & 0xF]; }
+            return out;
+        }
+        return lower(reference);
+    }
+
+    template <class Form>
+    class Cache {
+    public:
+        // form for reference, calling lookup(reference) only if it hasn't resolved before. Null if it can't be found
+        template <class Lookup>
+        Form* resolve(std::string_view reference, Lookup &&lookup) {
+            auto entry = key(reference);
+            if (auto found = resolved.find(entry); found != resolved.end()) {
+                hits++;
+                return found->second;
+            }
+            lookups++;
+            Form *form = lookup(reference);
+            if (form) { resolved.emplace(std::move(entry), form); }
+            return form;
+        }
+
+        std::size_t size() const { return resolved.size(); }
+        void clear() { resolved.clear(); }
+
+        std::uint64_t hits = 0;    // references answered from the cache
+        std::uint64_t lookups = 0; // references that had to be looked up in the game's data
+
+    private:
+        std::unordered_map<std::string, Form*> resolved;
+    };
+}
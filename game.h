@@ -0,0 +1,41 @@
+/* The core's only view of the game: the imod an overlay drives, and the actor values it samples.
+ * ----------
+ * The plugin implements these on top of CommonLibSSE (imod forms and instances, actor value owners). Anything
+ * else can implement them too, so the settings, smoothing and imod parameters run and can be profiled natively.
+*/
+#pragma once
+#include "actors.h"
+
+namespace overlay { struct ImodParams; }
+
+namespace game
+{
+    // an overlay's imagespace modifier form and the instance of it currently on screen (if any)
+    class Imod {
+    public:
+        virtual ~Imod() = default;
+        // the form was found
+        virtual bool loaded() const = 0;
+        // an instance is on screen
+        virtual bool live() const = 0;
+        // (re)start the instance at a strength
+        virtual void trigger(float strength) = 0;
+        // move the live instance along its baked timeline, starting one at full strength if there is none
+        virtual void drive(float age, float strength) = 0;
+        // put the driven instance back at the age it was last driven to: the engine advances an instance's age every
+        // frame, and a baked timeline must only move when the stat does
+        virtual void hold() = 0;
+        // take the instance off screen
+        virtual void stop() = 0;
+        // write keys into the form
+        virtual void apply(const overlay::ImodParams &params) = 0;
+    };
+
+    // stat percentages of the actors an overlay can be bound to
+    class ActorValues {
+    public:
+        virtual ~ActorValues() = default;
+        // push the health, stamina and magicka percentage (0 to 1) of every actor in the set onto batch
+        virtual void sample(actors::Target target, actors::SampleBatch &batch) = 0;
+    };
+}
@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <exception>
+#include <system_error>
+#include <thread>
+#include "layers.h"
+#include "corelog.h"
+
+namespace layers
+{
+    namespace
+    {
+        std::string lower(std::string text) {
+            std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            return text;
+        }
+    }
+
+    std::vector<std::filesystem::path> Discover(const std::filesystem::path &base) {
+        std::vector<std::filesystem::path> files;
+        std::error_code error;
+        if (std::filesystem::is_regular_file(base, error)) { files.push_back(base); }
+        auto folder = base.has_parent_path() ? base.parent_path() : std::filesystem::path(".");
+        auto prefix = lower(base.stem().string()) + "_";
+        std::vector<std::pair<std::string, std::filesystem::path>> overrides;
+        for (auto it = std::filesystem::directory_iterator(folder, error); !error && it != std::filesystem::directory_iterator(); it.increment(error)) {
+            auto name = lower(it->path().filename().string());
+            if (!name.starts_with(prefix) || !name.ends_with(".ini") || !it->is_regular_file(error)) continue;
+            overrides.emplace_back(name, it->path());
+        }
+        // by lowercase name, then by the name as written, so two files differing only in case still sort the same way
+        std::sort(overrides.begin(), overrides.end(), [](const auto &a, const auto &b) {
+            return a.first != b.first ? a.first < b.first : a.second.filename().string() < b.second.filename().string();
+        });
+        for (auto &[name, path]: overrides) { files.push_back(path); }
+        return files;
+    }
+
+    std::vector<Layer> Read(const std::vector<std::filesystem::path> &files, int threads) {
+        std::vector<Layer> layers(files.size());
+        if (threads <= 0) { threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency())); }
+        threads = std::max(1, std::min(threads, static_cast<int>(files.size())));
+        // each job takes the next file off a shared counter and parses it into its own layer, so no two touch the same data
+        std::atomic<std::size_t> next = 0;
+        auto work = [&]() {
+            for (auto i = next++; i < files.size(); i = next++) {
+                layers[i].path = files[i];
+                // nothing may escape a worker thread: a file that fails to parse is left unread, and Merge warns about it
+                try {
+                    layers[i].read = mINI::INIFile(files[i].string()).read(layers[i].ini);
+                } catch (const std::exception&) {
+                    layers[i].read = false;
+                }
+            }
+        };
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for (int t = 1; t < threads; t++) { workers.emplace_back(work); }
+        work();
+        for (auto &worker: workers) { worker.join(); }
+        return layers;
+    }
+
+    Merged Merge(const std::vector<Layer> &layers) {
+        Merged merged;
+        for (auto &layer: layers) {
+            if (!layer.read) {
+                logger::warn("INI Config: Could not read '{}': Skipping it", layer.path.filename().string());
+                continue;
+            }
+            auto index = merged.files.size();
+            merged.files.push_back(layer.path.filename().string());
+            for (auto const& [section, keys]: layer.ini) {
+                auto &into = merged.ini[section];
+                for (auto const& [key, value]: keys) {
+                    into[key] = value;
+                    merged.source[section + "." + key] = index;
+                }
+            }
+        }
+        // the effective value of every key a preset set, once, whichever layers it passed through on the way
+        if (merged.files.size() > 1) {
+            for (auto const& [section, keys]: merged.ini) {
+                for (auto const& [key, value]: keys) {
+                    auto index = merged.source[section + "." + key];
+                    if (index > 0) { logger::info("INI Config: [{}] {} = {} (from '{}')", section, key, value, merged.files[index]); }
+                }
+            }
+        }
+        return merged;
+    }
+}
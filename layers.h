@@ -0,0 +1,45 @@
+/* Layered configuration: StatFx.ini plus StatFx_*.ini preset files, merged key by key.
+ * ----------
+ * Preset mods ship a StatFx_Name.ini next to StatFx.ini with only the keys they change, instead of overwriting the
+ * whole file. Discover finds the layers: the base file first, then every override in order of file name (case
+ * insensitive, so the order is the same on every machine). Read parses them in parallel, one file per job on a small
+ * pool of threads, each into its own structure. Merge then applies them in layer order: a later layer's key replaces
+ * an earlier one's, new sections are added after the existing ones, and nothing else moves. The order parsing finished
+ * in never matters. The merge logs each key a preset sets, with its effective value and the file it came from, once.
+ *
+ * usage:
+ * auto layers = layers::Read(layers::Discover(pluginsFolder / "StatFx.ini"));
+ * auto merged = layers::Merge(layers);
+ * ReadSettings(merged.ini, settings, profiles);
+*/
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ini.h"
+
+namespace layers
+{
+    struct Layer {
+        std::filesystem::path path;
+        bool read = false; // false if the file couldn't be opened, the layer is then left out of the merge
+        mINI::INIStructure ini;
+    };
+
+    struct Merged {
+        mINI::INIStructure ini;
+        std::vector<std::string> files;                      // file name of each layer that was read, in merge order
+        std::unordered_map<std::string, std::size_t> source; // "section.key" to the index in files of the layer that set it
+    };
+
+    // the base file, if it exists, and the <stem>_*.ini files next to it, ordered by lowercase file name
+    std::vector<std::filesystem::path> Discover(const std::filesystem::path &base);
+
+    // parse every file, in parallel over up to threads threads (0 = one per core). Layers come back in the order given
+    std::vector<Layer> Read(const std::vector<std::filesystem::path> &files, int threads = 0);
+
+    // apply the layers in order, later keys over earlier ones. Logs each key set by a layer after the first
+    Merged Merge(const std::vector<Layer> &layers);
+}
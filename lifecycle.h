@@ -0,0 +1,27 @@
+/* Overlay lifecycle: when an overlay holds an imod instance.
+ * ----------
+ * Inactive: intensity is zero (the stat is above its Range), and no instance exists at all.
+ * Fading: intensity is above zero and the smoothed value is still moving toward the actual stat.
+ * Active: intensity is above zero and the smoothed value has settled, so nothing changes until the stat moves.
+ * An instance is created when intensity first rises above zero, and released as soon as it drops back to zero.
+*/
+#pragma once
+
+namespace lifecycle
+{
+    enum class Phase { Inactive, Fading, Active };
+
+    // phase for this tick's intensity, and whether the smoothed value has settled on the actual stat
+    inline Phase next(float intensity, bool settled) {
+        if (!(intensity > 0.0f)) { return Phase::Inactive; }
+        return settled ? Phase::Active : Phase::Fading;
+    }
+
+    inline const char* getStringPhase(Phase phase) {
+        switch (phase) {
+            case Phase::Fading: return "fading";
+            case Phase::Active: return "active";
+            default: return "inactive";
+        }
+    }
+}
@@ -2,20 +2,37 @@
 
 // This is a snippet you can put at the top of all of your SKSE plugins!
 
+#include <spdlog/async.h>
 #include <spdlog/sinks/basic_file_sink.h>
+#include "ratelimit.h"
 
 namespace logger = SKSE::log;
 
+// Logging is asynchronous: lines go into a bounded queue and a background thread writes them. When the queue is full
+// the oldest lines are dropped instead of blocking, so logging never stalls the main thread or the load path.
 void SetupLog() {
     auto logsFolder = SKSE::log::log_directory();
     if (!logsFolder) SKSE::stl::report_and_fail("SKSE log_directory not provided, logs disabled.");
     auto pluginName = SKSE::PluginDeclaration::GetSingleton()->GetName();
     auto logFilePath = *logsFolder / std::format("{}.log", pluginName);
+    spdlog::init_thread_pool(8192, 1);
     auto fileLoggerPtr = std::make_shared<spdlog::sinks::basic_file_sink_mt>(logFilePath.string(), true);
-    auto loggerPtr = std::make_shared<spdlog::logger>("log", std::move(fileLoggerPtr));
+    auto loggerPtr = std::make_shared<spdlog::async_logger>("log", std::move(fileLoggerPtr), spdlog::thread_pool(), spdlog::async_overflow_policy::overrun_oldest);
     spdlog::set_default_logger(std::move(loggerPtr));
     spdlog::set_level(spdlog::level::trace);
-    spdlog::flush_on(spdlog::level::trace);
+    // flushes happen on the background thread: right away for errors, otherwise once a second
+    spdlog::flush_on(spdlog::level::err);
+    spdlog::flush_every(std::chrono::seconds(1));
+}
+
+// Set the log level from its name (trace, debug, info, warn, error, critical, off). Returns false if unrecognized
+bool SetLogLevel(std::string name) {
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+    if (name == "warning") name = "warn";
+    auto level = spdlog::level::from_str(name);
+    if (level == spdlog::level::off && name != "off") return false;
+    spdlog::set_level(level);
+    return true;
 }
 
 // Then just call SetupLog() in your SKSE plugin initialization
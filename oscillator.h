@@ -0,0 +1,70 @@
+/* Native pulse oscillator for overlays.
+ * ----------
+ * Applied after the eased intensity: the intensity is scaled by a gain between (1 - depth) and 1 that follows the
+ * waveform. The phase is an accumulator advanced by the tick's nominal duration, so the pulse stays locked to the
+ * tick clock, keeps its phase across pause/resume, and does not jump when SleepTime changes.
+*/
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace oscillator
+{
+    enum class Waveform { None, Sine, Triangle, Square, Heartbeat };
+
+    struct Settings {
+        Waveform waveform = Waveform::None;
+        float frequency = 1.0f; // pulses per second at no intensity
+        float depth = 0.5f;     // how far the gain drops at the bottom of a pulse (0 to 1)
+        float rise = 0.0f;      // extra frequency at full intensity, as a multiple of frequency (1 = twice as fast)
+    };
+
+    // waveform shape over one cycle (phase 0 to 1), returns 0 to 1 with the peak at phase 0
+    inline float wave(Waveform waveform, double phase) {
+        constexpr double tau = 6.283185307179586;
+        switch (waveform) {
+            case Waveform::Sine: return static_cast<float>(0.5 + 0.5 * std::cos(tau * phase));
+            case Waveform::Triangle: return static_cast<float>(std::abs(1.0 - 2.0 * phase));
+            case Waveform::Square: return phase < 0.5 ? 1.0f : 0.0f;
+            case Waveform::Heartbeat: { // "lub-dub": a strong beat followed by a weaker one, then rest
+                auto beat = [phase](double center, double width) { double d = (phase - center) / width; return std::exp(-d * d); };
+                return static_cast<float>(std::min(1.0, beat(0.0, 0.06) + beat(1.0, 0.06) + 0.6 * beat(0.28, 0.07)));
+            }
+            default: return 1.0f;
+        }
+    }
+
+    // get waveform from its name (case insensitive). Returns None if unrecognized
+    inline Waveform getWaveformString(std::string name) {
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        if (name == "sine" || name == "sin" || name == "smooth") { return Waveform::Sine; }
+        if (name == "triangle" || name == "tri" || name == "linear") { return Waveform::Triangle; }
+        if (name == "square" || name == "blink" || name == "flash") { return Waveform::Square; }
+        if (name == "heartbeat" || name == "heart" || name == "beat") { return Waveform::Heartbeat; }
+        return Waveform::None;
+    }
+
+    inline const char* getStringWaveform(Waveform waveform) {
+        switch (waveform) {
+            case Waveform::Sine: return "sine";
+            case Waveform::Triangle: return "triangle";
+            case Waveform::Square: return "square";
+            case Waveform::Heartbeat: return "heartbeat";
+            default: return "none";
+        }
+    }
+
+    struct Oscillator {
+        double phase = 0.0; // position in the current cycle, 0 to 1
+
+        // advance the phase by one tick and return the gain to apply to the intensity
+        float step(const Settings &settings, float tickSeconds, float intensity) {
+            if (settings.waveform == Waveform::None) { return 1.0f; }
+            double frequency = settings.frequency * (1.0 + settings.rise * std::clamp(intensity, 0.0f, 1.0f));
+            phase += frequency * tickSeconds;
+            phase -= std::floor(phase);
+            return 1.0f - settings.depth * (1.0f - wave(settings.waveform, phase));
+        }
+    };
+}
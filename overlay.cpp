@@ -0,0 +1,199 @@
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <utility>
+#include "overlay.h"
+#include "trace.h"
+
+namespace overlay
+{
+    ImodParams ComputeImodParams(const Settings::OverlayData &stat, const timeline::Track &track) {
+        static const timeline::Track singleKey = {{0.0f}, {1.0f}};
+        ImodParams params;
+        params.baked = stat.keyframes > 1 && track.size() > 1;
+        auto &keys = params.baked ? track : singleKey;
+        params.count = std::min(keys.size(), timeline::maxKeys);
+        // each channel goes from its neutral value to its full value along the eased curve
+        const std::array<std::pair<float, float>, ChannelCount> channels = {{
+            {0.0f, stat.contrastAdd}, {1.0f, stat.contrastMult},
+            {0.0f, stat.brightnessAdd}, {1.0f, stat.brightnessMult},
+            {0.0f, stat.saturationAdd}, {1.0f, stat.saturationMult}
+        }};
+        for (int i = 0; i < params.count; i++) {
+            float value = keys.values[i];
+            params.times[i] = params.baked ? keys.times[i] * timeline::span : keys.times[i];
+            // tint color stays fixed and only its alpha fades in
+            params.tint[i] = Color{stat.tint.red, stat.tint.green, stat.tint.blue, stat.tint.alpha * value};
+            for (int c = 0; c < ChannelCount; c++) {
+                auto [neutral, full] = channels[c];
+                params.cinematic[c][i] = neutral + (full - neutral) * value;
+            }
+        }
+        return params;
+    }
+
+    void ApplyProfile(const Profile &profile, game::Imod &stamina, game::Imod &magicka, game::Imod &health) {
+        stamina.apply(ComputeImodParams(profile.stamina, profile.staminaTrack));
+        magicka.apply(ComputeImodParams(profile.magicka, profile.magickaTrack));
+        health.apply(ComputeImodParams(profile.health, profile.healthTrack));
+    }
+
+    float Approach(float current, float actual, float maxDeltaNeg, float maxDeltaPos) {
+        if (current < actual) {
+            if (actual - current > maxDeltaPos) { return current + maxDeltaPos; }
+            else { return actual; }
+        }
+        else {
+            if (current - actual > maxDeltaNeg) { return current - maxDeltaNeg; }
+            else { return actual; }
+        }
+    }
+
+    float EasedValue(float value, float start, float end, easing::easingFunction easeF) {
+        // return 0 when value is higher than start, and 1 when value is lower than end
+        if (value > start) { return static_cast<float>(easeF(0.0f)); }
+        if (value < end) { return static_cast<float>(easeF(1.0f)); }
+        // apply easing function backwards between start and end
+        auto range = start - end;
+        return static_cast<float>(easeF(((-value+end)/range)+1));
+    }
+
+    void ActorSets::sample(game::ActorValues &values, bool wantPlayer, bool wantCombatTarget, bool wantFollowers) {
+        for (auto [want, target, set]: {
+            std::tuple{wantPlayer, actors::Target::Player, &player},
+            std::tuple{wantCombatTarget, actors::Target::CombatTarget, &combatTarget},
+            std::tuple{wantFollowers, actors::Target::Followers, &followers}}) {
+            if (!want) continue;
+            STATFX_TRACE_SPAN("sample actors");
+            batch.clear();
+            values.sample(target, batch);
+            *set = actors::aggregate(batch);
+        }
+    }
+
+    WantedSets Wanted(std::initializer_list<std::pair<const Settings::OverlayData*, bool>> overlays) {
+        WantedSets wanted;
+        for (auto [stat, run]: overlays) {
+            if (!run || stat->source != sources::none) continue; // a plugin's source is read, not sampled
+            wanted.player |= stat->target == actors::Target::Player;
+            wanted.combatTarget |= stat->target == actors::Target::CombatTarget;
+            wanted.followers |= stat->target == actors::Target::Followers;
+        }
+        return wanted;
+    }
+
+    float ActorSets::value(const Settings::OverlayData &stat, actors::Stat which) const {
+        if (stat.source != sources::none) { return sources::registry.value(stat.source); }
+        switch (stat.target) {
+            case actors::Target::CombatTarget: return combatTarget.get(stat.aggregate, which);
+            case actors::Target::Followers: return followers.get(stat.aggregate, which);
+            default: return player.get(stat.aggregate, which);
+        }
+    }
+
+    void Tick(float *current, float *actual,
+        actors::Stat which,
+        const Settings::OverlayData &statOverlayData,
+        const ActorSets &sets,
+        const expr::Vars &shared,
+        game::Imod &imod,
+        oscillator::Oscillator *osc,
+        filter::Filter *noise,
+        predict::Predictor *lead,
+        lifecycle::Phase *phase,
+        float *emitted,
+        float tickSeconds) {
+            // a missing form or a broken read is a fault for this overlay only (see breakers)
+            if (!imod.loaded()) { throw Fault("imagespace modifier form not loaded"); }
+            // update the actual resource percentage from this tick's samples
+            *actual = sets.value(statOverlayData, which);
+            if (!std::isfinite(*actual)) { throw Fault("actor value read returned a non-finite value"); }
+            // filter out sampling noise (spikes pass straight through), the smoothing below follows the filtered value
+            float target = noise->step(statOverlayData.filter, *actual, tickSeconds);
+            // and aims it where the stat is heading, so a steady drain isn't trailed by an update plus the smoothing
+            target = lead->step(statOverlayData.predict, target);
+            bool pulsing = statOverlayData.pulse.waveform != oscillator::Waveform::None;
+            bool settled = std::abs(*current - target) < statOverlayData.minDelta;
+            if (!settled) {
+                // update current resource percentage to approach the actual resource percentage using configured deltas
+                *current = Approach(*current, target, statOverlayData.maxDelta, statOverlayData.maxDeltaPos);
+            } else if (!pulsing && !statOverlayData.intensity.dynamic && imod.live() && *phase == lifecycle::Phase::Active) {
+                // short circuit: settled and already on screen, so only a pulse would change anything. A baked timeline
+                // is still pinned where it was driven, or the engine would carry it on to the end of the track
+                if (statOverlayData.keyframes > 1) { imod.hold(); }
+                return;
+            }
+            float intensity;
+            {
+                STATFX_TRACE_SPAN("ease");
+                if (statOverlayData.intensity.native) {
+                    // no Intensity formula: the default program's steps in plain code, at under half its cost
+                    intensity = EasedValue(*current, statOverlayData.startFraction, statOverlayData.endFraction, statOverlayData.easingFunction);
+                } else {
+                    auto vars = shared;
+                    vars[expr::Stat] = *current;
+                    vars[expr::Actual] = *actual;
+                    intensity = statOverlayData.intensity.run(vars);
+                }
+            }
+            if (!std::isfinite(intensity)) { throw Fault("intensity expression gave a non-finite value"); }
+            // a formula that reads other stats or the situation runs every tick, but only an actual change touches the imod
+            if (settled && !pulsing && imod.live() && *phase == lifecycle::Phase::Active && intensity == *emitted) {
+                if (statOverlayData.keyframes > 1) { imod.hold(); }
+                return;
+            }
+            // nothing to show (stat above its Range): hold no instance at all until intensity rises above zero again
+            *phase = lifecycle::next(intensity, settled);
+            if (*phase == lifecycle::Phase::Inactive) {
+                STATFX_TRACE_SPAN("imod stop");
+                imod.stop();
+                *emitted = 0.0f;
+                return;
+            }
+            // oscillator stage: advanced by the nominal tick length so it stays locked to the tick clock
+            float gain = osc->step(statOverlayData.pulse, tickSeconds, intensity);
+            *emitted = intensity * gain;
+            // curve baked into the imod timeline: keep one instance alive and only drive its time (and strength for the pulse)
+            if (statOverlayData.keyframes > 1) {
+                STATFX_TRACE_SPAN("imod drive");
+                imod.drive(timeline::age(*current, statOverlayData.startFraction, statOverlayData.endFraction), gain);
+                return;
+            }
+            // update image space modifiers
+            STATFX_TRACE_SPAN("imod trigger");
+            imod.trigger(intensity * gain);
+    }
+
+    int TickStages(float current, const Settings::Stages &statStages, stages::Cursor *cursor, std::span<game::Imod* const> imods) {
+        auto &table = statStages.table;
+        auto count = std::min(table.size(), imods.size());
+        if (count == 0) { return 0; }
+        auto segment = table.find(current, cursor->segment);
+        if (segment == cursor->segment && current == cursor->value) { return 0; }
+        STATFX_TRACE_SPAN("stages");
+        int touched = 0;
+        auto drive = [&](std::size_t i, stages::State state) {
+            auto imod = imods[i];
+            if (!imod->loaded()) { return; }
+            if (state == stages::State::Off) {
+                imod->stop();
+            } else {
+                auto &look = statStages.looks[i];
+                imod->trigger(EasedValue(current, look.startFraction, look.endFraction, look.easingFunction));
+            }
+            touched++;
+        };
+        if (segment == cursor->segment) {
+            // same segment: only the ramping stages move
+            for (auto i: table.rampingIn(segment)) { if (i < count) drive(i, stages::State::Ramping); }
+        } else {
+            for (std::size_t i = 0; i < count; i++) {
+                auto state = table.state(segment, i);
+                if (state == stages::State::Ramping || cursor->segment == stages::Table::none || table.state(cursor->segment, i) != state) { drive(i, state); }
+            }
+        }
+        cursor->segment = segment;
+        cursor->value = current;
+        return touched;
+    }
+}
@@ -0,0 +1,94 @@
+/* Per-tick overlay logic: smoothing, easing, the imod parameters of a look, and sampling the bound actor sets.
+ * ----------
+ * Game-independent (part of statfx_core). Everything that touches the game goes through game::Imod and
+ * game::ActorValues, so a whole tick can run natively against stand-in implementations of them.
+ *
+ * usage:
+ * sets.sample(actorValues, true, false, false);
+ * overlay::Tick(&current, &actual, actors::Health, stat, sets, shared, imod, &osc, &noise, &lead, &phase, &emitted, 0.025f);
+ * overlay::TickStages(current, settings.healthStages, &cursor, stageImods);
+*/
+#pragma once
+#include <array>
+#include <exception>
+#include <initializer_list>
+#include <span>
+#include <utility>
+#include "settings.h"
+#include "game.h"
+#include "lifecycle.h"
+
+namespace overlay
+{
+    // the six cinematic channels of an imod, in the order ImodParams stores them
+    enum Channel { ContrastAdd, ContrastMult, BrightnessAdd, BrightnessMult, SaturationAdd, SaturationMult, ChannelCount };
+
+    // every key an overlay's look writes into its imod form
+    struct ImodParams {
+        int count = 0;      // keys per track
+        bool baked = false; // curve baked into the keys (timeline::span long), or a single full strength key driven by Trigger strength
+        std::array<float, timeline::maxKeys> times = {};
+        std::array<Color, timeline::maxKeys> tint = {};
+        std::array<std::array<float, timeline::maxKeys>, ChannelCount> cinematic = {};
+    };
+
+    // the keys for an overlay's look: its baked track, or a single full strength key when the curve is not baked
+    ImodParams ComputeImodParams(const Settings::OverlayData &stat, const timeline::Track &track);
+
+    // write a profile's looks into the overlays' imods (with their tracks baked, so this parses and allocates nothing)
+    void ApplyProfile(const Profile &profile, game::Imod &stamina, game::Imod &magicka, game::Imod &health);
+
+    // move current toward actual by at most maxDeltaNeg (down) or maxDeltaPos (up)
+    float Approach(float current, float actual, float maxDeltaNeg, float maxDeltaPos);
+
+    // convert 0 to 1 value percentage into 1 to 0 image modifier strength
+    float EasedValue(float value, float start, float end, easing::easingFunction easeF);
+
+    // Actor sets the overlays can be bound to, sampled in one batched pass per set every tick
+    struct ActorSets {
+        // per-actor samples, reused for every set so the arrays only grow once
+        actors::SampleBatch batch;
+        actors::Aggregates player, combatTarget, followers;
+
+        // sample whichever sets are wanted, aggregating each in the same pass
+        void sample(game::ActorValues &values, bool wantPlayer, bool wantCombatTarget, bool wantFollowers);
+        // value of a stat for an overlay, read from the sampled set it is bound to, or the plugin source it follows
+        float value(const Settings::OverlayData &stat, actors::Stat which) const;
+    };
+
+    // the actor sets the overlays running this tick are bound to. An overlay that isn't running (not due, or gated off
+    // by its conditions) or follows a plugin's source wants none, so while all are gated off no actor value is read
+    struct WantedSets {
+        bool player = false, combatTarget = false, followers = false;
+        bool any() const { return player || combatTarget || followers; }
+    };
+    WantedSets Wanted(std::initializer_list<std::pair<const Settings::OverlayData*, bool>> overlays);
+
+    // a fault in one overlay's tick. Its message is a fixed string, so throwing one builds nothing on the heap
+    struct Fault : std::exception {
+        explicit Fault(const char *reason) : reason(reason) {}
+        const char* what() const noexcept override { return reason; }
+        const char *reason;
+    };
+
+    // One overlay's tick: read its stat from the sampled sets, filter, predict and smooth it, run its Intensity program (shared holds
+    // the slots every overlay sees), pulse it, and drive the imod. Throws a Fault if the imod form is missing, the read is
+    // broken or the intensity isn't a number, a fault for this overlay only. Takes its settings by reference: no copies per tick
+    void Tick(float *current, float *actual,
+        actors::Stat which,
+        const Settings::OverlayData &statOverlayData,
+        const ActorSets &sets,
+        const expr::Vars &shared,
+        game::Imod &imod,
+        oscillator::Oscillator *osc,
+        filter::Filter *noise,
+        predict::Predictor *lead,
+        lifecycle::Phase *phase,
+        float *emitted,
+        float tickSeconds);
+
+    // Drive a stat's tiered stages (see stages.h) from its smoothed value: one imod per stage, in the order of the looks.
+    // Only stages that ramp at the value or changed state since the cursor was last moved touch their imod, and stages
+    // whose form isn't loaded are skipped. Returns the number of imods touched
+    int TickStages(float current, const Settings::Stages &statStages, stages::Cursor *cursor, std::span<game::Imod* const> imods);
+}
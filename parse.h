@@ -0,0 +1,230 @@
+/* Exception-free typed value parsing for ini settings, built on std::from_chars.
+ * ----------
+ * Works on string_views of the raw ini value: no copies, no allocation, no exceptions. Every parser returns a
+ * std::expected holding either the value or an Error saying what went wrong and where.
+ *
+ * usage:
+ * auto range = parse::pair( "( 0.95, 0.05 )" );   // -> {0.95, 0.05}
+ * auto tint = parse::color( "#c3b09166" );         // -> {0.76, 0.69, 0.57, 0.40}, 4 components
+ * auto form = parse::formRef( "StatFX.esp|0x801" ); // -> {"StatFX.esp", 0x801}
+ * if (!tint) logger::warn("{}", parse::describe(tint.error()));
+*/
+#pragma once
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <string_view>
+#include <system_error>
+
+namespace parse
+{
+    enum class Errc { Empty, Syntax, OutOfRange, TooFewValues, TooManyValues, TrailingCharacters };
+
+    struct Error {
+        Errc code;
+        std::size_t position; // offset into the original value where the problem was found
+    };
+
+    template <class T>
+    using Result = std::expected<T, Error>;
+
+    struct Color {
+        float r = 0.0f, g = 0.0f, b = 0.0f, a = 0.0f;
+        int components = 0; // how many channels were actually given (3 for rgb, 4 for rgba)
+    };
+
+    struct Pair {
+        float first = 0.0f, second = 0.0f;
+    };
+
+    struct FormRef {
+        std::string_view plugin;   // file name as written, e.g. "StatFX.esp" (a view into the parsed value)
+        std::uint32_t localID = 0; // FormID within that file, without the load order byte
+    };
+
+    inline const char* describe(Errc code) {
+        switch (code) {
+            case Errc::Empty: return "value is empty";
+            case Errc::Syntax: return "not a number";
+            case Errc::OutOfRange: return "number out of range";
+            case Errc::TooFewValues: return "too few values";
+            case Errc::TooManyValues: return "too many values";
+            case Errc::TrailingCharacters: return "unexpected characters after the value";
+            default: return "unknown error";
+        }
+    }
+    inline const char* describe(const Error &error) { return describe(error.code); }
+
+    namespace detail
+    {
+        inline bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v'; }
+        inline bool isAlpha(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+
+        // view of value with the whitespace trimmed off both ends, tracking the offset of the new start
+        inline std::string_view trim(std::string_view value, std::size_t &offset) {
+            while (!value.empty() && isSpace(value.front())) { value.remove_prefix(1); offset++; }
+            while (!value.empty() && isSpace(value.back())) { value.remove_suffix(1); }
+            return value;
+        }
+
+        // strip an optional function name (rgba, rgb, ...) and one pair of enclosing parentheses
+        inline std::string_view unwrap(std::string_view value, std::size_t &offset) {
+            value = trim(value, offset);
+            std::size_t name = 0;
+            while (name < value.size() && isAlpha(value[name])) { name++; }
+            if (name > 0 && name < value.size() && value[name] == '(') { value.remove_prefix(name); offset += name; }
+            if (value.size() >= 2 && value.front() == '(' && value.back() == ')') {
+                value.remove_prefix(1); value.remove_suffix(1); offset++;
+            }
+            return trim(value, offset);
+        }
+
+        // parse a float at the start of value (allowing a leading '+'), and require nothing but whitespace after it
+        inline Result<float> number(std::string_view value, std::size_t offset) {
+            value = trim(value, offset);
+            if (value.empty()) { return std::unexpected(Error{Errc::Empty, offset}); }
+            const char *first = value.data(), *last = value.data() + value.size();
+            if (*first == '+') { first++; }
+            float out = 0.0f;
+            auto [ptr, ec] = std::from_chars(first, last, out);
+            if (ec == std::errc::invalid_argument) { return std::unexpected(Error{Errc::Syntax, offset}); }
+            if (ec == std::errc::result_out_of_range) { return std::unexpected(Error{Errc::OutOfRange, offset}); }
+            if (ptr != last) { return std::unexpected(Error{Errc::TrailingCharacters, offset + static_cast<std::size_t>(ptr - value.data())}); }
+            return out;
+        }
+
+        // parse up to maxCount comma separated floats into out. Returns how many were found
+        inline Result<int> list(std::string_view value, std::size_t offset, float *out, int maxCount) {
+            value = unwrap(value, offset);
+            if (value.empty()) { return std::unexpected(Error{Errc::Empty, offset}); }
+            int count = 0;
+            for (;;) {
+                auto comma = value.find(',');
+                auto item = value.substr(0, comma);
+                if (count == maxCount) { return std::unexpected(Error{Errc::TooManyValues, offset}); }
+                auto parsed = number(item, offset);
+                if (!parsed) { return std::unexpected(parsed.error()); }
+                out[count++] = *parsed;
+                if (comma == std::string_view::npos) { break; }
+                value.remove_prefix(comma + 1);
+                offset += comma + 1;
+            }
+            return count;
+        }
+
+        inline int hexDigit(char c) {
+            if (c >= '0' && c <= '9') { return c - '0'; }
+            if (c >= 'a' && c <= 'f') { return c - 'a' + 10; }
+            if (c >= 'A' && c <= 'F') { return c - 'A' + 10; }
+            return -1;
+        }
+    }
+
+    // a single float, e.g. "1.5", " +2 ", "(0.3)"
+    inline Result<float> number(std::string_view value) {
+        std::size_t offset = 0;
+        // unwrap moves offset past what it strips, so it has to run before offset is read
+        auto unwrapped = detail::unwrap(value, offset);
+        return detail::number(unwrapped, offset);
+    }
+
+    // a whole number, decimal or hex with a 0x prefix, e.g. "66" or "0x42" (key codes)
+    inline Result<int> integer(std::string_view value) {
+        std::size_t offset = 0;
+        value = detail::unwrap(value, offset);
+        if (value.empty()) { return std::unexpected(Error{Errc::Empty, offset}); }
+        int base = 10;
+        if (value.size() > 2 && value[0] == '0' && (value[1] == 'x' || value[1] == 'X')) { value.remove_prefix(2); offset += 2; base = 16; }
+        int out = 0;
+        auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), out, base);
+        if (ec == std::errc::invalid_argument) { return std::unexpected(Error{Errc::Syntax, offset}); }
+        if (ec == std::errc::result_out_of_range) { return std::unexpected(Error{Errc::OutOfRange, offset}); }
+        if (ptr != value.data() + value.size()) { return std::unexpected(Error{Errc::TrailingCharacters, offset + static_cast<std::size_t>(ptr - value.data())}); }
+        return out;
+    }
+
+    // two comma separated floats, with or without parentheses, e.g. "( 0.95, 0.05 )" or ".05, .75"
+    inline Result<Pair> pair(std::string_view value) {
+        float values[2];
+        auto count = detail::list(value, 0, values, 2);
+        if (!count) { return std::unexpected(count.error()); }
+        if (*count < 2) { return std::unexpected(Error{Errc::TooFewValues, value.size()}); }
+        return Pair{values[0], values[1]};
+    }
+
+    // one float or a pair. A single value is used for both halves, e.g. FadeTime = 3 or FadeTime = (10, 3)
+    inline Result<Pair> numberOrPair(std::string_view value) {
+        float values[2];
+        auto count = detail::list(value, 0, values, 2);
+        if (!count) { return std::unexpected(count.error()); }
+        return *count == 1 ? Pair{values[0], values[0]} : Pair{values[0], values[1]};
+    }
+
+    // does value name a form by plugin and FormID (rather than by editor ID)
+    inline bool isFormRef(std::string_view value) { return value.find_first_of("|~") != std::string_view::npos; }
+
+    // a form by plugin and FormID, as "Plugin.esp|0x801" or "0x801~Plugin.esp". The 0x is optional, and a load order
+    // byte is dropped (0x0A000801 reads as 0x801), since it depends on the player's load order
+    inline Result<FormRef> formRef(std::string_view value) {
+        std::size_t offset = 0;
+        value = detail::trim(value, offset);
+        if (value.empty()) { return std::unexpected(Error{Errc::Empty, offset}); }
+        auto separator = value.find_first_of("|~");
+        if (separator == std::string_view::npos) { return std::unexpected(Error{Errc::TooFewValues, offset + value.size()}); }
+        bool idFirst = value[separator] == '~';
+        std::size_t pluginOffset = idFirst ? offset + separator + 1 : offset, idOffset = idFirst ? offset : offset + separator + 1;
+        auto plugin = detail::trim(idFirst ? value.substr(separator + 1) : value.substr(0, separator), pluginOffset);
+        auto id = detail::trim(idFirst ? value.substr(0, separator) : value.substr(separator + 1), idOffset);
+        if (plugin.empty()) { return std::unexpected(Error{Errc::Empty, pluginOffset}); }
+        // plugin has to be a .esp, .esm or .esl file
+        auto extension = plugin.size() > 4 ? plugin.substr(plugin.size() - 4) : std::string_view();
+        auto lower = [](char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; };
+        bool knownExtension = extension.size() == 4 && extension[0] == '.' && lower(extension[1]) == 'e' && lower(extension[2]) == 's' &&
+            (lower(extension[3]) == 'p' || lower(extension[3]) == 'm' || lower(extension[3]) == 'l');
+        if (!knownExtension) { return std::unexpected(Error{Errc::Syntax, pluginOffset + plugin.size()}); }
+        if (id.size() > 2 && id[0] == '0' && (id[1] == 'x' || id[1] == 'X')) { id.remove_prefix(2); idOffset += 2; }
+        if (id.empty()) { return std::unexpected(Error{Errc::Empty, idOffset}); }
+        if (id.size() > 8) { return std::unexpected(Error{Errc::OutOfRange, idOffset}); }
+        std::uint32_t formID = 0;
+        for (std::size_t i = 0; i < id.size(); i++) {
+            int digit = detail::hexDigit(id[i]);
+            if (digit < 0) { return std::unexpected(Error{Errc::Syntax, idOffset + i}); }
+            formID = formID << 4 | static_cast<std::uint32_t>(digit);
+        }
+        return FormRef{plugin, formID & 0x00FFFFFFu};
+    }
+
+    // channel scaling: anything above 1 is read as a 0-255 value
+    inline float channel(float value) { return value > 1.0f ? value / 255.0f : value; }
+
+    // a color as "#rrggbb", "#rrggbbaa", "rgb(r, g, b)", "rgba(r, g, b, a)" or bare "r, g, b[, a]".
+    // Channels can be 0-1 or 0-255 (see channel). Missing channels are left at 0, check components to warn about them
+    inline Result<Color> color(std::string_view value) {
+        std::size_t offset = 0;
+        auto trimmed = detail::unwrap(value, offset);
+        if (trimmed.empty()) { return std::unexpected(Error{Errc::Empty, offset}); }
+        Color out;
+        if (trimmed.front() == '#') {
+            trimmed.remove_prefix(1); offset++;
+            if (trimmed.size() != 6 && trimmed.size() != 8) {
+                return std::unexpected(Error{trimmed.size() < 6 ? Errc::TooFewValues : Errc::TooManyValues, offset});
+            }
+            float *channels[4] = {&out.r, &out.g, &out.b, &out.a};
+            for (std::size_t i = 0; i < trimmed.size(); i += 2) {
+                int hi = detail::hexDigit(trimmed[i]), lo = detail::hexDigit(trimmed[i+1]);
+                if (hi < 0 || lo < 0) { return std::unexpected(Error{Errc::Syntax, offset + i}); }
+                *channels[i/2] = static_cast<float>(hi * 16 + lo) / 255.0f;
+            }
+            out.components = static_cast<int>(trimmed.size() / 2);
+            return out;
+        }
+        float values[4];
+        auto count = detail::list(trimmed, offset, values, 4);
+        if (!count) { return std::unexpected(count.error()); }
+        float *channels[4] = {&out.r, &out.g, &out.b, &out.a};
+        for (int i = 0; i < *count; i++) { *channels[i] = channel(values[i]); }
+        out.components = *count;
+        return out;
+    }
+}
@@ -0,0 +1,107 @@
+/* Smoothed overlay state saved in the SKSE co-save, so a loaded game resumes exactly where it was saved.
+ * ----------
+ * The serializer only talks to the Writer and Reader interfaces and has no SKSE dependency: the plugin adapts the
+ * SKSE serialization interface to them, while BufferWriter and BufferReader keep a round trip in memory.
+ *
+ * usage:
+ * persistence::BufferWriter out;
+ * persistence::save(out, snapshot);
+ * persistence::BufferReader in(out.bytes);
+ * auto restored = persistence::load(in, persistence::version);
+*/
+#pragma once
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <vector>
+#include "actors.h"
+
+namespace persistence
+{
+    constexpr std::uint32_t uniqueID = 0x53465850;   // "SFXP", the plugin's id in the co-save
+    constexpr std::uint32_t recordType = 0x4F564C59; // "OVLY"
+    constexpr std::uint32_t version = 1;
+
+    // what one overlay needs to pick up where it left off
+    struct OverlayState {
+        float current = 1.0f;  // smoothed stat percentage
+        double phase = 0.0;    // pulse oscillator phase
+        float emitted = 0.0f;  // last imod strength emitted
+    };
+
+    // every overlay's state, in actors::Stat order (health, stamina, magicka)
+    struct Snapshot {
+        std::array<OverlayState, actors::StatCount> overlays;
+    };
+
+    class Writer {
+    public:
+        virtual ~Writer() = default;
+        virtual bool write(const void *data, std::uint32_t size) = 0;
+    };
+
+    class Reader {
+    public:
+        virtual ~Reader() = default;
+        // read exactly size bytes. Returns false if the record ran out first
+        virtual bool read(void *data, std::uint32_t size) = 0;
+    };
+
+    namespace detail
+    {
+        template <class T>
+        bool put(Writer &out, const T &value) { return out.write(&value, sizeof(T)); }
+
+        template <class T>
+        bool get(Reader &in, T &value) { return in.read(&value, sizeof(T)); }
+    }
+
+    inline bool save(Writer &out, const Snapshot &snapshot) {
+        if (!detail::put(out, static_cast<std::uint32_t>(snapshot.overlays.size()))) { return false; }
+        for (auto &overlay: snapshot.overlays) {
+            if (!detail::put(out, overlay.current) || !detail::put(out, overlay.phase) || !detail::put(out, overlay.emitted)) { return false; }
+        }
+        return true;
+    }
+
+    // read a snapshot written by save(). Empty if the record is from another version, truncated or holds garbage
+    inline std::optional<Snapshot> load(Reader &in, std::uint32_t recordVersion) {
+        if (recordVersion != version) { return std::nullopt; }
+        std::uint32_t count = 0;
+        if (!detail::get(in, count) || count != actors::StatCount) { return std::nullopt; }
+        Snapshot snapshot;
+        for (auto &overlay: snapshot.overlays) {
+            if (!detail::get(in, overlay.current) || !detail::get(in, overlay.phase) || !detail::get(in, overlay.emitted)) { return std::nullopt; }
+            if (!std::isfinite(overlay.current) || !std::isfinite(overlay.phase) || !std::isfinite(overlay.emitted)) { return std::nullopt; }
+        }
+        return snapshot;
+    }
+
+    // in-memory record, for round trips outside the game
+    class BufferWriter : public Writer {
+    public:
+        bool write(const void *data, std::uint32_t size) override {
+            auto first = static_cast<const std::byte*>(data);
+            bytes.insert(bytes.end(), first, first + size);
+            return true;
+        }
+        std::vector<std::byte> bytes;
+    };
+
+    class BufferReader : public Reader {
+    public:
+        explicit BufferReader(const std::vector<std::byte> &bytes) : bytes(bytes) {}
+        bool read(void *data, std::uint32_t size) override {
+            if (bytes.size() - position < size) { return false; }
+            std::memcpy(data, bytes.data() + position, size);
+            position += size;
+            return true;
+        }
+    private:
+        const std::vector<std::byte> &bytes;
+        std::size_t position = 0;
+    };
+}
@@ -1,47 +1,34 @@
 #include "logger.h"
 #include "ini.h"
 #include "easing.h"
-
-// settings to be filled in from ini file
-static class Settings {
-    public:
-    struct OverlayData {
-        bool enabled = true;
-        std::string editorID;
-        RE::NiColorA tint = RE::NiColorA(1.0f,1.0f,1.0f,0.0f);
-        float contrastAdd = 0.0f;
-        float contrastMult = 1.0f;
-        float brightnessAdd = 0.0f;
-        float brightnessMult = 1.0f;
-        float saturationAdd = 0.0f;
-        float saturationMult = 1.0f;
-        float startFraction = 1.0f;
-        float endFraction = 0.0f;
-        easing::easingFunction easingFunction = easing::linear;
-        float minDelta = 0.01f;
-        float maxDelta = 0.015f;
-        float maxDeltaPos = 0.015f;
-    } stamina, magicka, health, defaultValues;
-    const std::vector<OverlayData*> stats = {&stamina, &magicka, &health};
-    int sleepTime = 25;
-    std::string iniPath = "StatFX.ini";
-    bool reload = true;
-    const std::map<std::string, std::string> defaultEditorIDs = {
-        {"Stamina", "StatFXImodStam"},
-        {"Magicka", "StatFXImodMag"},
-        {"Health", "StatFXImodHealth"}
-    };
-    // reset to default values
-    void Reset() {
-        stamina = OverlayData();
-        magicka = OverlayData();
-        health = OverlayData();
-        sleepTime = 25;
-        iniPath = "StatFX.ini";
-        reload = true;
-    }
-} settings;
-
+#include "timeline.h"
+#include "oscillator.h"
+#include "actors.h"
+#include "telemetry.h"
+#include "breaker.h"
+#include "persistence.h"
+#include "conditions.h"
+#include "lifecycle.h"
+#include "settings.h"
+#include "overlay.h"
+#include "timerwheel.h"
+#include "parse.h"
+#include "forms.h"
+#include "trace.h"
+#include "stages.h"
+#include "sequence.h"
+#include "expr.h"
+#include "layers.h"
+#include "sources.h"
+
+// settings to be filled in from ini file (see settings.h)
+static Settings settings;
+
+// compiled profiles, the base config first (see settings.h). Switched and replaced only on the main thread
+static Profiles profiles;
+
+// profiles being loaded by initSettings and baked by initForms, then offered to the main thread
+static Profiles loading;
 
 
 // state enum for main thread to check
@@ -76,421 +63,386 @@ static struct ImodInstances {
     RE::ImageSpaceModifierInstanceForm *health = nullptr;
 } imodInstances;
 
-static std::vector<std::pair<RE::TESImageSpaceModifier**, RE::ImageSpaceModifierInstanceForm**>> imodAndInstance = {
-    {&imods.stamina, &imodInstances.stamina},
-    {&imods.magicka, &imodInstances.magicka},
-    {&imods.health, &imodInstances.health}
+// Pulse oscillators for each stat. Not reset with the settings, so the phase carries over pause/resume and reloads
+static struct Oscillators {
+    oscillator::Oscillator stamina;
+    oscillator::Oscillator magicka;
+    oscillator::Oscillator health;
+} oscillators;
+
+// Noise filters on each stat's samples. Reset whenever the thread starts running, so the first sample goes through as is
+static struct Filters {
+    filter::Filter stamina;
+    filter::Filter magicka;
+    filter::Filter health;
+} filters;
+
+// Rate predictors on each stat's filtered samples. Reset with the filters, so a new run starts without a trend
+static struct Predictors {
+    predict::Predictor stamina;
+    predict::Predictor magicka;
+    predict::Predictor health;
+} predictors;
+
+// Lifecycle phase of each stat's overlay (see lifecycle.h). Only meaningful while the overlay holds an instance
+static struct Lifecycles {
+    lifecycle::Phase stamina = lifecycle::Phase::Inactive;
+    lifecycle::Phase magicka = lifecycle::Phase::Inactive;
+    lifecycle::Phase health = lifecycle::Phase::Inactive;
+} lifecycles;
+
+// Fault tracking for each stat's overlay, reset whenever the settings are (re)loaded
+static struct Breakers {
+    breaker::CircuitBreaker stamina;
+    breaker::CircuitBreaker magicka;
+    breaker::CircuitBreaker health;
+} breakers;
+
+// Fault log lines for each stat's overlay, each rate limited on its own so one overlay's faults never hide another's
+static struct FaultLogs {
+    rate_limited::Limiter stamina;
+    rate_limited::Limiter magicka;
+    rate_limited::Limiter health;
+} faultLogs;
+
+// Shared memory feed of each tick's values, only opened when Telemetry is set in the ini
+static telemetry::Producer telemetryProducer;
+
+// Smoothed overlay state kept in the co-save. The main thread refreshes live every tick for the save callback,
+// and the load callback leaves restored for the main thread to apply before its first tick
+static struct SavedState {
+    std::mutex lock;
+    persistence::Snapshot live;
+    std::optional<persistence::Snapshot> restored;
+} savedState;
+
+// Player situation flags for overlay conditions, refreshed by game events instead of being read every tick
+static conditions::PlayerState playerState;
+
+// Timeline trace file, next to StatFX.log
+std::string TracePath() {
+    auto logsFolder = SKSE::log::log_directory();
+    return logsFolder ? (*logsFolder / "StatFX.trace.json").string() : std::string("StatFX.trace.json");
+}
+
+// Trace hotkey: start tracing, or stop and write what was recorded
+void ToggleTrace() {
+    if (!trace::IsEnabled()) {
+        trace::Enable(true, static_cast<std::size_t>(settings.traceEvents));
+        logger::info("Trace: Recording the overlay timeline");
+        return;
+    }
+    trace::Enable(false);
+    auto path = TracePath();
+    if (trace::Write(path)) { logger::info("Trace: {} events written to {} ({} dropped)", trace::EventCount(), path, trace::DroppedCount()); }
+    else { logger::error("Trace: Could not write {}", path); }
+}
+
+// a trace still recording when the game exits is written then
+static struct TraceAtExit {
+    ~TraceAtExit() { if (trace::IsEnabled()) { trace::Enable(false); trace::Write(TracePath()); } }
+} traceAtExit;
+
+class PlayerStateEvents :
+    public RE::BSTEventSink<RE::TESCombatEvent>,
+    public RE::BSTEventSink<SKSE::ActionEvent>,
+    public RE::BSTEventSink<RE::BSAnimationGraphEvent>,
+    public RE::BSTEventSink<RE::MenuOpenCloseEvent> {
+public:
+    static PlayerStateEvents* GetSingleton() {
+        static PlayerStateEvents singleton;
+        return &singleton;
+    }
+    // event sources that last for the whole session
+    void Register() {
+        if (auto scripts = RE::ScriptEventSourceHolder::GetSingleton()) { scripts->AddEventSink<RE::TESCombatEvent>(this); }
+        if (auto actions = SKSE::GetActionEventSource()) { actions->AddEventSink(this); }
+        if (auto ui = RE::UI::GetSingleton()) { ui->AddEventSink<RE::MenuOpenCloseEvent>(this); }
+    }
+    // the player's animation graph is rebuilt on every load: attach to it again and read every flag once
+    void Refresh() {
+        if (!player) { return; }
+        player->AddAnimationGraphEventSink(this);
+        playerState.set(conditions::InCombat, player->IsInCombat());
+        playerState.set(conditions::WeaponDrawn, player->AsActorState()->IsWeaponDrawn());
+        playerState.set(conditions::Sneaking, player->IsSneaking());
+    }
+    RE::BSEventNotifyControl ProcessEvent(const RE::TESCombatEvent*, RE::BSTEventSource<RE::TESCombatEvent>*) override {
+        // someone entered or left combat, which may have changed the player's combat state
+        if (player) { playerState.set(conditions::InCombat, player->IsInCombat()); }
+        return RE::BSEventNotifyControl::kContinue;
+    }
+    RE::BSEventNotifyControl ProcessEvent(const SKSE::ActionEvent *event, RE::BSTEventSource<SKSE::ActionEvent>*) override {
+        if (!event || !player || event->actor != player) { return RE::BSEventNotifyControl::kContinue; }
+        if (event->type == SKSE::ActionEvent::Type::kBeginDraw) { playerState.set(conditions::WeaponDrawn, true); }
+        else if (event->type == SKSE::ActionEvent::Type::kEndSheathe) { playerState.set(conditions::WeaponDrawn, false); }
+        return RE::BSEventNotifyControl::kContinue;
+    }
+    RE::BSEventNotifyControl ProcessEvent(const RE::BSAnimationGraphEvent *event, RE::BSTEventSource<RE::BSAnimationGraphEvent>*) override {
+        // movement state changes (sneak, normal, combat) end in a "tail..." event, e.g. tailSneakIdle or tailMTLocomotion
+        if (event && player && std::string_view(event->tag.c_str()).starts_with("tail")) { playerState.set(conditions::Sneaking, player->IsSneaking()); }
+        return RE::BSEventNotifyControl::kContinue;
+    }
+    RE::BSEventNotifyControl ProcessEvent(const RE::MenuOpenCloseEvent *event, RE::BSTEventSource<RE::MenuOpenCloseEvent>*) override {
+        if (!event) { return RE::BSEventNotifyControl::kContinue; }
+        std::string name(event->menuName.c_str());
+        if (event->opening) {
+            auto ui = RE::UI::GetSingleton();
+            auto menu = ui ? ui->GetMenu(event->menuName) : nullptr;
+            if (menu && menu->PausesGame()) { pausingMenus.insert(name); }
+        } else {
+            pausingMenus.erase(name);
+        }
+        playerState.set(conditions::InMenu, !pausingMenus.empty());
+        return RE::BSEventNotifyControl::kContinue;
+    }
+private:
+    std::unordered_set<std::string> pausingMenus; // open menus that pause the game (only touched by UI events)
 };
 
 // Read settings file and fill out settings struct
 void initSettings() {
+    STATFX_TRACE_SPAN("load settings");
     logger::info("INI Config: INITIALIZATION");
     // Common sense short curcuit if state is not pause
     if (state != State::Pause) {
         logger::error("INI Config: Error, trying to read settings while thread is not paused, skipping settings read");
         return;
     }
-    // lambda to convert string to lowercase
-    auto strLower = [](std::string str) -> std::string {
-        std::transform(str.begin(), str.end(), str.begin(), ::tolower);
-        return str;
-    };
-    // lambda to remove all whitespace and parentheses and convert to lowercase
-    auto normalizeStr = [strLower](std::string str) -> std::string {
-        str.erase(std::remove(str.begin(), str.end(), ' '), str.end());
-        str.erase(std::remove(str.begin(), str.end(), '('), str.end());
-        str.erase(std::remove(str.begin(), str.end(), ')'), str.end());
-        return strLower(str);
-    };
     // reinitialize settings
     settings.Reset();
-    auto skyrimPath = std::filesystem::current_path().string();
-    logger::info("INI Config: Reading '{}' file for settings", "..\\Data\\SKSE\\Plugins\\" + settings.iniPath);
+    auto pluginsPath = std::filesystem::current_path() / "Data" / "SKSE" / "Plugins";
     try {
-        // check if ini file exists
-        if (!std::filesystem::exists(skyrimPath + "\\Data\\SKSE\\Plugins\\" + settings.iniPath)) {
+        // the base ini and any preset overrides next to it (see layers.h), parsed in parallel and merged in name order
+        auto files = layers::Discover(pluginsPath / settings.iniPath);
+        if (files.empty()) {
             // log a warning
-            logger::warn("INI Config: File not found: Using default settings (no overlays)");
+            logger::warn("INI Config: '{}' not found: Using default settings (no overlays)", "..\\Data\\SKSE\\Plugins\\" + settings.iniPath);
+            ResetProfiles(settings, loading);
             return;
         }
-        mINI::INIFile iniFile(skyrimPath + "\\Data\\SKSE\\Plugins\\" + settings.iniPath);
-        mINI::INIStructure iniStruct;
-        iniFile.read(iniStruct);
+        for (auto &file: files) { logger::info("INI Config: Reading '{}' file for settings", "..\\Data\\SKSE\\Plugins\\" + file.filename().string()); }
+        auto merged = layers::Merge(layers::Read(files));
+        auto &iniStruct = merged.ini;
         // get global settings
-        auto iniSleepTime = iniStruct.get("Global").get("SleepTime");
-        if (iniSleepTime.empty() ) {
-            logger::warn("INI Config: Global Section: SleepTime not found: Using default value");
-        } else {
-            try { settings.sleepTime = static_cast<int>(round(std::stof( iniSleepTime ))); }
-            catch (const std::exception& e) {
-                logger::error("{}", e.what());
-                logger::warn("INI Config: Global Section: Error reading SleepTime '{}': Using default value", iniSleepTime);
-            }
-        }
-        // Set no reload flag if defined (try variations on key)
-        std::string iniReload = "";
-        for (auto key: {"Reload","ReloadFlag","AutoReload","AutoReloadFlag","AutoLoad","Refresh","AutoRefresh","Sync"}) {
-            iniReload = iniStruct.get("Global").get(key);
-            if (!iniReload.empty()) break;
+        // log level first, so the rest of the load only logs what was asked for
+        auto iniLogLevel = iniStruct.get("Global").get("LogLevel");
+        if (!iniLogLevel.empty()) {
+            auto level = iniLogLevel;
+            std::transform(level.begin(), level.end(), level.begin(), ::tolower);
+            if (SetLogLevel(level)) { settings.logLevel = level; }
+            else { logger::warn("INI Config: Global Section: Could not understand LogLevel '{}': Using default value", iniLogLevel); }
         }
-        if (!iniReload.empty() && normalizeStr(iniReload)=="false") {
-            logger::info("INI Config: Reload flag set to false");
-            settings.reload = false;
+        SetLogLevel(settings.logLevel);
+        // everything else: global settings, overlays and profiles
+        ReadSettings(iniStruct, settings, loading);
+        if (settings.trace && !trace::IsEnabled()) {
+            trace::Enable(true, static_cast<std::size_t>(settings.traceEvents));
+            logger::info("INI Config: Tracing the overlay timeline, written to {} at exit", TracePath());
         }
-        // lambda to init a stat's overlay (stamina, magicka, health)
-        auto initOverlay = [strLower, normalizeStr,iniStruct](Settings::OverlayData *stat, std::string section) {
-            logger::info("INI Config: Initializing settings for section: '{}'", section);
-            // Check if disable flag for this overlay is set in ini (try variations on key "disabled")
-            std::string iniDisabled = "";
-            for (auto key: {"Disabled","Disable","Off","Inactive","Paused","Pause"}) {
-                iniDisabled = iniStruct.get(section).get(key);
-                if (!iniDisabled.empty()) break;
-            }
-            if (!iniDisabled.empty() && normalizeStr(iniDisabled)=="true") {
-                logger::info("INI Config: Disabling {} overlay: manual disabled flag set", section);
-                stat->enabled = false;
-                return;
-            }
-            // Check if disable flag for this overlay in ini (try variations on key "enabled")
-            std::string iniEnabled = "";
-            for (auto key: {"Enabled","Enable","On","Active","Start","Run","Go"}) {
-                iniEnabled = iniStruct.get(section).get(key);
-                if (!iniEnabled.empty()) break;
-            }
-            if (!iniEnabled.empty() && normalizeStr(iniEnabled)=="false") {
-                logger::info("INI Config: Section {}: Disabling overlay: manual disable flag set", section);
-                stat->enabled = false;
-                return;
-            }
-            // try variation on key EditorId
-            std::string iniEditorID = "";
-            for (auto key: {"EditorID","Imod","ImodID","ImodEditorID","ImodFormID","FormID","ID","EditorFormID","ImodFormID","Form","Name"}) {
-                iniEditorID = iniStruct.get(section).get(key);
-                if (!iniEditorID.empty()) break;
-            }
-            logger::info("INI Config: Section {}: Editor ID read: '{}'", section, iniEditorID);
-            if (iniEditorID.empty()) {
-                logger::warn("INI Config: Section {}: EditorID is empty, using default: '{}'", section, settings.defaultEditorIDs.at(section));
-                iniEditorID = settings.defaultEditorIDs.at(section);
-            }
-            stat->editorID = iniEditorID;
-            // Fill in tint color settings from ini if they exist, otherwise keep default (try variations on key "TintColor")
-            std::string iniTintColor = "";
-            for (auto key: {"TintColor","Tint","Color","Colour","TintColour","TintRGB","TintRGBA"}) {
-                iniTintColor = iniStruct.get(section).get(key);
-                if (!iniTintColor.empty()) break;
-            } // this is a hex color code: https://rgbcolorpicker.com for instance
-            float tintR=0.0f, tintG=0.0f, tintB=0.0f, tintA=0.0f;
-            std::vector<float*> tints = {&tintR, &tintG, &tintB, &tintA};
-            if (!iniTintColor.empty()) {
-                // remove whitespace and parentheses
-                iniTintColor.erase(std::remove(iniTintColor.begin(), iniTintColor.end(), ' '), iniTintColor.end());
-                iniTintColor.erase(std::remove(iniTintColor.begin(), iniTintColor.end(), '('), iniTintColor.end());
-                iniTintColor.erase(std::remove(iniTintColor.begin(), iniTintColor.end(), ')'), iniTintColor.end());
-                // if it starts with hash, remove it and parse the color code
-                if (iniTintColor[0] == '#') {
-                    iniTintColor.erase(0,1);
-                    try { // convert hex code to float color values
-                        tintR = static_cast<float>(std::stoi(iniTintColor.substr(0,2), nullptr, 16))/255.0f;
-                        tintG = static_cast<float>(std::stoi(iniTintColor.substr(2,2), nullptr, 16))/255.0f;
-                        tintB = static_cast<float>(std::stoi(iniTintColor.substr(4,2), nullptr, 16))/255.0f;
-                        if (iniTintColor.length() == 8) tintA = static_cast<float>(std::stoi(iniTintColor.substr(6,2), nullptr, 16))/255.0f;
-                    } catch (const std::exception& e) {
-                        logger::error("{}", e.what());
-                        logger::warn("INI Config: {} Section: Could not understand TintColor hex code '{}', using default (no tint)",section,iniTintColor);
-                    }
-                } else {
-                    // since its not a hash, parse it as comma seperated rgba values
-                    // remove all alphabet characters
-                    iniTintColor.erase(std::remove_if(iniTintColor.begin(), iniTintColor.end(), ::isalpha), iniTintColor.end());
-                    // parse 4 comma seperated values as float color values
-                    std::vector<std::string> strVals;
-                    std::stringstream ss(iniTintColor);
-                    while(ss.good()) {
-                        std::string substr;
-                        std::getline(ss, substr, ',');
-                        strVals.push_back(substr);
-                    }
-                    for (int i=0; i<4; i++) {
-                        if (i>=strVals.size()) {
-                            logger::warn("INI Config: {} Section: TintColor RGBA '{}' is missing some values. Using default (255,255,255,0) for the missing ones", section, iniTintColor);
-                            break;
-                        }
-                        try { *tints[i] = std::stof(strVals[i]); }
-                        catch (const std::exception& e) {
-                            logger::error("{}", e.what());
-                            logger::warn("INI Config: {} Section: Could not understand TintColor RGBA '{}' value {}, skipping", section, iniTintColor, i+1);
-                        }
-                    }
-                }
-            }
-            if (!iniStruct.get(section).get("TintStrength").empty()) tintA=std::stof(iniStruct.get(section).get("TintStrength")); // alias for TintAlpha
-            // legacy tint key support: override with "TintRed", "TintGreen", "TintBlue", "TintAlpha" if they exist
-            if (!iniStruct.get(section).get("TintRed").empty()) tintR=std::stof(iniStruct.get(section).get("TintRed"));
-            if (!iniStruct.get(section).get("TintGreen").empty()) tintG=std::stof(iniStruct.get(section).get("TintGreen"));
-            if (!iniStruct.get(section).get("TintBlue").empty()) tintB=std::stof(iniStruct.get(section).get("TintBlue"));
-            if (!iniStruct.get(section).get("TintAlpha").empty()) tintA=std::stof(iniStruct.get(section).get("TintAlpha"));
-            // Any values above 1 will be interpreted as out of 255 range, so divide by 255
-            for (auto tint: {&tintR, &tintG, &tintB, &tintA}) { if (*tint>1.0f) *tint/=255.0f;}
-            // warn if any of the values are out of range 0 to 1
-            if (tintR<0.0f || tintR>1.0f || tintG<0.0f || tintG>1.0f || tintB<0.0f || tintB>1.0f || tintA<0.0f || tintA>1.0f) {
-                logger::error("INI Config: {} Section: some tint color value (r{:.2} g{:.2} b{:.2} a{:.2}) is out of range (0.0 to 1.0): Using default (no tint)", section, tintR, tintG, tintB, tintA);
-                tintR=0.0f; tintG=0.0f; tintB=0.0f; tintA=0.0f;
-            }
-            stat->tint = RE::NiColorA(tintR, tintG, tintB, tintA);
-            // Fill in cinematic settings from ini if they exist, otherwise keep default
-            std::vector<std::pair<float*, std::string>> cinematics = {
-                {&stat->contrastAdd, "ContrastAdd"},
-                {&stat->contrastMult, "ContrastMult"},
-                {&stat->contrastMult, "Contrast"},
-                {&stat->brightnessAdd, "BrightnessAdd"},
-                {&stat->brightnessMult, "BrightnessMult"},
-                {&stat->brightnessMult, "Brightness"},
-                {&stat->saturationAdd, "SaturationAdd"},
-                {&stat->saturationMult, "SaturationMult"},
-                {&stat->saturationMult, "Saturation"}
-            };
-            for (auto [dest, key]: cinematics) {
-                if (!iniStruct.get(section).get(key).empty()) {
-                    auto iniVal = iniStruct.get(section).get(key);
-                    if (iniVal.empty()) continue;
-                    try { *dest = std::stof( iniVal ); }
-                    catch (const std::exception& e) {
-                        logger::error("{}", e.what());
-                        logger::warn("INI Config: {} Section: Could not understand {}:'{}': Using default", section, key, iniVal);
-                    }
-                }
-            }
-            // Fill in curve range info from ini
-            float startF=1.0f, endF=0.0f;
-            // try variations of key Range
-            std::string iniRange = "";
-            for (auto key: {"Range","CurveRange","StartEnd","StatRange","EffectRange","FromTo"}) {
-                iniRange = iniStruct.get(section).get(key);
-                if (!iniRange.empty()) break;
-            }
-            if (!iniRange.empty()) {
-                // remove white space and parantheses
-                iniRange.erase(std::remove(iniRange.begin(), iniRange.end(), ' '), iniRange.end());
-                iniRange.erase(std::remove(iniRange.begin(), iniRange.end(), '('), iniRange.end());
-                iniRange.erase(std::remove(iniRange.begin(), iniRange.end(), ')'), iniRange.end());
-                // start is before comma, end is after comma
-                auto commaPos = iniRange.find(",");
-                if (commaPos == std::string::npos) {
-                    logger::warn("INI Config: {} Section: Could not understand Range '{}': Using defaults (Start:1.0, End:0.0)", section, iniRange);
-                } else {
-                    auto end = iniRange.substr(0, commaPos);
-                    auto start = iniRange.substr(commaPos+1);
-
-                    try {
-                        startF = std::stof( start ); endF = std::stof( end );
-                    } catch (const std::exception& e) {
-                        logger::error("{}", e.what());
-                        logger::warn("INI Config: {} Section: Could not understand Range '{}': Using defaults (Start: 1.0, End: 0.0)", section, iniRange);
-                        startF = 1.0f; endF = 0.0f;
-                    }
-                    if ( endF>1.0 || endF<0.0 || startF>1.0 || startF<0.0 ) {
-                        logger::warn("INI Config: {} Section: Range Start '{:.2}' and End '{:.2}' must be in range 0 to 1: Using defaults (Start: 1.0, End: 0.0)", section, startF, endF);
-                        startF = 1.0f; endF = 0.0f;
-                    } else {
-                        // flip start and end if start is lower than end
-                        if (startF < endF) {
-                            logger::warn("INI Config: {} Section: Range Start '{:.2}' is lower than End '{:.2}': Flipping values", section, startF, endF);
-                            float temp = startF;
-                            startF = endF;
-                            endF = temp;
-                        }
-                    }
-                }
-            }
-            // legacy start and end fraction
-            // try variations of key StartFraction and EndFraction
-            std::string iniStartFraction = "";
-            for (auto key: {"StartFraction","Start","To","Upper","Upperbound","UpperBound"}) {
-                iniStartFraction = iniStruct.get(section).get(key);
-                if (!iniStartFraction.empty()) break;
-            }
-            if (!iniStartFraction.empty()) {
-                try { startF = std::stof( iniStartFraction ); }
-                catch (const std::exception& e) {
-                    logger::error("{}", e.what());
-                    logger::warn("INI Config: {} Section: Could not understand StartFraction '{}': Using default (Start: {:.2})", section, iniStartFraction, settings.defaultValues.startFraction);
-                    startF = 1.0f;
-                }
-            }
-            std::string iniEndFraction = "";
-            for (auto key: {"EndFraction","End","From","Lower","Lowerbound","LowerBound"}) {
-                iniEndFraction = iniStruct.get(section).get(key);
-                if (!iniEndFraction.empty()) break;
-            }
-            if (!iniEndFraction.empty()) {
-                try { endF = std::stof( iniEndFraction ); }
-                catch (const std::exception& e) {
-                    logger::error("{}", e.what());
-                    logger::warn("INI Config: {} Section: Could not understand EndFraction '{}': Using default (End: {:.2})", section, iniEndFraction, settings.defaultValues.endFraction);
-                    endF = 0.0f;
-                }
-            }
-            if ( endF>1.0 || endF<0.0 || startF>1.0 || startF<0.0 ) {
-                logger::warn("INI Config: {} Section: StartFraction '{:.2}' and EndFraction '{:.2}' must be in range 0 to 1: Using defaults (Start: 1.0, End: 0.0)", section, startF, endF);
-                startF = 1.0f; endF = 0.0f;
-            }
-            //  flip start and end if start is lower than end
-            if (startF < endF) {
-                logger::warn("INI Config: {} Section: StartFraction '{:.2}' is lower than EndFraction '{:.2}': Flipping values", section, startF, endF);
-                float temp = startF;
-                startF = endF;
-                endF = temp;
-            }
-            stat->startFraction = startF;
-            stat->endFraction = endF;
-            // get easing function value from ini (try variations on key)
-            easing::easingFunction easingFunction = settings.defaultValues.easingFunction;
-            std::string iniEasingFunction = "";
-            for (auto key: {"EasingFunction","Ease","Function","Curve","Easing","EasingFunc",
-                "CurveFunction","CurveFunc","EaseFunc","EaseFunction","CurveType","EasingCurve","EaseCurve"}) {
-                iniEasingFunction = iniStruct.get(section).get(key);
-                if (iniEasingFunction.empty()) continue;
-                easingFunction = easing::getEasingFunctionString( iniEasingFunction ); break;
-            }
-            // warn if it defaulted to linear
-            if (easingFunction == easing::linear && iniEasingFunction!="linear") {
-                logger::warn("INI Config: {} Section: No match for Easing Curve '{}': using 'linear' default", section, iniEasingFunction);
-            } else {
-                stat->easingFunction = easingFunction;
-            }
-            // read FadeTime as a high-level setting for maxDelta. This is how many seconds to go from no effect to full effect
-            float maxDeltaNeg=settings.defaultValues.maxDelta; float maxDeltaPos=settings.defaultValues.maxDeltaPos; float minDelta=settings.defaultValues.minDelta;
-            std::string iniFadeTime = "";
-            // try variations on key
-            for (auto key: {"FadeTime","TransitionTime","Transition","Fade","Time","FadeDuration","FadeSecs","FadeSeconds","FadeS"}) {
-                iniFadeTime = iniStruct.get(section).get(key);
-                if (!iniFadeTime.empty()) break;
-            }
-            { // this weird block with SKIP_FADE_TIME lets me succinctly break processing FadeTime when we know parsing failed somewhere
-                if (iniFadeTime.empty()) {
-                    logger::warn("INI Config: {} Section: FadeTime not found: Using default deltas", section);
-                    goto SKIP_FADE_TIME;
-                }
-                // remove white space and parantheses
-                iniFadeTime = normalizeStr(iniFadeTime);
-                auto fadeTimeNeg=-1.0f; auto fadeTimePos=-1.0f;
-                // if there is a comma, use the first value as min and second as max
-                auto commaPos = iniFadeTime.find(",");
-                if (commaPos != std::string::npos) { // read in as (neg, pos)
-                    auto first = iniFadeTime.substr(0, commaPos);
-                    auto second = iniFadeTime.substr(commaPos+1);
-                    try { fadeTimeNeg = std::stof( first ); fadeTimePos = std::stof( second ); }
-                    catch (const std::exception& e) {
-                        logger::error("{}", e.what());
-                        logger::warn("INI Config: {} Section: Could not understand FadeTime '{}': Ignoring", section, iniFadeTime);
-                    }
-                } else { // single value, use for both neg and pos
-                    try { fadeTimeNeg = fadeTimePos = std::stof( iniFadeTime ); }
-                    catch (const std::exception& e) {
-                        logger::error("{}", e.what());
-                        logger::warn("INI Config: {} Section: Could not understand FadeTime '{}': Ignoring", section, iniFadeTime);
-                    }
-                }
-                if (fadeTimeNeg <= 0.0f || fadeTimePos <= 0.0f) goto SKIP_FADE_TIME; //negative value or zero is parse fail token, dont continue
-                // convert fade time seconds to delta percentage per tick (sleepTime ms per tick)
-                auto secsToTicks = [](float secs)->int { return static_cast<int>(round(secs*1000.0f/settings.sleepTime)); };
-                auto curveRange = abs(stat->startFraction - stat->endFraction); // the percentage (between 0 and 1) of the stat which we want to have a duration of fade time seconds
-                auto secsToDelta = [secsToTicks,curveRange](float secs)->float { return curveRange/secsToTicks(secs); };
-                maxDeltaNeg = secsToDelta(fadeTimeNeg); maxDeltaPos = secsToDelta(fadeTimePos);
-                logger::info("INI Config: {} Section: FadeTime '{}' parsed as {}s = MaxDeltaNeg: {:.4} and {}s = MaxDeltaPos: {:.4}", section, iniFadeTime, fadeTimeNeg, maxDeltaNeg, fadeTimePos, maxDeltaPos);
-
-
-            } SKIP_FADE_TIME: // label to skip the rest of the block if fade time could not be processed (to avoid having to handle useless cascading errors)
-            // use the legacy Min- and MaxDelta values as overrides if they are defined in the ini
-            auto iniMinDelta = iniStruct.get(section).get("MinDelta");
-            try { if (!iniMinDelta.empty()) {minDelta = std::stof( iniMinDelta );} }
-            catch (const std::exception& e) {
-                logger::error("{}", e.what());
-                logger::warn("INI Config: {} Section: Could not understand MinDelta '{}': Using default value", section, iniMinDelta);
-            }
-            auto iniMaxDelta = iniStruct.get(section).get("MaxDelta");
-            try {if (!iniMaxDelta.empty()) {maxDeltaPos = maxDeltaNeg = std::stof( iniMaxDelta );}} // default both neg and positive maxDelta to same value
-            catch (const std::exception& e) {
-                logger::error("{}", e.what());
-                logger::warn("INI Config: {} Section: Could not understand MaxDelta '{}': Using default value", section, iniMaxDelta);
-            }
-            auto iniMaxDeltaPos = iniStruct.get(section).get("MaxDeltaPos");
-            try {
-                if (!iniMaxDeltaPos.empty()) maxDeltaPos = std::stof( iniMaxDeltaPos );
-            } catch (const std::exception& e) {
-                logger::error("{}", e.what());
-                logger::warn("INI Config: {} Section: Could not understand MaxDeltaPos '{}': Using default value", section, iniMaxDeltaPos);
-            }
-            // update the actual values
-            stat->minDelta = minDelta; stat->maxDelta = maxDeltaNeg; stat->maxDeltaPos = maxDeltaPos;
-            // if maxDelta is less than zero, set it to default
-            if (stat->maxDelta <= 0.0f) {
-                logger::warn("INI Config: {} Section: MaxDelta '{:.4}' is less than 0: Using default value: {:.4}", section, stat->maxDelta, settings.defaultValues.maxDelta);
-                stat->maxDelta = settings.defaultValues.maxDelta;
-            }
-            // same with maxDelta pos
-            if (stat->maxDeltaPos <= 0.0f) {
-                logger::warn("INI Config: {} Section: MaxDeltaPos '{:.4}' is less than 0: Using default value: {:.4}", section, stat->maxDeltaPos, settings.defaultValues.maxDeltaPos);
-                stat->maxDeltaPos = settings.defaultValues.maxDeltaPos;
-            }
-            // set minDelta to slightly less than max if it is higher than max
-            if (stat->minDelta > std::min(stat->maxDelta, stat->maxDeltaPos)) {
-                logger::warn("INI Config: {} Section: MinDelta '{:.4}' is higher than MaxDelta '{:.4}': Setting MinDelta to .8 of MaxDelta", section, stat->minDelta, std::min(stat->maxDelta, stat->maxDeltaPos));
-                stat->minDelta = std::min(stat->maxDelta, stat->maxDeltaPos)*0.8f;
-
-            }
-            // if minDelta is less than 0, set it to 80% of maxDelta
-            if (stat->minDelta <= 0.0f) {
-                logger::warn("INI Config: {} Section: MinDelta '{:.4}' is less than 0: Setting MinDelta to .8 of MaxDelta", section, stat->minDelta);
-                stat->minDelta = stat->maxDelta*0.8f;
-            }
-            // log the final stats for this section
-            if (stat->enabled) logger::info("SETTINGS LOADED: [{}] EditorID:'{}' Tint:({:.2},{:.2},{:.2},{:.2}) Contrast:(x{:.2}+{:.2}) Brightness:(x{:.2}+{:.2}) Saturation:(x{:.2}+{:.2}) Range:({:.2},{:.2}) Curve:'{}' Delta:({:.4},-{:.4},+{:.4})", section, stat->editorID, stat->tint.red, stat->tint.green, stat->tint.blue, stat->tint.alpha, stat->contrastMult, stat->contrastAdd, stat->brightnessMult, stat->brightnessAdd, stat->saturationMult, stat->saturationAdd, stat->endFraction, stat->startFraction, easing::getStringEasingFunction(stat->easingFunction), stat->minDelta, stat->maxDelta, stat->maxDeltaPos);
-            else logger::info("SETTINGS LOADED: [{}] Disabled", section);
-        };
-        initOverlay(&(settings.health), "Health");
-        initOverlay(&(settings.magicka), "Magicka");
-        initOverlay(&(settings.stamina), "Stamina");
-        // log
-        logger::info("INI Config: ALL SETTINGS DONE LOADING FROM INI FILE");
-        logger::info("SETTINGS LOADED: [Global] SleepTime:'{}' Reload:'{}'", settings.sleepTime, settings.reload);
-
-
     } catch (const std::exception& e) {
         logger::error("{}", e.what());
         logger::error("Unresolvable error reading settings ini file (syntax issue?): Disabling all overlays");
         for (auto stat: settings.stats) { stat->enabled = false; }
+        ResetProfiles(settings, loading);
         return;
     }
 
 }
+// key arrays allocated here, always with room for timeline::maxKeys keys
+static std::unordered_set<const void*> ownedKeys;
+// resize an imod track's key array. Only reallocates when it needs more keys than the array has room for, so once a
+// track has been baked, reloads and profile switches just rewrite the keys in place
+template <class Data, class Key>
+Key* resizeKeys(Data *data, std::uint32_t count) {
+    std::uint32_t capacity = ownedKeys.contains(data->keys) ? static_cast<std::uint32_t>(timeline::maxKeys) : data->numKeys;
+    if (count > capacity) {
+        auto keys = RE::malloc<Key>(sizeof(Key) * timeline::maxKeys);
+        if (!keys) { return nullptr; }
+        if (data->keys) { ownedKeys.erase(data->keys); RE::free(data->keys); }
+        ownedKeys.insert(keys);
+        data->keys = keys;
+    }
+    data->numKeys = count;
+    data->type = RE::NiAnimationKey::KeyType::kLin;
+    data->keySize = sizeof(Key);
+    return static_cast<Key*>(data->keys);
+}
+// duration of each form before a baked profile set it to timeline::span, put back when a profile without keyframes is applied.
+// Recorded when initForms sizes the form's key arrays, so a profile switch only looks it up
+static std::unordered_map<const RE::TESImageSpaceModifier*, float> originalDurations;
+// game::Imod on an overlay's imod form and instance slots
+class GameImod : public game::Imod {
+public:
+    GameImod(RE::TESImageSpaceModifier **imod, RE::ImageSpaceModifierInstanceForm **instance) : imod(imod), instance(instance) {}
+    bool loaded() const override { return *imod != nullptr; }
+    bool live() const override { return *instance != nullptr; }
+    void trigger(float strength) override {
+        if (*instance) { RE::ImageSpaceModifierInstanceForm::Stop(*imod); *instance = nullptr; }
+        *instance = RE::ImageSpaceModifierInstanceForm::Trigger(*imod, strength, nullptr);
+    }
+    void drive(float age, float strength) override {
+        if (!*instance) { *instance = RE::ImageSpaceModifierInstanceForm::Trigger(*imod, 1.0f, nullptr); }
+        heldAge = age;
+        if (*instance) {
+            (*instance)->age = age;
+            (*instance)->strength = strength;
+        }
+    }
+    void hold() override {
+        if (*instance) { (*instance)->age = heldAge; }
+    }
+    void stop() override {
+        if (*instance && *imod) { RE::ImageSpaceModifierInstanceForm::Stop(*imod); }
+        *instance = nullptr;
+    }
+    // write the keys into the form's tint and cinematic tracks
+    void apply(const overlay::ImodParams &params) override {
+        auto form = *imod;
+        if (!form) { return; }
+        auto count = static_cast<std::uint32_t>(params.count);
+        // baked key times run 0 to timeline::span, so a duration of that maps instance age directly onto them
+        if (params.baked) {
+            form->data.duration = timeline::span;
+        } else if (auto original = originalDurations.find(form); original != originalDurations.end()) {
+            form->data.duration = original->second;
+        }
+        if (auto keys = resizeKeys<RE::NiColorData, RE::NiColorKey>(form->tintColor->colorData.get(), count)) {
+            for (int i = 0; i < params.count; i++) {
+                auto &tint = params.tint[i];
+                keys[i] = RE::NiColorKey(params.times[i], RE::NiColorA(tint.red, tint.green, tint.blue, tint.alpha));
+            }
+        }
+        // same order as overlay::Channel
+        RE::NiFloatInterpolator *channels[overlay::ChannelCount] = {form->cinematic.contrast.add, form->cinematic.contrast.mult,
+            form->cinematic.brightness.add, form->cinematic.brightness.mult, form->cinematic.saturation.add, form->cinematic.saturation.mult};
+        for (int c = 0; c < overlay::ChannelCount; c++) {
+            auto keys = resizeKeys<RE::NiFloatData, RE::NiFloatKey>(channels[c]->floatData.get(), count);
+            if (!keys) continue;
+            for (int i = 0; i < params.count; i++) { keys[i] = RE::NiFloatKey(params.times[i], params.cinematic[c][i]); }
+        }
+    }
+private:
+    RE::TESImageSpaceModifier **imod;
+    RE::ImageSpaceModifierInstanceForm **instance;
+    float heldAge = 0.0f;
+};
+
+static struct GameImods {
+    GameImod stamina{&imods.stamina, &imodInstances.stamina};
+    GameImod magicka{&imods.magicka, &imodInstances.magicka};
+    GameImod health{&imods.health, &imodInstances.health};
+} gameImods;
+
+// Imod forms, instances and game::Imods of a stat's tiered stages (see stages.h), one slot per stage. The slots are
+// fixed, so the GameImods pointing into them stay valid across reloads
+struct StageImods {
+    std::array<RE::TESImageSpaceModifier*, stages::maxStages> forms = {};
+    std::array<RE::ImageSpaceModifierInstanceForm*, stages::maxStages> instances = {};
+    std::vector<GameImod> slots;
+    std::array<game::Imod*, stages::maxStages> imods = {};
+    stages::Cursor cursor;
+    StageImods() {
+        slots.reserve(stages::maxStages);
+        for (std::size_t i = 0; i < stages::maxStages; i++) {
+            slots.emplace_back(&forms[i], &instances[i]);
+            imods[i] = &slots[i];
+        }
+    }
+    StageImods(const StageImods&) = delete;
+    StageImods& operator=(const StageImods&) = delete;
+    // stop every stage, so the next tick drives them all again
+    void stop() {
+        for (auto &imod: slots) { imod.stop(); }
+        cursor.reset();
+    }
+};
+
+static struct AllStageImods {
+    StageImods stamina;
+    StageImods magicka;
+    StageImods health;
+} stageImods;
+
+// switch to a compiled profile: write its looks into the imod forms and swap the active pointer. No file access,
+// no parsing, and no allocation (key arrays are sized for any profile in initForms). Main thread only
+void SwitchProfile(std::size_t index) {
+    if (index >= profiles.bank.size()) { return; }
+    auto profile = profiles.bank[index].get();
+    overlay::ApplyProfile(*profile, gameImods.stamina, gameImods.magicka, gameImods.health);
+    profiles.index = index;
+    profiles.active.store(profile, std::memory_order_release);
+    logger::info("Profile: Switched to '{}' ({}/{})", profile->name, index + 1, profiles.bank.size());
+}
+
+// take a reloaded bank and hotkey presses on the main thread. The old bank is freed on the way out, once active
+// points into the new one
+void TakeProfileRequests() {
+    Profiles::Bank retired;
+    if (auto index = profiles.take(retired)) { SwitchProfile(*index); }
+}
+
+// imod form named by an ini reference: a plugin-qualified FormID through the data handler, or an editor ID
+RE::TESImageSpaceModifier* LookupImod(std::string_view reference) {
+    if (auto formRef = parse::formRef(reference)) {
+        auto dataHandler = RE::TESDataHandler::GetSingleton();
+        return dataHandler ? dataHandler->LookupForm<RE::TESImageSpaceModifier>(formRef->localID, formRef->plugin) : nullptr;
+    }
+    return RE::TESForm::LookupByEditorID<RE::TESImageSpaceModifier>(reference);
+}
+
+// resolved imod forms, kept across reloads: an unchanged reference is never looked up again
+static forms::Cache<RE::TESImageSpaceModifier> imodForms;
+
 void initForms() { //MUST ONLY BE CALLED AFTER INIT SETTINGS
+    STATFX_TRACE_SPAN("init forms");
     // Load ImageSpaceModifier Forms
     logger::info("Loading Imod Forms");
     // auto defaultImod = RE::TESForm::LookupByEditorID<RE::TESImageSpaceModifier>("defaultDesaturateImod");
-    imods.stamina = RE::TESForm::LookupByEditorID<RE::TESImageSpaceModifier>(settings.stamina.editorID);
-    imods.magicka = RE::TESForm::LookupByEditorID<RE::TESImageSpaceModifier>(settings.magicka.editorID);
-    imods.health = RE::TESForm::LookupByEditorID<RE::TESImageSpaceModifier>(settings.health.editorID);
+    auto lookups = imodForms.lookups;
+    imods.stamina = imodForms.resolve(settings.stamina.editorID, LookupImod);
+    imods.magicka = imodForms.resolve(settings.magicka.editorID, LookupImod);
+    imods.health = imodForms.resolve(settings.health.editorID, LookupImod);
+    for (auto [imod, stat]: {std::pair{imods.stamina, &settings.stamina}, std::pair{imods.magicka, &settings.magicka}, std::pair{imods.health, &settings.health}}) {
+        if (!imod && stat->enabled) { logger::warn("Loading Imod Forms: No imagespace modifier found for '{}'", stat->editorID); }
+    }
+    // each stage's form, with its look written in once: stages are driven by a single key and don't change with the profile
+    for (auto [statStages, stageSlots]: {std::pair{&settings.staminaStages, &stageImods.stamina}, std::pair{&settings.magickaStages, &stageImods.magicka}, std::pair{&settings.healthStages, &stageImods.health}}) {
+        stageSlots->stop();
+        stageSlots->forms.fill(nullptr);
+        for (std::size_t i = 0; i < statStages->looks.size(); i++) {
+            auto &look = statStages->looks[i];
+            stageSlots->forms[i] = imodForms.resolve(look.editorID, LookupImod);
+            if (!stageSlots->forms[i]) {
+                logger::warn("Loading Imod Forms: No imagespace modifier found for stage '{}': Skipping it", look.editorID);
+                continue;
+            }
+            stageSlots->slots[i].apply(overlay::ComputeImodParams(look, timeline::Track()));
+        }
+    }
+    logger::info("Loading Imod Forms: {} looked up, the rest cached from an earlier load", imodForms.lookups - lookups);
     // for (auto imod: {imods.stamina, imods.magicka, imods.health}) { imod = defaultImod->CreateDuplicateForm(true,imod)->As<RE::TESImageSpaceModifier>(); }
-    // update imagespace modifier forms with values from settings
-    auto updateImod = [](RE::TESImageSpaceModifier *imod, Settings::OverlayData stat) {
-        if (imod) {
-            imod->tintColor->colorData->keys[0] = RE::NiColorKey(0.0f, stat.tint);
-            imod->cinematic.contrast.add->floatData->keys[0] = RE::NiFloatKey(0.0f, stat.contrastAdd);
-            imod->cinematic.contrast.mult->floatData->keys[0] = RE::NiFloatKey(0.0f, stat.contrastMult);
-            imod->cinematic.brightness.add->floatData->keys[0] = RE::NiFloatKey(0.0f, stat.brightnessAdd);
-            imod->cinematic.brightness.mult->floatData->keys[0] = RE::NiFloatKey(0.0f, stat.brightnessMult);
-            imod->cinematic.saturation.add->floatData->keys[0] = RE::NiFloatKey(0.0f, stat.saturationAdd);
-            imod->cinematic.saturation.mult->floatData->keys[0] = RE::NiFloatKey(0.0f, stat.saturationMult);
+    // bake the curve of every profile that uses keyframes, and give those imods key arrays big enough for any of them
+    for (auto &profile: loading.bank) {
+        for (auto [imod, stat, track]: {
+            std::tuple{imods.stamina, &profile->stamina, &profile->staminaTrack},
+            std::tuple{imods.magicka, &profile->magicka, &profile->magickaTrack},
+            std::tuple{imods.health, &profile->health, &profile->healthTrack}}) {
+            if (!imod || stat->keyframes < 2) continue;
+            *track = timeline::bake(stat->easingFunction, stat->keyframes);
+            originalDurations.try_emplace(imod, imod->data.duration);
+            logger::info("Loading Imod Forms: baking {} keyframes for '{}' in profile '{}' (max error vs curve: {:.4})", track->size(), stat->editorID, profile->name, timeline::maxError(*track, stat->easingFunction));
+            resizeKeys<RE::NiColorData, RE::NiColorKey>(imod->tintColor->colorData.get(), timeline::maxKeys);
+            for (auto interp: {imod->cinematic.contrast.add, imod->cinematic.contrast.mult, imod->cinematic.brightness.add,
+                imod->cinematic.brightness.mult, imod->cinematic.saturation.add, imod->cinematic.saturation.mult}) {
+                resizeKeys<RE::NiFloatData, RE::NiFloatKey>(interp->floatData.get(), timeline::maxKeys);
+            }
         }
-    };
-    logger::info("Loading Imod Forms: attempting to updateImods - Stamina");
-    updateImod(imods.stamina, settings.stamina);
-    logger::info("Loading Imod Forms: attempting to updateImods - Magicka");
-    updateImod(imods.magicka, settings.magicka);
-    logger::info("Loading Imod Forms: attempting to updateImods - Health");
-    updateImod(imods.health, settings.health);
+    }
+    // hand the bank to the main thread, which writes the starting profile's looks into the imod forms before its next tick
+    logger::info("Loading Imod Forms: {} profiles ready for the main thread", loading.bank.size());
+    profiles.offer(std::move(loading.bank), loading.index);
+    loading.bank.clear();
 }
 
 // ================================================================================================
@@ -509,10 +461,79 @@ float GetActorValue(RE::Actor* actor, RE::ActorValue value) {
     return baseValue + damageMod;
 }
 float GetPercentageAV(RE::Actor* actor, RE::ActorValue av) {
-    return std::max(std::min((GetActorValue(actor, av)/GetMaxActorValue(actor, av)),1.0f),0.0f);
+    auto maxValue = GetMaxActorValue(actor, av);
+    if (!(maxValue > 0.0f)) { return 1.0f; } // no pool of this stat at all (e.g. a follower with no magicka) reads as full
+    return std::max(std::min((GetActorValue(actor, av)/maxValue),1.0f),0.0f);
 }
 // ================================================================================================
 
+void SampleActor(actors::SampleBatch &batch, RE::Actor *actor) {
+    batch.push(GetPercentageAV(actor, RE::ActorValue::kHealth), GetPercentageAV(actor, RE::ActorValue::kStamina), GetPercentageAV(actor, RE::ActorValue::kMagicka));
+}
+
+// game::ActorValues on the player, their combat target and their followers
+class GameActorValues : public game::ActorValues {
+public:
+    void sample(actors::Target target, actors::SampleBatch &batch) override {
+        switch (target) {
+            case actors::Target::CombatTarget: {
+                auto combatTarget = player->GetActorRuntimeData().currentCombatTarget.get();
+                if (combatTarget && !combatTarget->IsDead()) { SampleActor(batch, combatTarget.get()); }
+                break;
+            }
+            case actors::Target::Followers: {
+                std::lock_guard guard(rosterLock);
+                for (auto &handle: roster) {
+                    auto actor = handle.get();
+                    if (actor && !actor->IsDead()) { SampleActor(batch, actor.get()); }
+                }
+                break;
+            }
+            default: SampleActor(batch, player);
+        }
+    }
+    // follower roster, gathered on the game thread (process lists are not safe to walk from the main thread)
+    std::mutex rosterLock;
+    std::vector<RE::ActorHandle> roster;
+    std::atomic<bool> rosterQueued = false;
+};
+
+static GameActorValues actorValues;
+
+// Actor sets the overlays can be bound to, sampled in one batched pass per set every tick
+static overlay::ActorSets actorSets;
+
+// a refresh of the follower roster, run on the game thread. Queued as one object over and over instead of a lambda
+// (which the task interface would wrap in a new task every time, on the overlay thread): Dispose leaves it be, and it
+// gathers into a list it keeps, swapped with the roster, so once both lists have grown to the follower count a
+// refresh allocates nothing on either thread
+class RosterTask : public SKSE::detail::TaskDelegate {
+public:
+    void Run() override {
+        gathered.clear();
+        if (auto processLists = RE::ProcessLists::GetSingleton()) {
+            for (auto &handle: processLists->highActorHandles) {
+                auto actor = handle.get();
+                if (actor && actor->IsPlayerTeammate() && !actor->IsDead()) { gathered.push_back(handle); }
+            }
+        }
+        std::lock_guard guard(actorValues.rosterLock);
+        actorValues.roster.swap(gathered);
+        actorValues.rosterQueued = false;
+    }
+    void Dispose() override {}
+private:
+    std::vector<RE::ActorHandle> gathered;
+};
+
+static RosterTask rosterTask;
+
+// queue a refresh of the follower roster on the game thread (only one at a time: the task object is shared)
+void RefreshFollowerRoster() {
+    if (actorValues.rosterQueued.exchange(true)) { return; }
+    SKSE::GetTaskInterface()->AddTask(&rosterTask);
+}
+
 void RunMainThread() {
     // short circuit if kill state
     if (state == State::Kill) {
@@ -526,6 +547,15 @@ void RunMainThread() {
             initSettings();
             initForms();
         }
+        // give every overlay a clean fault record with the new settings
+        for (auto cb: {&breakers.stamina, &breakers.magicka, &breakers.health}) { cb->reset(); }
+        // open or close the telemetry feed to match the settings
+        if (settings.telemetryFeed && !telemetryProducer.isOpen()) {
+            if (telemetryProducer.open(settings.telemetryName)) { logger::info("Starting Main Thread: Telemetry feed '{}' opened", settings.telemetryName); }
+            else { logger::warn("Starting Main Thread: Could not open telemetry feed '{}'", settings.telemetryName); }
+        } else if (!settings.telemetryFeed && telemetryProducer.isOpen()) {
+            telemetryProducer.close();
+        }
         // set player character
         player = RE::PlayerCharacter::GetSingleton();
         // log if error getting player
@@ -533,12 +563,11 @@ void RunMainThread() {
             logger::error("Player character not found");
             return;
         }
-        // initialize player resource percentages
-        s_actual.health = GetPercentageAV(player, RE::ActorValue::kHealth);
-        s_actual.stamina = GetPercentageAV(player, RE::ActorValue::kStamina);
-        s_actual.magicka = GetPercentageAV(player, RE::ActorValue::kMagicka);
-        // log current percentages
-        logger::info("Starting Main Thread: Health:{:.2f} Stamina:{:.2f} Magicka:{:.2f}", s_actual.health, s_actual.stamina, s_actual.magicka);
+        // read the player's situation for overlay conditions once, events keep it up to date from here
+        PlayerStateEvents::GetSingleton()->Refresh();
+        // the bound actors' resource percentages are read by the main thread when it starts running (followers are
+        // sampled once the roster comes in)
+        RefreshFollowerRoster();
         // imodInstances.stamina = RE::ImageSpaceModifierInstanceForm::Trigger(imods.stamina, 0.0f, nullptr);
         // imodInstances.magicka = RE::ImageSpaceModifierInstanceForm::Trigger(imods.magicka, 0.0f, nullptr);
         // imodInstances.health = RE::ImageSpaceModifierInstanceForm::Trigger(imods.health, 0.0f, nullptr);
@@ -562,88 +591,273 @@ void OnNewGame() {
     RunMainThread();
 }
 
+// fade an overlay out over its ReleaseTime once its conditions stop holding, then release its imod. Takes copies of
+// what it needs from the overlay's settings, since the profile can switch while it runs
+sequence::Task ReleaseOverlay(sequence::Executor &sequences, game::Imod &imod, float *emitted, float from, float age, bool baked, int releaseTime) {
+    auto start = sequences.now();
+    for (std::uint64_t elapsed = 0; elapsed < static_cast<std::uint64_t>(releaseTime); elapsed = sequences.now() - start) {
+        float fade = 1.0f - static_cast<float>(elapsed) / releaseTime;
+        if (baked) { imod.drive(age, fade); }
+        else { imod.trigger(from * fade); }
+        *emitted = from * fade;
+        co_await sequences.nextTick();
+    }
+    imod.stop();
+    *emitted = 0.0f;
+}
+
 void MainThread() {
+    trace::NameThread("Overlay thread");
     auto state_current = state;
     // "current" stat percentages. Used to check for changes and adjusted according to configured min and max deltas
     Stats s_current = {s_actual.health, s_actual.stamina, s_actual.magicka};
+    // last imod strength emitted for each stat, for the telemetry feed
+    Stats s_emitted = {0.0f, 0.0f, 0.0f};
+    std::uint64_t tickCount = 0;
+    // timed sequences on this thread (see sequence.h), one owner per stat. Ended when the thread pauses
+    sequence::Executor sequences;
     logger::info("Main thread initialized. State:{} Health:{:.2f} Stamina:{:.2f} Magicka:{:.2f}", (int)state_current, s_current.health, s_current.stamina, s_current.magicka);
-    // define lambda for maxDelta approach for updating current stat percentages
-    auto approach = [](float current, float actual, float maxDeltaNeg, float maxDeltaPos)->float {
-        if (current < actual) {
-            if (actual - current > maxDeltaPos) { return current + maxDeltaPos; }
-            else { return actual; }
-        }
-        else {
-            if (current - actual > maxDeltaNeg) { return current - maxDeltaNeg; }
-            else { return actual; }
-        }
-    };
-    // convert 0 to 1 value percentage into 1 to 0 image modifier strength
-    auto easedValue = [](float value, float start, float end, easing::easingFunction easeF) -> float {
-        // return 0 when value is higher than start, and 1 when value is lower than end
-        if (value > start) { return static_cast<float>(easeF(0.0f)); }
-        if (value < end) { return static_cast<float>(easeF(1.0f)); }
-        // apply easing function backwards between start and end
-        auto range = start - end;
-        return static_cast<float>(easeF(((-value+end)/range)+1));
+    // run one overlay's tick behind its circuit breaker: a fault backs off or disables only that overlay
+    auto guardedTick = [&tickCount](const char *name, breaker::CircuitBreaker *cb, rate_limited::Limiter *faultLog, game::Imod &imod, StageImods &stageSlots, auto &&runTick) {
+            if (!cb->allow(tickCount)) { return; }
+            STATFX_TRACE_SPAN(name);
+            try {
+                runTick();
+                cb->success(settings.faults);
+            } catch (const std::exception& e) {
+                if (cb->failure(tickCount, settings.faults)) {
+                    logger::error("Main thread: {} overlay fault ({}): Fault budget of {} used up, disabling it until the next reload", name, e.what(), settings.faults.budget);
+                    imod.stop();
+                    stageSlots.stop();
+                } else {
+                    rate_limited::warn(*faultLog, "Main thread: {} overlay fault ({}): Backing off for {} ticks ({}/{} faults)", name, e.what(), cb->backoff, cb->faults, settings.faults.budget);
+                }
+            }
     };
-    // define tick function for each stat
-    auto tick = [approach,easedValue](float *current, float *actual,
-        RE::ActorValue avEnum,
-        Settings::OverlayData statOverlayData,
-        RE::ImageSpaceModifierInstanceForm **imodInstance,
-        RE::TESImageSpaceModifier **imod) {
-            // update the actual resource percentage
-            *actual = GetPercentageAV(player, avEnum);
-            // short circuit if the change is less than minDelta
-            if (std::abs(*current - *actual) < statOverlayData.minDelta) { return; }
-            // update current resource percentage to approach the actual resource percentage using configured deltas
-            *current = approach(*current, *actual, statOverlayData.maxDelta, statOverlayData.maxDeltaPos);
-            // update image space modifiers
-            if (*imodInstance) { RE::ImageSpaceModifierInstanceForm::Stop(*imod); *imodInstance = nullptr; }
-            *imodInstance = RE::ImageSpaceModifierInstanceForm::Trigger(*imod, easedValue(*current,statOverlayData.startFraction,statOverlayData.endFraction,statOverlayData.easingFunction), nullptr);
+    // faults outside any overlay (sampling, the loop itself). Only when this budget is used up does the plugin shut down
+    breaker::CircuitBreaker samplingBreaker, loopBreaker;
+    rate_limited::Limiter samplingLog, loopLog;
+    // when the follower roster was last refreshed (ms on the schedule clock)
+    std::uint64_t rosterRefreshedAt = 0;
+    // profile the overlays were last ticked with
+    const Profile *lastProfile = nullptr;
+    // each overlay updates on its own UpdateInterval: the loop sleeps until the next one is due, then runs only those
+    timerwheel::Wheel schedule(actors::StatCount);
+    timerwheel::Stats scheduleStats;
+    std::array<bool, actors::StatCount> due = {};
+    const auto clockStart = std::chrono::steady_clock::now();
+    auto elapsedMs = [clockStart]() { return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - clockStart).count()); };
+    // (re)start every enabled overlay's schedule now
+    auto armAll = [&schedule](const Profile *profile, std::uint64_t now) {
+        for (auto [which, stat]: {std::pair{actors::Health, &profile->health}, std::pair{actors::Stamina, &profile->stamina}, std::pair{actors::Magicka, &profile->magicka}}) {
+            if (stat->enabled) { schedule.schedule(which, now); }
+            else { schedule.cancel(which); }
+        }
     };
     // main loop
-    try{
-        while (state != State::Kill) {
+    while (state != State::Kill) {
+        try {
+            if (state == State::Run && (playerState.load() & conditions::InMenu)) {
+                // a menu that pauses the game is open: park until it closes (or the state changes)
+                logger::debug("Main thread: Parked while a menu is open");
+                playerState.waitWhile(conditions::InMenu, []() { return state == State::Run; });
+                logger::debug("Main thread: Unparked");
+                lastProfile = nullptr; // the game was paused: restart the schedule instead of counting it as late
+                continue;
+            }
             if (state == State::Run) {
                 // state is RUN
+                STATFX_TRACE_SPAN("loop");
+                // a reloaded profile bank or profile hotkey presses, taken between ticks
+                TakeProfileRequests();
                 if (state_current != State::Run) { // log state change from pause to run
-                    logger::info("Main thread: Running");
+                    // initialize resource percentages of the bound actors with the active profile
+                    actorSets.sample(actorValues, true, true, false);
+                    auto profile = profiles.active.load(std::memory_order_acquire);
+                    s_actual.health = actorSets.value(profile->health, actors::Health);
+                    s_actual.stamina = actorSets.value(profile->stamina, actors::Stamina);
+                    s_actual.magicka = actorSets.value(profile->magicka, actors::Magicka);
+                    logger::info("Main thread: Running: Health:{:.2f} Stamina:{:.2f} Magicka:{:.2f}", s_actual.health, s_actual.stamina, s_actual.magicka);
                     state_current = State::Run;
+                    lastProfile = nullptr; // restarts every overlay's schedule
+                    for (auto noise: {&filters.stamina, &filters.magicka, &filters.health}) { noise->reset(); }
+                    for (auto lead: {&predictors.stamina, &predictors.magicka, &predictors.health}) { lead->reset(); }
+                    // pick up the overlay state saved with the game that was just loaded, if there was one
+                    std::optional<persistence::Snapshot> restored;
+                    {
+                        std::lock_guard guard(savedState.lock);
+                        restored.swap(savedState.restored);
+                    }
+                    if (restored) {
+                        for (auto [which, current, osc, emitted]: {
+                            std::tuple{actors::Health, &s_current.health, &oscillators.health, &s_emitted.health},
+                            std::tuple{actors::Stamina, &s_current.stamina, &oscillators.stamina, &s_emitted.stamina},
+                            std::tuple{actors::Magicka, &s_current.magicka, &oscillators.magicka, &s_emitted.magicka}}) {
+                            *current = restored->overlays[which].current;
+                            osc->phase = restored->overlays[which].phase;
+                            *emitted = restored->overlays[which].emitted;
+                        }
+                        logger::info("Main thread: Restored overlay state from the save: Health:{:.2f} Stamina:{:.2f} Magicka:{:.2f}", s_current.health, s_current.stamina, s_current.magicka);
+                    }
                 }
-                try {
-                    // process tick for each stat: update values and image modifiers according to configured deltas
-                    if (settings.health.enabled) tick(&s_current.health, &s_actual.health, RE::ActorValue::kHealth, settings.health, &imodInstances.health, &imods.health);
-                    if (settings.stamina.enabled) tick(&s_current.stamina, &s_actual.stamina, RE::ActorValue::kStamina, settings.stamina, &imodInstances.stamina, &imods.stamina);
-                    if (settings.magicka.enabled) tick(&s_current.magicka, &s_actual.magicka, RE::ActorValue::kMagicka, settings.magicka, &imodInstances.magicka, &imods.magicka);
-                } catch (const std::exception& e) {
-                    logger::error("{}", e.what());
-                    logger::error("Main thread exception: Pausing for 5 seconds");
-                    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+                // ticks count SleepTime periods (fault backoff and forgiveness are in those), whichever overlays ran
+                auto now = elapsedMs();
+                tickCount = now / static_cast<std::uint64_t>(std::max(settings.sleepTime, 1));
+                // overlay settings come from the active profile. After a switch, clear overlays the new profile turns off
+                // and restart the schedule on the new profile's intervals
+                auto profile = profiles.active.load(std::memory_order_acquire);
+                if (profile != lastProfile) {
+                    for (auto [which, stat, imod, stageSlots]: {
+                        std::tuple{actors::Health, &profile->health, &gameImods.health, &stageImods.health},
+                        std::tuple{actors::Stamina, &profile->stamina, &gameImods.stamina, &stageImods.stamina},
+                        std::tuple{actors::Magicka, &profile->magicka, &gameImods.magicka, &stageImods.magicka}}) {
+                        if (!stat->enabled) { sequences.cancel(which); imod->stop(); stageSlots->stop(); }
+                    }
+                    armAll(profile, now);
+                    lastProfile = profile;
                 }
+                // resume the sequences whose waits are over
+                sequences.tick(now);
+                // overlays that came due since the last wake
+                due.fill(false);
+                schedule.advance(now, [&](std::size_t which) {
+                    due[which] = true;
+                    scheduleStats.record(schedule.deadline(which), now);
+                });
+                bool anyDue = due[actors::Health] || due[actors::Stamina] || due[actors::Magicka];
+                if (anyDue) { scheduleStats.wakeups++; }
+                for (auto [which, stat]: {std::pair{actors::Health, &profile->health}, std::pair{actors::Stamina, &profile->stamina}, std::pair{actors::Magicka, &profile->magicka}}) {
+                    if (due[which]) { schedule.schedule(which, timerwheel::periodic(schedule.deadline(which), stat->updateInterval, now)); }
+                }
+                // overlays whose conditions don't hold right now release their imod (fading it out over their ReleaseTime),
+                // and are neither sampled nor ticked
+                auto situation = playerState.load();
+                auto gatedOff = [situation, &sequences](actors::Stat which, const Settings::OverlayData &stat, game::Imod &imod, StageImods &stageSlots, float current, float *emitted) {
+                    if (stat.condition.allows(situation)) {
+                        // conditions hold again: a release still fading hands the imod back to the tick
+                        if (sequences.cancel(which)) { imod.stop(); }
+                        return false;
+                    }
+                    stageSlots.stop();
+                    if (sequences.running(which)) { return true; }
+                    if (stat.releaseTime > 0 && imod.live()) {
+                        auto age = timeline::age(current, stat.startFraction, stat.endFraction);
+                        sequences.spawn(which, ReleaseOverlay(sequences, imod, emitted, *emitted, age, stat.keyframes > 1, stat.releaseTime));
+                    } else {
+                        imod.stop();
+                        *emitted = 0.0f;
+                    }
+                    return true;
+                };
+                // what every overlay's Intensity formula can read besides its own stat
+                expr::Vars shared = {};
+                expr::setShared(shared, s_current.health, s_current.stamina, s_current.magicka, situation);
+                bool runHealth = due[actors::Health] && profile->health.enabled && !gatedOff(actors::Health, profile->health, gameImods.health, stageImods.health, s_current.health, &s_emitted.health);
+                bool runStamina = due[actors::Stamina] && profile->stamina.enabled && !gatedOff(actors::Stamina, profile->stamina, gameImods.stamina, stageImods.stamina, s_current.stamina, &s_emitted.stamina);
+                bool runMagicka = due[actors::Magicka] && profile->magicka.enabled && !gatedOff(actors::Magicka, profile->magicka, gameImods.magicka, stageImods.magicka, s_current.magicka, &s_emitted.magicka);
+                // sample every actor set the due overlays are bound to in one pass, refreshing the follower roster about once a second
+                if (samplingBreaker.allow(tickCount) && (runHealth || runStamina || runMagicka)) {
+                    try {
+                        auto wanted = overlay::Wanted({{&profile->stamina, runStamina}, {&profile->magicka, runMagicka}, {&profile->health, runHealth}});
+                        if (wanted.followers && now - rosterRefreshedAt >= 1000) { rosterRefreshedAt = now; RefreshFollowerRoster(); }
+                        actorSets.sample(actorValues, wanted.player, wanted.combatTarget, wanted.followers);
+                        samplingBreaker.success(settings.faults);
+                    } catch (const std::exception& e) {
+                        samplingBreaker.failure(tickCount, settings.faults);
+                        samplingBreaker.tripped = false; // sampling is never disabled, it only backs off
+                        rate_limited::error(samplingLog, "Main thread: sampling actor stats failed ({}): Backing off for {} ticks", e.what(), samplingBreaker.backoff);
+                    }
+                }
+                // process tick for each stat: update values and image modifiers according to configured deltas
+                if (runHealth) guardedTick("Health", &breakers.health, &faultLogs.health, gameImods.health, stageImods.health, [&]() {
+                    overlay::Tick(&s_current.health, &s_actual.health, actors::Health, profile->health, actorSets, shared, gameImods.health, &oscillators.health, &filters.health, &predictors.health, &lifecycles.health, &s_emitted.health, profile->health.updateInterval / 1000.0f);
+                    overlay::TickStages(s_current.health, settings.healthStages, &stageImods.health.cursor, stageImods.health.imods);
+                });
+                if (runStamina) guardedTick("Stamina", &breakers.stamina, &faultLogs.stamina, gameImods.stamina, stageImods.stamina, [&]() {
+                    overlay::Tick(&s_current.stamina, &s_actual.stamina, actors::Stamina, profile->stamina, actorSets, shared, gameImods.stamina, &oscillators.stamina, &filters.stamina, &predictors.stamina, &lifecycles.stamina, &s_emitted.stamina, profile->stamina.updateInterval / 1000.0f);
+                    overlay::TickStages(s_current.stamina, settings.staminaStages, &stageImods.stamina.cursor, stageImods.stamina.imods);
+                });
+                if (runMagicka) guardedTick("Magicka", &breakers.magicka, &faultLogs.magicka, gameImods.magicka, stageImods.magicka, [&]() {
+                    overlay::Tick(&s_current.magicka, &s_actual.magicka, actors::Magicka, profile->magicka, actorSets, shared, gameImods.magicka, &oscillators.magicka, &filters.magicka, &predictors.magicka, &lifecycles.magicka, &s_emitted.magicka, profile->magicka.updateInterval / 1000.0f);
+                    overlay::TickStages(s_current.magicka, settings.magickaStages, &stageImods.magicka.cursor, stageImods.magicka.imods);
+                });
+                // publish this tick to the telemetry feed (wait-free, never blocks on readers)
+                if (anyDue && telemetryProducer.isOpen()) {
+                    telemetry::Record record;
+                    record.timestampNs = telemetry::nowNs();
+                    record.tick = tickCount;
+                    for (auto [dest, stats]: {std::pair{record.actual, &s_actual}, std::pair{record.current, &s_current}, std::pair{record.intensity, &s_emitted}}) {
+                        dest[actors::Health] = stats->health;
+                        dest[actors::Stamina] = stats->stamina;
+                        dest[actors::Magicka] = stats->magicka;
+                    }
+                    telemetryProducer.publish(record);
+                }
+                // keep the state the save callback writes up to date
+                {
+                    std::lock_guard guard(savedState.lock);
+                    auto &live = savedState.live.overlays;
+                    live[actors::Health] = {s_current.health, oscillators.health.phase, s_emitted.health};
+                    live[actors::Stamina] = {s_current.stamina, oscillators.stamina.phase, s_emitted.stamina};
+                    live[actors::Magicka] = {s_current.magicka, oscillators.magicka.phase, s_emitted.magicka};
+                }
+                loopBreaker.success(settings.faults);
             } else {
                 // state is PAUSE
                 if (state_current != State::Pause) { // log state change from run to pause
-                    logger::info("Main thread: Paused");
-                    for (auto [imod,instance]: imodAndInstance) { // stop active image space modifiers
-                        if (*instance) { RE::ImageSpaceModifierInstanceForm::Stop(*imod); instance = nullptr; }
-                    }
+                    logger::info("Main thread: Paused ({} wakeups for {} overlay updates, {:.2f} ms late on average, {} ms at most)", scheduleStats.wakeups, scheduleStats.fired, scheduleStats.averageLateMs(), scheduleStats.maxLateMs);
+                    scheduleStats = timerwheel::Stats();
+                    sequences.cancelAll(); // releases still fading end here, their imods are stopped below
+                    for (auto imod: {&gameImods.stamina, &gameImods.magicka, &gameImods.health}) { imod->stop(); } // stop active image space modifiers
+                    for (auto stageSlots: {&stageImods.stamina, &stageImods.magicka, &stageImods.health}) { stageSlots->stop(); }
 
                     state_current = State::Pause;
 
                 }
             }
+        } catch (const std::exception& e) {
+            if (loopBreaker.failure(tickCount, settings.faults)) {
+                logger::error("Main thread exception ({}): Fault budget used up, disabling plugin", e.what());
+                state = State::Kill;
+                break;
+            }
+            rate_limited::error(loopLog, "Main thread exception ({}): Backing off for {} ticks", e.what(), loopBreaker.backoff);
+            std::this_thread::sleep_for(std::chrono::milliseconds(settings.sleepTime * loopBreaker.backoff));
+        }
+        // running: sleep until the next overlay is due (a pause or new game wakes it early). Otherwise poll every SleepTime
+        auto next = std::min(schedule.nextDeadline(), sequences.nextDeadline());
+        if (state == State::Run && next != timerwheel::never) {
+            playerState.sleepUntil(clockStart + std::chrono::milliseconds(next), []() { return state == State::Run; });
+        } else {
             std::this_thread::sleep_for(std::chrono::milliseconds(settings.sleepTime));
         }
-    } catch(const std::exception& e) {
-        logger::error("{}", e.what());
-        logger::error("Main thread exception: Disabling plugin");
-        state = State::Kill;
     }
     logger::info("Main thread stopped: Kill state");
 }
 
+// Keyboard hotkeys: cycling through the compiled profiles, and starting/stopping the tracer
+class Hotkeys : public RE::BSTEventSink<RE::InputEvent*> {
+public:
+    static Hotkeys* GetSingleton() {
+        static Hotkeys singleton;
+        return &singleton;
+    }
+    RE::BSEventNotifyControl ProcessEvent(RE::InputEvent* const* events, RE::BSTEventSource<RE::InputEvent*>*) override {
+        if (!events || (settings.profileHotkey == 0 && settings.traceHotkey == 0)) { return RE::BSEventNotifyControl::kContinue; }
+        for (auto event = *events; event; event = event->next) {
+            auto button = event->AsButtonEvent();
+            if (!button || button->GetDevice() != RE::INPUT_DEVICE::kKeyboard || !button->IsDown()) continue;
+            auto code = button->GetIDCode();
+            // the main thread switches on its next tick (see TakeProfileRequests): this thread never touches the bank
+            if (settings.profileHotkey != 0 && code == static_cast<std::uint32_t>(settings.profileHotkey) && state == State::Run) {
+                profiles.cycles.fetch_add(1, std::memory_order_relaxed);
+            }
+            if (settings.traceHotkey != 0 && code == static_cast<std::uint32_t>(settings.traceHotkey)) { ToggleTrace(); }
+        }
+        return RE::BSEventNotifyControl::kContinue;
+    }
+};
+
 // On Data Loaded Callback
 void OnDataLoaded() {
     // Load settings
@@ -652,6 +866,10 @@ void OnDataLoaded() {
     initForms();
     // start main thread, intially paused
     main_thread = std::thread(MainThread);
+    // listen for the profile and trace hotkeys
+    if (auto input = RE::BSInputDeviceManager::GetSingleton()) { input->AddEventSink(Hotkeys::GetSingleton()); }
+    // listen for the player situation events behind overlay conditions
+    PlayerStateEvents::GetSingleton()->Register();
 
     logger::info("SKSE OnDataLoaded Completed");
 }
@@ -659,6 +877,61 @@ void OnDataLoaded() {
 // On Preload Game, make sure to pause thread
 void OnPreloadGame() {
     state = State::Pause;
+    playerState.wake(); // in case the main thread is parked on a menu or sleeping until the next update
+}
+
+// SKSE co-save adapters for the persistence serializer
+class CoSaveWriter : public persistence::Writer {
+public:
+    explicit CoSaveWriter(SKSE::SerializationInterface *intfc) : intfc(intfc) {}
+    bool write(const void *data, std::uint32_t size) override { return intfc->WriteRecordData(data, size); }
+private:
+    SKSE::SerializationInterface *intfc;
+};
+
+class CoSaveReader : public persistence::Reader {
+public:
+    explicit CoSaveReader(SKSE::SerializationInterface *intfc) : intfc(intfc) {}
+    bool read(void *data, std::uint32_t size) override { return intfc->ReadRecordData(data, size) == size; }
+private:
+    SKSE::SerializationInterface *intfc;
+};
+
+// On Save Callback: write the smoothed overlay state into the co-save
+void OnSave(SKSE::SerializationInterface *intfc) {
+    persistence::Snapshot snapshot;
+    {
+        std::lock_guard guard(savedState.lock);
+        snapshot = savedState.live;
+    }
+    if (!intfc->OpenRecord(persistence::recordType, persistence::version)) {
+        logger::error("Co-save: Could not open record to save overlay state");
+        return;
+    }
+    CoSaveWriter writer(intfc);
+    if (!persistence::save(writer, snapshot)) { logger::error("Co-save: Could not write overlay state"); }
+}
+
+// On Load Callback: read the overlay state back, the main thread applies it before its first tick
+void OnLoad(SKSE::SerializationInterface *intfc) {
+    std::uint32_t type, version, length;
+    while (intfc->GetNextRecordInfo(type, version, length)) {
+        if (type != persistence::recordType) continue;
+        CoSaveReader reader(intfc);
+        auto snapshot = persistence::load(reader, version);
+        if (!snapshot) {
+            logger::warn("Co-save: Could not read overlay state (record version {}, {} bytes): Starting from the current stats", version, length);
+            continue;
+        }
+        std::lock_guard guard(savedState.lock);
+        savedState.restored = snapshot;
+    }
+}
+
+// On Revert Callback: forget any state restored from a previous save (new game, or loading a save without it)
+void OnRevert(SKSE::SerializationInterface *) {
+    std::lock_guard guard(savedState.lock);
+    savedState.restored.reset();
 }
 
 // On Message Callback
@@ -679,6 +952,23 @@ void OnMessage(SKSE::MessagingInterface::Message* msg) {
     }
 }
 
+// Plugin API requests (see statfxapi.h), from any plugin. Answered while the request is dispatched
+void OnApiMessage(SKSE::MessagingInterface::Message* msg) {
+    if (!msg || msg->type != StatFXAPI::RequestInterface) { return; }
+    auto sender = msg->sender ? msg->sender : "unknown plugin";
+    if (!msg->data || msg->dataLen < sizeof(StatFXAPI::InterfaceRequest)) {
+        logger::warn("API: Malformed interface request from '{}' ({} bytes): Ignoring", sender, msg->dataLen);
+        return;
+    }
+    auto request = static_cast<StatFXAPI::InterfaceRequest*>(msg->data);
+    if (request->version != StatFXAPI::Version::V1) {
+        logger::warn("API: '{}' asked for interface version {}, this StatFX has version 1: Not answering", sender, static_cast<std::uint32_t>(request->version));
+        return;
+    }
+    request->api = &sources::api;
+    logger::info("API: Handed interface version 1 to '{}'", sender);
+}
+
 SKSEPluginLoad(const SKSE::LoadInterface *skse) {
     SKSE::Init(skse);
     // Setup logging (e.g. using spdlog)
@@ -686,6 +976,14 @@ SKSEPluginLoad(const SKSE::LoadInterface *skse) {
     ///
     // register onMessage
     if (state!=State::Kill) {SKSE::GetMessagingInterface()->RegisterListener(OnMessage);}
+    // and the plugin API, for every other plugin
+    if (state!=State::Kill) {SKSE::GetMessagingInterface()->RegisterListener(nullptr, OnApiMessage);}
+    // register co-save callbacks for the smoothed overlay state
+    auto serialization = SKSE::GetSerializationInterface();
+    serialization->SetUniqueID(persistence::uniqueID);
+    serialization->SetSaveCallback(OnSave);
+    serialization->SetLoadCallback(OnLoad);
+    serialization->SetRevertCallback(OnRevert);
     ///
     logger::info("SKSE Plugin Load Completed");
     return true;
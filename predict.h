@@ -0,0 +1,65 @@
+/* Predictive extrapolation of an overlay's sampled stat, between the noise filter and the delta smoothing.
+ * ----------
+ * A stat is only sampled once per update, and the smoothing then chases that sample, so during a steady drain (a
+ * sprint, a channelled spell) the effect trails the HUD by about an update plus the smoothing. The predictor fits the
+ * stat's rate over the last few samples (least squares, per update) and hands the smoothing the value the stat should
+ * reach lead updates from now instead, so the effect moves with the stat rather than after it. The prediction is held
+ * within limit of the sample and within 0 to 1, and starts over (no prediction until there's a new trend) on a step
+ * against the trend bigger than reversal, or any step bigger than limit (a hit, a potion).
+ *
+ * usage:
+ * predict::Predictor health;
+ * float target = health.step(settings.health.predict, filtered);
+*/
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace predict
+{
+    // samples the rate is fitted over
+    constexpr int window = 4;
+
+    struct Settings {
+        float lead = 0.0f;       // updates ahead to extrapolate to (0 = off)
+        float limit = 0.05f;     // furthest the prediction may be from the sample, fraction of the stat
+        float reversal = 0.005f; // a step this big against the trend drops the prediction
+    };
+
+    struct Predictor {
+        std::array<float, window> samples = {}; // oldest first
+        int count = 0;
+
+        // the stat lead updates from now, given this update's sample
+        float step(const Settings &settings, float sample) {
+            if (settings.lead <= 0.0f) { return sample; }
+            if (count > 0) {
+                float last = samples[count - 1];
+                float change = sample - last;
+                float trend = count > 1 ? rate() : 0.0f;
+                if (std::abs(change) > settings.limit || (trend * change < 0.0f && std::abs(change) > settings.reversal)) { count = 0; }
+            }
+            if (count == window) { std::shift_left(samples.begin(), samples.end(), 1); count--; }
+            samples[count++] = sample;
+            if (count < 2) { return sample; }
+            float ahead = std::clamp(rate() * settings.lead, -settings.limit, settings.limit);
+            return std::clamp(sample + ahead, 0.0f, 1.0f);
+        }
+
+        // least squares slope of the samples, stat per update
+        float rate() const {
+            float meanX = (count - 1) * 0.5f, meanY = 0.0f;
+            for (int i = 0; i < count; i++) { meanY += samples[i]; }
+            meanY /= count;
+            float covariance = 0.0f, variance = 0.0f;
+            for (int i = 0; i < count; i++) {
+                covariance += (i - meanX) * (samples[i] - meanY);
+                variance += (i - meanX) * (i - meanX);
+            }
+            return covariance / variance;
+        }
+
+        void reset() { *this = Predictor(); }
+    };
+}
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include "preview.h"
+#include "overlay.h"
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define STATFX_PREVIEW_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define STATFX_PREVIEW_SSE
+#endif
+
+namespace preview
+{
+    namespace
+    {
+        // one lane type per vector unit, all with the same arithmetic, so every path evaluates the exact same
+        // expression (and gives the same result as the scalar reference, as long as the build doesn't fuse into FMA)
+        struct F32x1 {
+            static constexpr std::size_t width = 1;
+            float v;
+            static F32x1 splat(float f) { return {f}; }
+            static F32x1 load(const float *p) { return {*p}; }
+            void store(float *p) const { *p = v; }
+            friend F32x1 operator+(F32x1 a, F32x1 b) { return {a.v + b.v}; }
+            friend F32x1 operator-(F32x1 a, F32x1 b) { return {a.v - b.v}; }
+            friend F32x1 operator*(F32x1 a, F32x1 b) { return {a.v * b.v}; }
+        };
+#if defined(STATFX_PREVIEW_AVX2)
+        struct F32x8 {
+            static constexpr std::size_t width = 8;
+            __m256 v;
+            static F32x8 splat(float f) { return {_mm256_set1_ps(f)}; }
+            static F32x8 load(const float *p) { return {_mm256_loadu_ps(p)}; }
+            void store(float *p) const { _mm256_storeu_ps(p, v); }
+            friend F32x8 operator+(F32x8 a, F32x8 b) { return {_mm256_add_ps(a.v, b.v)}; }
+            friend F32x8 operator-(F32x8 a, F32x8 b) { return {_mm256_sub_ps(a.v, b.v)}; }
+            friend F32x8 operator*(F32x8 a, F32x8 b) { return {_mm256_mul_ps(a.v, b.v)}; }
+        };
+        using Wide = F32x8;
+#elif defined(STATFX_PREVIEW_SSE)
+        struct F32x4 {
+            static constexpr std::size_t width = 4;
+            __m128 v;
+            static F32x4 splat(float f) { return {_mm_set1_ps(f)}; }
+            static F32x4 load(const float *p) { return {_mm_loadu_ps(p)}; }
+            void store(float *p) const { _mm_storeu_ps(p, v); }
+            friend F32x4 operator+(F32x4 a, F32x4 b) { return {_mm_add_ps(a.v, b.v)}; }
+            friend F32x4 operator-(F32x4 a, F32x4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+            friend F32x4 operator*(F32x4 a, F32x4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+        };
+        using Wide = F32x4;
+#else
+        using Wide = F32x1;
+#endif
+
+        // grade whole blocks of V::width pixels starting at first. Returns where it stopped (the tail is left over)
+        template <class V>
+        std::size_t gradeBlocks(const Grade &grade, const std::array<const float*, PlaneCount> &in, const std::array<float*, PlaneCount> &out, std::size_t first, std::size_t count) {
+            const V wr = V::splat(0.2125f), wg = V::splat(0.7154f), wb = V::splat(0.0721f), half = V::splat(0.5f);
+            const V saturation = V::splat(grade.saturation), brightness = V::splat(grade.brightness), contrast = V::splat(grade.contrast);
+            const V tintAlpha = V::splat(grade.tint.alpha);
+            const std::array<V, PlaneCount> tint = {V::splat(grade.tint.red), V::splat(grade.tint.green), V::splat(grade.tint.blue)};
+            std::size_t i = first;
+            for (; i + V::width <= count; i += V::width) {
+                std::array<V, PlaneCount> c = {V::load(in[Red] + i), V::load(in[Green] + i), V::load(in[Blue] + i)};
+                V grey = wr * c[Red] + wg * c[Green] + wb * c[Blue];
+                for (int p = 0; p < PlaneCount; p++) {
+                    V v = grey + (c[p] - grey) * saturation;
+                    v = v + (tint[p] * grey - v) * tintAlpha;
+                    v = half + (v * brightness - half) * contrast;
+                    v.store(out[p] + i);
+                }
+            }
+            return i;
+        }
+    }
+
+    Grade GradeFor(const Settings::OverlayData &stat, float intensity) {
+        // neutral base of 1, times the faded in Mult, plus the faded in Add
+        auto fade = [intensity](float mult, float add) { return (1.0f + (mult - 1.0f) * intensity) + add * intensity; };
+        Grade grade;
+        grade.saturation = fade(stat.saturationMult, stat.saturationAdd);
+        grade.brightness = fade(stat.brightnessMult, stat.brightnessAdd);
+        grade.contrast = fade(stat.contrastMult, stat.contrastAdd);
+        grade.tint = Color{stat.tint.red, stat.tint.green, stat.tint.blue, stat.tint.alpha * intensity};
+        return grade;
+    }
+
+    Grade GradeAt(const Settings::OverlayData &stat, float statValue) {
+        return GradeFor(stat, overlay::EasedValue(statValue, stat.startFraction, stat.endFraction, stat.easingFunction));
+    }
+
+    void KernelScalar(const Grade &grade, const std::array<const float*, PlaneCount> &in, const std::array<float*, PlaneCount> &out, std::size_t count) {
+        gradeBlocks<F32x1>(grade, in, out, 0, count);
+    }
+
+    void Kernel(const Grade &grade, const std::array<const float*, PlaneCount> &in, const std::array<float*, PlaneCount> &out, std::size_t count) {
+        auto tail = gradeBlocks<Wide>(grade, in, out, 0, count);
+        gradeBlocks<F32x1>(grade, in, out, tail, count);
+    }
+
+    const char* KernelName() {
+#if defined(STATFX_PREVIEW_AVX2)
+        return "avx2";
+#elif defined(STATFX_PREVIEW_SSE)
+        return "sse";
+#else
+        return "scalar";
+#endif
+    }
+
+    void Apply(const Grade &grade, const Image &input, Image &output, int threads) {
+        if (&output != &input && (output.width != input.width || output.height != input.height)) { output.resize(input.width, input.height); }
+        if (threads <= 0) { threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency())); }
+        int bands = std::max(1, std::min(threads, input.height));
+        auto band = [&](int b) {
+            auto y0 = static_cast<std::size_t>(input.height) * b / bands, y1 = static_cast<std::size_t>(input.height) * (b + 1) / bands;
+            auto offset = y0 * input.width, count = (y1 - y0) * input.width;
+            Kernel(grade,
+                {input.planes[Red].data() + offset, input.planes[Green].data() + offset, input.planes[Blue].data() + offset},
+                {output.planes[Red].data() + offset, output.planes[Green].data() + offset, output.planes[Blue].data() + offset},
+                count);
+        };
+        std::vector<std::thread> workers;
+        workers.reserve(bands - 1);
+        for (int b = 1; b < bands; b++) { workers.emplace_back(band, b); }
+        band(0);
+        for (auto &worker: workers) { worker.join(); }
+    }
+
+    void Blit(const Image &src, Image &dst, int x, int y) {
+        int x0 = std::max(0, x), x1 = std::min(dst.width, x + src.width);
+        if (x1 <= x0) { return; }
+        for (int row = std::max(0, y); row < std::min(dst.height, y + src.height); row++) {
+            auto from = static_cast<std::size_t>(row - y) * src.width + (x0 - x);
+            auto to = static_cast<std::size_t>(row) * dst.width + x0;
+            for (int p = 0; p < PlaneCount; p++) {
+                std::memcpy(dst.planes[p].data() + to, src.planes[p].data() + from, sizeof(float) * (x1 - x0));
+            }
+        }
+    }
+}
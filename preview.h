@@ -0,0 +1,67 @@
+/* Software preview of an overlay's look: the imod's tint and cinematic filters applied to an image on the CPU.
+ * ----------
+ * Mirrors the imagespace shader's cinematic pass, per pixel (grey is the Rec. 709 luminance of the input):
+ *   color = lerp(grey, color, saturation)
+ *   color = lerp(color, tint.rgb * grey, tint.a)
+ *   color = lerp(0.5, color * brightness, contrast)
+ * where each value is the neutral base (1) times the imod's Mult plus its Add, faded in by the overlay's intensity
+ * the same way the imod keys are (see overlay::ComputeImodParams).
+ *
+ * Images are planar (one float array per channel), so the kernel runs 8 (AVX2) or 4 (SSE) pixels per step without
+ * shuffles, and is split over threads in bands of rows.
+ *
+ * usage:
+ * auto grade = preview::GradeAt(settings.health, 0.25f);
+ * preview::Apply(grade, input, output);
+*/
+#pragma once
+#include <array>
+#include <cstddef>
+#include <vector>
+#include "settings.h"
+
+namespace preview
+{
+    enum Plane { Red, Green, Blue, PlaneCount };
+
+    // planar rgb image, 0 to 1 per channel (may go above 1)
+    struct Image {
+        int width = 0;
+        int height = 0;
+        std::array<std::vector<float>, PlaneCount> planes;
+
+        std::size_t pixels() const { return static_cast<std::size_t>(width) * static_cast<std::size_t>(height); }
+        void resize(int w, int h) {
+            width = w; height = h;
+            for (auto &plane: planes) { plane.assign(pixels(), 0.0f); }
+        }
+    };
+
+    // effective cinematic values of an overlay at one intensity
+    struct Grade {
+        float saturation = 1.0f;
+        float brightness = 1.0f;
+        float contrast = 1.0f;
+        Color tint = {1.0f, 1.0f, 1.0f, 0.0f};
+    };
+
+    // grade at an intensity (0 = no effect, 1 = full effect)
+    Grade GradeFor(const Settings::OverlayData &stat, float intensity);
+
+    // grade at a stat value (0 to 1), eased over the overlay's Range the same way the tick does
+    Grade GradeAt(const Settings::OverlayData &stat, float statValue);
+
+    // kernel over count pixels of planar input, writing planar output (may be the same arrays). The scalar version is
+    // the reference, Kernel uses the widest vector unit the build targets
+    void KernelScalar(const Grade &grade, const std::array<const float*, PlaneCount> &in, const std::array<float*, PlaneCount> &out, std::size_t count);
+    void Kernel(const Grade &grade, const std::array<const float*, PlaneCount> &in, const std::array<float*, PlaneCount> &out, std::size_t count);
+
+    // name of the vector unit Kernel uses ("avx2", "sse" or "scalar")
+    const char* KernelName();
+
+    // grade a whole image into output (resized to match), split over threads in bands of rows. 0 threads = one per core
+    void Apply(const Grade &grade, const Image &input, Image &output, int threads = 0);
+
+    // copy src into dst with its top left corner at (x, y), clipped to dst
+    void Blit(const Image &src, Image &dst, int x, int y);
+}
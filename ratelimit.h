@@ -0,0 +1,69 @@
+/* Rate limited logging for paths that can repeat every tick.
+ * ----------
+ * Each Limiter lets one line through per interval, and the next line that gets through says how many were suppressed
+ * in between. A limiter per source of lines (one per overlay, one for sampling...), so one overlay's faults never
+ * hide another's. Checking a limiter is an atomic timestamp compare: no lock and no allocation on the tick thread.
+ *
+ * usage:
+ * static rate_limited::Limiter samplingLog;
+ * rate_limited::error(samplingLog, "Something failed: {}", reason);
+*/
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <source_location>
+#include <utility>
+#include <spdlog/spdlog.h>
+
+namespace rate_limited
+{
+    inline std::chrono::milliseconds interval{5000};
+
+    class Limiter {
+    public:
+        // check if a line may be logged now. Sets suppressed to the number of lines dropped since the last one
+        bool allow(std::uint32_t &suppressed) {
+            auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            auto last = lastNs.load(std::memory_order_relaxed);
+            // another thread taking this interval's line first counts as a suppressed line too
+            if ((last != never && now - last < std::chrono::nanoseconds(interval).count()) || !lastNs.compare_exchange_strong(last, now, std::memory_order_relaxed)) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            suppressed = dropped.exchange(0, std::memory_order_relaxed);
+            return true;
+        }
+
+    private:
+        static constexpr std::int64_t never = std::numeric_limits<std::int64_t>::min();
+        std::atomic<std::int64_t> lastNs = never;
+        std::atomic<std::uint32_t> dropped = 0;
+    };
+
+    template <class... Args>
+    void log(spdlog::level::level_enum level, Limiter &limiter, const std::source_location &loc, spdlog::format_string_t<Args...> fmt, Args&&... args) {
+        if (!spdlog::should_log(level)) return;
+        std::uint32_t suppressed = 0;
+        if (!limiter.allow(suppressed)) return;
+        spdlog::source_loc source{loc.file_name(), static_cast<int>(loc.line()), loc.function_name()};
+        if (suppressed) spdlog::log(source, level, "({} repeats of the following line suppressed)", suppressed);
+        spdlog::log(source, level, fmt, std::forward<Args>(args)...);
+    }
+
+#define RATE_LIMITED_LEVEL(name, level)                                                                                                              \
+    template <class... Args>                                                                                                                         \
+    struct name {                                                                                                                                    \
+        name(Limiter &limiter, spdlog::format_string_t<Args...> fmt, Args&&... args, std::source_location loc = std::source_location::current()) { \
+            log<Args...>(level, limiter, loc, fmt, std::forward<Args>(args)...);                                                                     \
+        }                                                                                                                                            \
+    };                                                                                                                                               \
+    template <class... Args>                                                                                                                         \
+    name(Limiter&, spdlog::format_string_t<Args...>, Args&&...) -> name<Args...>;
+
+    RATE_LIMITED_LEVEL(info, spdlog::level::info)
+    RATE_LIMITED_LEVEL(warn, spdlog::level::warn)
+    RATE_LIMITED_LEVEL(error, spdlog::level::err)
+#undef RATE_LIMITED_LEVEL
+}
@@ -0,0 +1,276 @@
+/* Coroutine sequences on the overlay thread: timed behaviour (fade out, then release) written as straight-line code.
+ * ----------
+ * A sequence is a coroutine returning sequence::Task. It runs until it awaits one of:
+ *   executor.nextTick(): the next Executor::tick
+ *   executor.sleep(ms): the first tick at or after now + ms
+ *   executor.changed(signal, delta): the first tick after the signal has moved more than delta from where it was
+ * The executor is single-threaded (tick, spawn, cancel and Signal::set all run on the overlay thread). A tick only
+ * resumes the sequences whose wait is over: the ones woken by signals, expired sleeps off a min-heap, and the ones
+ * waiting for the tick. A suspended sequence is never looked at. Every sequence belongs to an owner (an overlay), and
+ * cancel(owner) or cancelAll() (on pause and reload) destroys the suspended frames, running their destructors.
+ * Waits hold a slot and generation, so a wait left behind by a cancelled sequence never resumes anything, and cancel
+ * drops the ended sequences' sleeps and tick waits, so nextDeadline (which the overlay thread sleeps until) never
+ * wakes the loop for a sleep that was cancelled. Signal watches are dropped at the signal's next set.
+ * The executor is not faster than polling a fade state per overlay, it is only cheaper when few of many overlays
+ * are fading (tools/sequence_bench.cpp): a resumed sequence costs ~25 ns against ~2 ns a polled overlay, so
+ * with the plugin's three overlays and one fading a tick takes ~27 ns against ~6 ns polled, and with 256 of 2048
+ * fading ~3.9 us against ~2.7 us. It is here so a release reads as straight-line code, not for speed.
+ *
+ * usage:
+ * sequence::Task Release(sequence::Executor &executor, game::Imod &imod) {
+ *     for (float fade = 1.0f; fade > 0.0f; fade -= 0.1f) { imod.trigger(fade); co_await executor.nextTick(); }
+ *     imod.stop();
+ * }
+ * executor.spawn(actors::Health, Release(executor, imod));
+ * executor.tick(nowMs); // every loop pass
+*/
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace sequence
+{
+    constexpr std::uint64_t never = std::numeric_limits<std::uint64_t>::max();
+
+    class Executor;
+
+    // a sequence's coroutine. Starts suspended, and does nothing until handed to Executor::spawn
+    class Task {
+    public:
+        struct promise_type {
+            std::exception_ptr exception;
+            Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { exception = std::current_exception(); }
+        };
+        using Handle = std::coroutine_handle<promise_type>;
+
+        Task(Task &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+        Task& operator=(Task&&) = delete;
+        ~Task() { if (handle) { handle.destroy(); } }
+
+    private:
+        friend class Executor;
+        explicit Task(Handle handle) : handle(handle) {}
+        Handle release() { return std::exchange(handle, nullptr); }
+        Handle handle;
+    };
+
+    // a sequence in the executor's slot table, valid while the slot's generation still matches
+    struct Ref {
+        std::uint32_t slot = 0;
+        std::uint32_t generation = 0;
+    };
+
+    // a value sequences can wait on to change, e.g. an overlay's smoothed stat
+    class Signal {
+    public:
+        explicit Signal(Executor &executor, float value = 0.0f) : executor(executor), current(value) {}
+        Signal(const Signal&) = delete;
+        Signal& operator=(const Signal&) = delete;
+        float get() const { return current; }
+        // wakes every waiter the new value has moved far enough from where it started waiting
+        void set(float value);
+
+    private:
+        friend class Executor;
+        struct Watch {
+            Ref ref;
+            float from;
+            float delta;
+        };
+        Executor &executor;
+        float current;
+        std::vector<Watch> watches;
+    };
+
+    class Executor {
+    public:
+        using Owner = std::uint32_t;
+
+        Executor() = default;
+        Executor(const Executor&) = delete;
+        Executor& operator=(const Executor&) = delete;
+        ~Executor() { cancelAll(); }
+
+        // start a sequence: it runs right away, up to its first wait
+        void spawn(Owner owner, Task task) {
+            auto handle = task.release();
+            if (!handle) { return; }
+            std::uint32_t slot;
+            if (!freeSlots.empty()) {
+                slot = freeSlots.back();
+                freeSlots.pop_back();
+            } else {
+                slot = static_cast<std::uint32_t>(slots.size());
+                slots.push_back({});
+            }
+            slots[slot].handle = handle;
+            slots[slot].owner = owner;
+            if (owner >= perOwner.size()) { perOwner.resize(owner + 1, 0); }
+            perOwner[owner]++;
+            live++;
+            // room in the wait lists for every live sequence, so waits and ticks never grow them
+            if (resuming.capacity() < live) {
+                for (auto list: {&ticking, &woken, &resuming}) { list->reserve(live * 2); }
+                sleepers.reserve(live * 2);
+            }
+            resume(Ref{slot, slots[slot].generation});
+        }
+
+        // resume every sequence whose wait is over, in the order woken by signals, expired sleeps (earliest first), then
+        // the ones waiting for this tick. A sequence that lets an exception out is ended, and once the others have run
+        // the first such exception is rethrown
+        void tick(std::uint64_t now) {
+            current = now;
+            if (woken.empty() && ticking.empty() && (sleepers.empty() || sleepers.front().first > now)) { return; }
+            // swapped rather than copied: both lists keep the capacity they grew to, so a steady tick allocates nothing
+            resuming.clear();
+            resuming.swap(woken);
+            while (!sleepers.empty() && sleepers.front().first <= now) {
+                std::pop_heap(sleepers.begin(), sleepers.end(), later);
+                resuming.push_back(sleepers.back().second);
+                sleepers.pop_back();
+            }
+            resuming.insert(resuming.end(), ticking.begin(), ticking.end());
+            ticking.clear();
+            // waits made while resuming go into woken, ticking and sleepers, for the next tick
+            std::exception_ptr first;
+            for (auto ref: resuming) {
+                try {
+                    resume(ref);
+                } catch (...) {
+                    if (!first) { first = std::current_exception(); }
+                }
+            }
+            if (first) { std::rethrow_exception(first); }
+        }
+
+        // time of the last tick, ms
+        std::uint64_t now() const { return current; }
+        // earliest sleep deadline, or never. A tick is also due whenever a sequence waits for one (see waiting)
+        std::uint64_t nextDeadline() const { return sleepers.empty() ? never : sleepers.front().first; }
+        // sequences waiting for the next tick, or woken by a signal
+        bool waiting() const { return !ticking.empty() || !woken.empty(); }
+        // live sequences, and whether an owner has any
+        std::size_t size() const { return live; }
+        bool running(Owner owner) const { return owner < perOwner.size() && perOwner[owner] > 0; }
+
+        // end an owner's sequences where they are suspended (never from inside one of them). Returns how many were ended
+        std::size_t cancel(Owner owner) { return running(owner) ? end([owner](Owner o) { return o == owner; }) : 0; }
+        std::size_t cancelAll() { return end([](Owner) { return true; }); }
+
+    private:
+        friend class Signal;
+
+        struct Slot {
+            Task::Handle handle;
+            Owner owner = 0;
+            std::uint32_t generation = 0;
+        };
+
+        // suspends the running sequence and files it under what it waits for
+        struct Wait {
+            enum class Kind { Tick, Sleep, Change };
+            Executor *executor;
+            Kind kind;
+            std::uint64_t deadline = 0;
+            Signal *signal = nullptr;
+            float delta = 0.0f;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<>) {
+                auto ref = executor->active;
+                switch (kind) {
+                    case Kind::Tick: executor->ticking.push_back(ref); break;
+                    case Kind::Sleep:
+                        executor->sleepers.push_back({deadline, ref});
+                        std::push_heap(executor->sleepers.begin(), executor->sleepers.end(), later);
+                        break;
+                    case Kind::Change: signal->watches.push_back({ref, signal->current, delta}); break;
+                }
+            }
+            void await_resume() const noexcept {}
+        };
+
+    public:
+        // awaitables
+        Wait nextTick() { return Wait{this, Wait::Kind::Tick}; }
+        Wait sleep(std::uint64_t ms) { return Wait{this, Wait::Kind::Sleep, current + ms}; }
+        Wait changed(Signal &signal, float delta = 0.0f) { return Wait{this, Wait::Kind::Change, 0, &signal, delta}; }
+
+    private:
+        static bool later(const std::pair<std::uint64_t, Ref> &a, const std::pair<std::uint64_t, Ref> &b) { return a.first > b.first; }
+
+        void resume(Ref ref) {
+            if (stale(ref)) { return; } // ended since it started waiting
+            auto handle = slots[ref.slot].handle;
+            auto outer = std::exchange(active, ref); // a sequence may spawn another
+            handle.resume();
+            active = outer;
+            if (handle.done()) {
+                auto exception = handle.promise().exception;
+                free(ref.slot);
+                if (exception) { std::rethrow_exception(exception); }
+            }
+        }
+
+        void free(std::uint32_t slot) {
+            slots[slot].handle.destroy();
+            slots[slot].handle = nullptr;
+            slots[slot].generation++;
+            freeSlots.push_back(slot);
+            perOwner[slots[slot].owner]--;
+            live--;
+        }
+
+        // whether a wait still belongs to the sequence that made it
+        bool stale(Ref ref) const { return slots[ref.slot].generation != ref.generation || !slots[ref.slot].handle; }
+
+        template <class Match>
+        std::size_t end(Match match) {
+            std::size_t ended = 0;
+            for (std::uint32_t i = 0; i < slots.size(); i++) {
+                if (slots[i].handle && match(slots[i].owner)) { free(i); ended++; }
+            }
+            if (ended == 0) { return 0; }
+            // the waits the ended sequences left behind (erasing in place allocates nothing)
+            std::erase_if(ticking, [this](Ref ref) { return stale(ref); });
+            std::erase_if(woken, [this](Ref ref) { return stale(ref); });
+            std::erase_if(sleepers, [this](const std::pair<std::uint64_t, Ref> &sleeper) { return stale(sleeper.second); });
+            std::make_heap(sleepers.begin(), sleepers.end(), later);
+            return ended;
+        }
+
+        std::vector<Slot> slots;
+        std::vector<std::uint32_t> freeSlots;
+        std::vector<std::uint32_t> perOwner; // live sequences by owner (owners are small numbers, like actors::Stat)
+        std::size_t live = 0;
+        std::uint64_t current = 0;
+        Ref active; // the sequence being resumed
+        std::vector<Ref> ticking, woken, resuming;
+        std::vector<std::pair<std::uint64_t, Ref>> sleepers; // min-heap on deadline
+    };
+
+    inline void Signal::set(float value) {
+        current = value;
+        // dropping the watches of ended sequences here keeps the list from growing
+        std::erase_if(watches, [this](const Watch &watch) {
+            auto &slot = executor.slots[watch.ref.slot];
+            if (slot.generation != watch.ref.generation || !slot.handle) { return true; }
+            if (std::abs(current - watch.from) <= watch.delta) { return false; }
+            executor.woken.push_back(watch.ref);
+            return true;
+        });
+    }
+}
@@ -0,0 +1,738 @@
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <tuple>
+#include "settings.h"
+#include "parse.h"
+#include "corelog.h"
+
+// rebuild the bank with only the base config, taken from the current settings
+void ResetProfiles(const Settings &settings, Profiles &profiles) {
+    auto base = std::make_unique<Profile>();
+    base->name = "base";
+    base->stamina = settings.stamina; base->magicka = settings.magicka; base->health = settings.health;
+    profiles.bank.clear();
+    profiles.bank.push_back(std::move(base));
+    profiles.index = 0;
+    profiles.active.store(profiles.bank.front().get(), std::memory_order_release);
+}
+
+void Profiles::offer(Bank loaded, std::size_t start) {
+    if (loaded.empty()) { return; }
+    start = std::min(start, loaded.size() - 1);
+    std::lock_guard guard(handoff);
+    offered.emplace(std::move(loaded), start);
+    pending.store(true, std::memory_order_release);
+}
+
+std::optional<std::size_t> Profiles::take(Bank &retired) {
+    std::optional<std::size_t> next;
+    if (pending.exchange(false, std::memory_order_acquire)) {
+        std::lock_guard guard(handoff);
+        if (offered) {
+            retired.swap(bank);
+            bank.swap(offered->first);
+            next = offered->second;
+            offered.reset();
+        }
+    }
+    auto presses = cycles.exchange(0, std::memory_order_relaxed);
+    if (presses > 0 && bank.size() >= 2) { next = (next.value_or(index) + presses) % bank.size(); }
+    return next;
+}
+
+// Read settings from the parsed ini and fill out settings struct
+void ReadSettings(const mINI::INIStructure &iniStruct, Settings &settings, Profiles &profiles) {
+    // lambda to convert string to lowercase
+    auto strLower = [](std::string str) -> std::string {
+        std::transform(str.begin(), str.end(), str.begin(), ::tolower);
+        return str;
+    };
+    // lambda to remove all whitespace and parentheses and convert to lowercase
+    auto normalizeStr = [strLower](std::string str) -> std::string {
+        str.erase(std::remove(str.begin(), str.end(), ' '), str.end());
+        str.erase(std::remove(str.begin(), str.end(), '('), str.end());
+        str.erase(std::remove(str.begin(), str.end(), ')'), str.end());
+        return strLower(str);
+    };
+    // lambda to parse a single number, logging why and where it could not be understood. Empty if it failed
+    auto readNumber = [](const std::string &section, const std::string &key, const std::string &iniVal) -> std::optional<float> {
+        auto parsed = parse::number(iniVal);
+        if (!parsed) {
+            logger::warn("INI Config: {} Section: Could not understand {} '{}' ({} at character {}): Using default value", section, key, iniVal, parse::describe(parsed.error()), parsed.error().position+1);
+            return std::nullopt;
+        }
+        return *parsed;
+    };
+    auto iniSleepTime = iniStruct.get("Global").get("SleepTime");
+    if (iniSleepTime.empty() ) {
+        logger::warn("INI Config: Global Section: SleepTime not found: Using default value");
+    } else if (auto sleepTime = readNumber("Global", "SleepTime", iniSleepTime)) {
+        settings.sleepTime = static_cast<int>(round(*sleepTime));
+    }
+    // Set no reload flag if defined (try variations on key)
+    std::string iniReload = "";
+    for (auto key: {"Reload","ReloadFlag","AutoReload","AutoReloadFlag","AutoLoad","Refresh","AutoRefresh","Sync"}) {
+        iniReload = iniStruct.get("Global").get(key);
+        if (!iniReload.empty()) break;
+    }
+    if (!iniReload.empty() && normalizeStr(iniReload)=="false") {
+        logger::info("INI Config: Reload flag set to false");
+        settings.reload = false;
+    }
+    // Opt-in shared memory telemetry feed (try variations on key)
+    std::string iniTelemetry = "";
+    for (auto key: {"Telemetry","TelemetryFeed","SharedMemory","Publish"}) {
+        iniTelemetry = iniStruct.get("Global").get(key);
+        if (!iniTelemetry.empty()) break;
+    }
+    if (!iniTelemetry.empty() && normalizeStr(iniTelemetry)=="true") {
+        settings.telemetryFeed = true;
+        auto iniTelemetryName = iniStruct.get("Global").get("TelemetryName");
+        if (!iniTelemetryName.empty()) settings.telemetryName = iniTelemetryName;
+    }
+    // fault isolation: how many faults an overlay may have before it is disabled, and the first backoff in ms
+    auto iniFaultBudget = iniStruct.get("Global").get("FaultBudget");
+    if (!iniFaultBudget.empty()) {
+        if (auto budget = readNumber("Global", "FaultBudget", iniFaultBudget)) settings.faults.budget = std::max(1, static_cast<int>(round(*budget)));
+    }
+    auto iniFaultBackoff = iniStruct.get("Global").get("FaultBackoff");
+    if (!iniFaultBackoff.empty()) {
+        if (auto backoff = readNumber("Global", "FaultBackoff", iniFaultBackoff)) settings.faults.backoffTicks = std::max(1, static_cast<int>(round(*backoff / settings.sleepTime)));
+    }
+    // profile to start on, and the hotkey that cycles through them (try variations on key)
+    for (auto key: {"Profile","ActiveProfile","StartProfile","Preset"}) {
+        settings.profile = iniStruct.get("Global").get(key);
+        if (!settings.profile.empty()) break;
+    }
+    std::string iniProfileHotkey = "";
+    for (auto key: {"ProfileHotkey","ProfileKey","CycleProfileKey","PresetHotkey"}) {
+        iniProfileHotkey = iniStruct.get("Global").get(key);
+        if (!iniProfileHotkey.empty()) break;
+    }
+    if (!iniProfileHotkey.empty()) {
+        auto hotkey = parse::integer(iniProfileHotkey);
+        if (hotkey && *hotkey >= 0) { settings.profileHotkey = *hotkey; }
+        else { logger::warn("INI Config: Global Section: Could not understand ProfileHotkey '{}': No hotkey", iniProfileHotkey); }
+    }
+    // timeline tracer: on from the start, and/or a hotkey that starts it and writes the trace (try variations on key)
+    std::string iniTrace = "";
+    for (auto key: {"Trace","Tracing","TraceTimeline"}) {
+        iniTrace = iniStruct.get("Global").get(key);
+        if (!iniTrace.empty()) break;
+    }
+    if (!iniTrace.empty() && normalizeStr(iniTrace)=="true") settings.trace = true;
+    std::string iniTraceHotkey = "";
+    for (auto key: {"TraceHotkey","TraceKey"}) {
+        iniTraceHotkey = iniStruct.get("Global").get(key);
+        if (!iniTraceHotkey.empty()) break;
+    }
+    if (!iniTraceHotkey.empty()) {
+        auto hotkey = parse::integer(iniTraceHotkey);
+        if (hotkey && *hotkey >= 0) { settings.traceHotkey = *hotkey; }
+        else { logger::warn("INI Config: Global Section: Could not understand TraceHotkey '{}': No hotkey", iniTraceHotkey); }
+    }
+    auto iniTraceEvents = iniStruct.get("Global").get("TraceEvents");
+    if (!iniTraceEvents.empty()) {
+        auto events = parse::integer(iniTraceEvents);
+        if (events && *events > 0) { settings.traceEvents = *events; }
+        else { logger::warn("INI Config: Global Section: Could not understand TraceEvents '{}': Using default value", iniTraceEvents); }
+    }
+    settings.faults.maxBackoffTicks = std::max(settings.faults.backoffTicks, 10000 / std::max(settings.sleepTime, 1));
+    settings.faults.forgiveTicks = 60000 / std::max(settings.sleepTime, 1);
+    // variations on key EditorId, also used to keep a stage from inheriting its stat's form
+    const auto editorIDKeys = {"EditorID","Imod","ImodID","ImodEditorID","ImodFormID","FormID","ID","EditorFormID","ImodFormID","Form","Name"};
+    const auto intensityKeys = {"Intensity","IntensityExpression","Expression","Formula"};
+    // lambda to init a stat's overlay (stamina, magicka, health)
+    auto initOverlay = [&settings, &editorIDKeys, &intensityKeys, strLower, normalizeStr, readNumber](Settings::OverlayData *stat, std::string section, const mINI::INIStructure &iniStruct) {
+        logger::info("INI Config: Initializing settings for section: '{}'", section);
+        // Check if disable flag for this overlay is set in ini (try variations on key "disabled")
+        std::string iniDisabled = "";
+        for (auto key: {"Disabled","Disable","Off","Inactive","Paused","Pause"}) {
+            iniDisabled = iniStruct.get(section).get(key);
+            if (!iniDisabled.empty()) break;
+        }
+        if (!iniDisabled.empty() && normalizeStr(iniDisabled)=="true") {
+            logger::info("INI Config: Disabling {} overlay: manual disabled flag set", section);
+            stat->enabled = false;
+            return;
+        }
+        // Check if disable flag for this overlay in ini (try variations on key "enabled")
+        std::string iniEnabled = "";
+        for (auto key: {"Enabled","Enable","On","Active","Start","Run","Go"}) {
+            iniEnabled = iniStruct.get(section).get(key);
+            if (!iniEnabled.empty()) break;
+        }
+        if (!iniEnabled.empty() && normalizeStr(iniEnabled)=="false") {
+            logger::info("INI Config: Section {}: Disabling overlay: manual disable flag set", section);
+            stat->enabled = false;
+            return;
+        }
+        // try variation on key EditorId
+        std::string iniEditorID = "";
+        for (auto key: editorIDKeys) {
+            iniEditorID = iniStruct.get(section).get(key);
+            if (!iniEditorID.empty()) break;
+        }
+        logger::info("INI Config: Section {}: Editor ID read: '{}'", section, iniEditorID);
+        // stage sections have no default form
+        auto defaultEditorID = settings.defaultEditorIDs.contains(section) ? settings.defaultEditorIDs.at(section) : std::string();
+        // a plugin-qualified FormID ("StatFX.esp|0x801") instead of an editor ID survives record merging
+        if (parse::isFormRef(iniEditorID)) {
+            auto formRef = parse::formRef(iniEditorID);
+            if (!formRef) {
+                logger::warn("INI Config: {} Section: Could not understand form '{}' ({} at character {}, expected Plugin.esp|0xFormID): Using default: '{}'", section, iniEditorID, parse::describe(formRef.error()), formRef.error().position+1, defaultEditorID);
+                iniEditorID = "";
+            }
+        }
+        if (iniEditorID.empty()) {
+            if (defaultEditorID.empty()) {
+                logger::warn("INI Config: Section {}: No EditorID and no default form: Disabling overlay", section);
+                stat->enabled = false;
+                return;
+            }
+            logger::warn("INI Config: Section {}: EditorID is empty, using default: '{}'", section, defaultEditorID);
+            iniEditorID = defaultEditorID;
+        }
+        stat->editorID = iniEditorID;
+        // Fill in tint color settings from ini if they exist, otherwise keep default (try variations on key "TintColor")
+        std::string iniTintColor = "";
+        for (auto key: {"TintColor","Tint","Color","Colour","TintColour","TintRGB","TintRGBA"}) {
+            iniTintColor = iniStruct.get(section).get(key);
+            if (!iniTintColor.empty()) break;
+        } // this is a hex color code: https://rgbcolorpicker.com for instance
+        float tintR=0.0f, tintG=0.0f, tintB=0.0f, tintA=0.0f;
+        if (!iniTintColor.empty()) {
+            // hex code (#rrggbb or #rrggbbaa), rgba(r,g,b,a) or bare r,g,b,a values
+            auto color = parse::color(iniTintColor);
+            if (!color) {
+                logger::warn("INI Config: {} Section: Could not understand TintColor '{}' ({} at character {}): Using default (no tint)", section, iniTintColor, parse::describe(color.error()), color.error().position+1);
+            } else {
+                if (color->components < 3) {
+                    logger::warn("INI Config: {} Section: TintColor '{}' is missing some values. Using 0 for the missing ones", section, iniTintColor);
+                }
+                tintR = color->r; tintG = color->g; tintB = color->b; tintA = color->a;
+            }
+        }
+        // legacy tint key support: override with "TintRed", "TintGreen", "TintBlue", "TintAlpha" if they exist ("TintStrength" is an alias for TintAlpha)
+        std::vector<std::pair<float*, std::string>> legacyTints = {
+            {&tintA, "TintStrength"},
+            {&tintR, "TintRed"},
+            {&tintG, "TintGreen"},
+            {&tintB, "TintBlue"},
+            {&tintA, "TintAlpha"}
+        };
+        for (auto [dest, key]: legacyTints) {
+            auto iniVal = iniStruct.get(section).get(key);
+            if (iniVal.empty()) continue;
+            if (auto value = readNumber(section, key, iniVal)) *dest = *value;
+        }
+        // Any values above 1 will be interpreted as out of 255 range, so divide by 255
+        for (auto tint: {&tintR, &tintG, &tintB, &tintA}) { if (*tint>1.0f) *tint/=255.0f;}
+        // warn if any of the values are out of range 0 to 1
+        if (tintR<0.0f || tintR>1.0f || tintG<0.0f || tintG>1.0f || tintB<0.0f || tintB>1.0f || tintA<0.0f || tintA>1.0f) {
+            logger::error("INI Config: {} Section: some tint color value (r{:.2} g{:.2} b{:.2} a{:.2}) is out of range (0.0 to 1.0): Using default (no tint)", section, tintR, tintG, tintB, tintA);
+            tintR=0.0f; tintG=0.0f; tintB=0.0f; tintA=0.0f;
+        }
+        stat->tint = Color{tintR, tintG, tintB, tintA};
+        // Fill in cinematic settings from ini if they exist, otherwise keep default
+        std::vector<std::pair<float*, std::string>> cinematics = {
+            {&stat->contrastAdd, "ContrastAdd"},
+            {&stat->contrastMult, "ContrastMult"},
+            {&stat->contrastMult, "Contrast"},
+            {&stat->brightnessAdd, "BrightnessAdd"},
+            {&stat->brightnessMult, "BrightnessMult"},
+            {&stat->brightnessMult, "Brightness"},
+            {&stat->saturationAdd, "SaturationAdd"},
+            {&stat->saturationMult, "SaturationMult"},
+            {&stat->saturationMult, "Saturation"}
+        };
+        for (auto [dest, key]: cinematics) {
+            auto iniVal = iniStruct.get(section).get(key);
+            if (iniVal.empty()) continue;
+            if (auto value = readNumber(section, key, iniVal)) *dest = *value;
+        }
+        // Fill in curve range info from ini
+        float startF=1.0f, endF=0.0f;
+        // try variations of key Range
+        std::string iniRange = "";
+        for (auto key: {"Range","CurveRange","StartEnd","StatRange","EffectRange","FromTo"}) {
+            iniRange = iniStruct.get(section).get(key);
+            if (!iniRange.empty()) break;
+        }
+        if (!iniRange.empty()) {
+            // end is before comma, start is after comma
+            auto range = parse::pair(iniRange);
+            if (!range) {
+                logger::warn("INI Config: {} Section: Could not understand Range '{}' ({} at character {}): Using defaults (Start: 1.0, End: 0.0)", section, iniRange, parse::describe(range.error()), range.error().position+1);
+            } else {
+                endF = range->first; startF = range->second;
+                if ( endF>1.0 || endF<0.0 || startF>1.0 || startF<0.0 ) {
+                    logger::warn("INI Config: {} Section: Range Start '{:.2}' and End '{:.2}' must be in range 0 to 1: Using defaults (Start: 1.0, End: 0.0)", section, startF, endF);
+                    startF = 1.0f; endF = 0.0f;
+                } else {
+                    // flip start and end if start is lower than end
+                    if (startF < endF) {
+                        logger::warn("INI Config: {} Section: Range Start '{:.2}' is lower than End '{:.2}': Flipping values", section, startF, endF);
+                        float temp = startF;
+                        startF = endF;
+                        endF = temp;
+                    }
+                }
+            }
+        }
+        // legacy start and end fraction
+        // try variations of key StartFraction and EndFraction
+        std::string iniStartFraction = "";
+        for (auto key: {"StartFraction","Start","To","Upper","Upperbound","UpperBound"}) {
+            iniStartFraction = iniStruct.get(section).get(key);
+            if (!iniStartFraction.empty()) break;
+        }
+        if (!iniStartFraction.empty()) {
+            auto value = readNumber(section, "StartFraction", iniStartFraction);
+            startF = value ? *value : 1.0f;
+        }
+        std::string iniEndFraction = "";
+        for (auto key: {"EndFraction","End","From","Lower","Lowerbound","LowerBound"}) {
+            iniEndFraction = iniStruct.get(section).get(key);
+            if (!iniEndFraction.empty()) break;
+        }
+        if (!iniEndFraction.empty()) {
+            auto value = readNumber(section, "EndFraction", iniEndFraction);
+            endF = value ? *value : 0.0f;
+        }
+        if ( endF>1.0 || endF<0.0 || startF>1.0 || startF<0.0 ) {
+            logger::warn("INI Config: {} Section: StartFraction '{:.2}' and EndFraction '{:.2}' must be in range 0 to 1: Using defaults (Start: 1.0, End: 0.0)", section, startF, endF);
+            startF = 1.0f; endF = 0.0f;
+        }
+        //  flip start and end if start is lower than end
+        if (startF < endF) {
+            logger::warn("INI Config: {} Section: StartFraction '{:.2}' is lower than EndFraction '{:.2}': Flipping values", section, startF, endF);
+            float temp = startF;
+            startF = endF;
+            endF = temp;
+        }
+        stat->startFraction = startF;
+        stat->endFraction = endF;
+        // get easing function value from ini (try variations on key)
+        easing::easingFunction easingFunction = settings.defaultValues.easingFunction;
+        std::string iniEasingFunction = "";
+        for (auto key: {"EasingFunction","Ease","Function","Curve","Easing","EasingFunc",
+            "CurveFunction","CurveFunc","EaseFunc","EaseFunction","CurveType","EasingCurve","EaseCurve"}) {
+            iniEasingFunction = iniStruct.get(section).get(key);
+            if (iniEasingFunction.empty()) continue;
+            easingFunction = easing::getEasingFunctionString( iniEasingFunction ); break;
+        }
+        // warn if it defaulted to linear
+        if (easingFunction == easing::linear && iniEasingFunction!="linear") {
+            logger::warn("INI Config: {} Section: No match for Easing Curve '{}': using 'linear' default", section, iniEasingFunction);
+        } else {
+            stat->easingFunction = easingFunction;
+        }
+        // float32 approximation of the curve (see easingf.h), the default in STATFX_EASING_APPROX builds (try variations on key)
+        bool easingApprox = easingf::byDefault;
+        std::string iniEasingApprox = "";
+        for (auto key: {"EasingApprox","ApproxEasing","FastEasing","FastCurve","CurveApprox"}) {
+            iniEasingApprox = iniStruct.get(section).get(key);
+            if (!iniEasingApprox.empty()) break;
+        }
+        if (!iniEasingApprox.empty()) {
+            if (normalizeStr(iniEasingApprox)=="true") easingApprox = true;
+            else if (normalizeStr(iniEasingApprox)=="false") easingApprox = false;
+            else logger::warn("INI Config: {} Section: Could not understand EasingApprox '{}' (true or false): Using default", section, iniEasingApprox);
+        }
+        if (easingApprox) stat->easingFunction = easingf::approximate(stat->easingFunction);
+        // how often this overlay samples and updates, in ms (or UpdateRate in Hz). Read before FadeTime, which is per update
+        stat->updateInterval = settings.sleepTime;
+        std::string iniUpdateInterval = "";
+        for (auto key: {"UpdateInterval","Interval","UpdateMs","TickInterval","UpdateTime"}) {
+            iniUpdateInterval = iniStruct.get(section).get(key);
+            if (!iniUpdateInterval.empty()) break;
+        }
+        if (!iniUpdateInterval.empty()) {
+            if (auto value = readNumber(section, "UpdateInterval", iniUpdateInterval)) stat->updateInterval = static_cast<int>(round(*value));
+        } else {
+            std::string iniUpdateRate = "";
+            for (auto key: {"UpdateRate","UpdateHz","Rate","TickRate"}) {
+                iniUpdateRate = iniStruct.get(section).get(key);
+                if (!iniUpdateRate.empty()) break;
+            }
+            if (!iniUpdateRate.empty()) {
+                auto value = readNumber(section, "UpdateRate", iniUpdateRate);
+                if (value && *value > 0.0f) stat->updateInterval = static_cast<int>(round(1000.0f / *value));
+                else if (value) logger::warn("INI Config: {} Section: UpdateRate '{:.2}' must be above 0: Using SleepTime", section, *value);
+            }
+        }
+        if (stat->updateInterval < 1) {
+            logger::warn("INI Config: {} Section: UpdateInterval '{}' must be at least 1 ms: Using SleepTime", section, stat->updateInterval);
+            stat->updateInterval = std::max(settings.sleepTime, 1);
+        }
+        // read FadeTime as a high-level setting for maxDelta. This is how many seconds to go from no effect to full effect
+        float maxDeltaNeg=settings.defaultValues.maxDelta; float maxDeltaPos=settings.defaultValues.maxDeltaPos; float minDelta=settings.defaultValues.minDelta;
+        std::string iniFadeTime = "";
+        // try variations on key
+        for (auto key: {"FadeTime","TransitionTime","Transition","Fade","Time","FadeDuration","FadeSecs","FadeSeconds","FadeS"}) {
+            iniFadeTime = iniStruct.get(section).get(key);
+            if (!iniFadeTime.empty()) break;
+        }
+        { // this weird block with SKIP_FADE_TIME lets me succinctly break processing FadeTime when we know parsing failed somewhere
+            if (iniFadeTime.empty()) {
+                logger::warn("INI Config: {} Section: FadeTime not found: Using default deltas", section);
+                goto SKIP_FADE_TIME;
+            }
+            // read in as (neg, pos), or a single value used for both
+            auto fadeTime = parse::numberOrPair(iniFadeTime);
+            if (!fadeTime) {
+                logger::warn("INI Config: {} Section: Could not understand FadeTime '{}' ({} at character {}): Ignoring", section, iniFadeTime, parse::describe(fadeTime.error()), fadeTime.error().position+1);
+                goto SKIP_FADE_TIME;
+            }
+            auto fadeTimeNeg = fadeTime->first; auto fadeTimePos = fadeTime->second;
+            if (fadeTimeNeg <= 0.0f || fadeTimePos <= 0.0f) goto SKIP_FADE_TIME; //negative value or zero is parse fail token, dont continue
+            // convert fade time seconds to delta percentage per tick (updateInterval ms per tick)
+            auto secsToTicks = [stat](float secs)->int { return std::max(1, static_cast<int>(round(secs*1000.0f/stat->updateInterval))); };
+            auto curveRange = std::abs(stat->startFraction - stat->endFraction); // the percentage (between 0 and 1) of the stat which we want to have a duration of fade time seconds
+            auto secsToDelta = [secsToTicks,curveRange](float secs)->float { return curveRange/secsToTicks(secs); };
+            maxDeltaNeg = secsToDelta(fadeTimeNeg); maxDeltaPos = secsToDelta(fadeTimePos);
+            logger::info("INI Config: {} Section: FadeTime '{}' parsed as {}s = MaxDeltaNeg: {:.4} and {}s = MaxDeltaPos: {:.4}", section, iniFadeTime, fadeTimeNeg, maxDeltaNeg, fadeTimePos, maxDeltaPos);
+
+
+        } SKIP_FADE_TIME: // label to skip the rest of the block if fade time could not be processed (to avoid having to handle useless cascading errors)
+        // use the legacy Min- and MaxDelta values as overrides if they are defined in the ini
+        auto iniMinDelta = iniStruct.get(section).get("MinDelta");
+        if (!iniMinDelta.empty()) {
+            if (auto value = readNumber(section, "MinDelta", iniMinDelta)) minDelta = *value;
+        }
+        auto iniMaxDelta = iniStruct.get(section).get("MaxDelta");
+        if (!iniMaxDelta.empty()) { // default both neg and positive maxDelta to same value
+            if (auto value = readNumber(section, "MaxDelta", iniMaxDelta)) maxDeltaPos = maxDeltaNeg = *value;
+        }
+        auto iniMaxDeltaPos = iniStruct.get(section).get("MaxDeltaPos");
+        if (!iniMaxDeltaPos.empty()) {
+            if (auto value = readNumber(section, "MaxDeltaPos", iniMaxDeltaPos)) maxDeltaPos = *value;
+        }
+        // update the actual values
+        stat->minDelta = minDelta; stat->maxDelta = maxDeltaNeg; stat->maxDeltaPos = maxDeltaPos;
+        // if maxDelta is less than zero, set it to default
+        if (stat->maxDelta <= 0.0f) {
+            logger::warn("INI Config: {} Section: MaxDelta '{:.4}' is less than 0: Using default value: {:.4}", section, stat->maxDelta, settings.defaultValues.maxDelta);
+            stat->maxDelta = settings.defaultValues.maxDelta;
+        }
+        // same with maxDelta pos
+        if (stat->maxDeltaPos <= 0.0f) {
+            logger::warn("INI Config: {} Section: MaxDeltaPos '{:.4}' is less than 0: Using default value: {:.4}", section, stat->maxDeltaPos, settings.defaultValues.maxDeltaPos);
+            stat->maxDeltaPos = settings.defaultValues.maxDeltaPos;
+        }
+        // set minDelta to slightly less than max if it is higher than max
+        if (stat->minDelta > std::min(stat->maxDelta, stat->maxDeltaPos)) {
+            logger::warn("INI Config: {} Section: MinDelta '{:.4}' is higher than MaxDelta '{:.4}': Setting MinDelta to .8 of MaxDelta", section, stat->minDelta, std::min(stat->maxDelta, stat->maxDeltaPos));
+            stat->minDelta = std::min(stat->maxDelta, stat->maxDeltaPos)*0.8f;
+
+        }
+        // if minDelta is less than 0, set it to 80% of maxDelta
+        if (stat->minDelta <= 0.0f) {
+            logger::warn("INI Config: {} Section: MinDelta '{:.4}' is less than 0: Setting MinDelta to .8 of MaxDelta", section, stat->minDelta);
+            stat->minDelta = stat->maxDelta*0.8f;
+        }
+        // number of keyframes to bake the curve into on the imod timeline (try variations on key)
+        std::string iniKeyframes = "";
+        for (auto key: {"Keyframes","KeyFrames","Keys","KeyCount","TimelineKeys"}) {
+            iniKeyframes = iniStruct.get(section).get(key);
+            if (!iniKeyframes.empty()) break;
+        }
+        if (!iniKeyframes.empty()) {
+            if (auto value = readNumber(section, "Keyframes", iniKeyframes)) stat->keyframes = static_cast<int>(round(*value));
+            if (stat->keyframes < 2) {
+                stat->keyframes = 0;
+            } else if (stat->keyframes > timeline::maxKeys) {
+                logger::warn("INI Config: {} Section: Keyframes '{}' is more than the max of {}: Clamping", section, stat->keyframes, timeline::maxKeys);
+                stat->keyframes = timeline::maxKeys;
+            }
+        }
+        // pulse oscillator applied on top of the eased intensity (try variations on key)
+        std::string iniPulse = "";
+        for (auto key: {"Pulse","PulseWave","PulseWaveform","Waveform","Oscillator","Heartbeat"}) {
+            iniPulse = iniStruct.get(section).get(key);
+            if (!iniPulse.empty()) break;
+        }
+        if (!iniPulse.empty()) {
+            stat->pulse.waveform = oscillator::getWaveformString(normalizeStr(iniPulse));
+            if (stat->pulse.waveform == oscillator::Waveform::None && normalizeStr(iniPulse) != "none" && normalizeStr(iniPulse) != "false") {
+                logger::warn("INI Config: {} Section: No match for Pulse '{}': Pulse disabled", section, iniPulse);
+            }
+            std::vector<std::pair<float*, std::string>> pulseValues = {
+                {&stat->pulse.frequency, "PulseFrequency"},
+                {&stat->pulse.depth, "PulseDepth"},
+                {&stat->pulse.rise, "PulseRise"}
+            };
+            for (auto [dest, key]: pulseValues) {
+                auto iniVal = iniStruct.get(section).get(key);
+                if (iniVal.empty()) continue;
+                if (auto value = readNumber(section, key, iniVal)) *dest = *value;
+            }
+            if (stat->pulse.frequency <= 0.0f) {
+                logger::warn("INI Config: {} Section: PulseFrequency '{:.2}' must be above 0: Using default value: {:.2}", section, stat->pulse.frequency, settings.defaultValues.pulse.frequency);
+                stat->pulse.frequency = settings.defaultValues.pulse.frequency;
+            }
+            if (stat->pulse.depth < 0.0f || stat->pulse.depth > 1.0f) {
+                logger::warn("INI Config: {} Section: PulseDepth '{:.2}' must be in range 0 to 1: Clamping", section, stat->pulse.depth);
+                stat->pulse.depth = std::clamp(stat->pulse.depth, 0.0f, 1.0f);
+            }
+            if (stat->pulse.rise < 0.0f) {
+                logger::warn("INI Config: {} Section: PulseRise '{:.2}' is less than 0: Using 0", section, stat->pulse.rise);
+                stat->pulse.rise = 0.0f;
+            }
+        }
+        // noise filter on the sampled stat, so regen jitter doesn't keep re-triggering the imod (try variations on key)
+        std::string iniFilter = "";
+        for (auto key: {"Filter","StatFilter","NoiseFilter","Smoothing"}) {
+            iniFilter = iniStruct.get(section).get(key);
+            if (!iniFilter.empty()) break;
+        }
+        if (!iniFilter.empty()) {
+            stat->filter.kind = filter::getKindString(normalizeStr(iniFilter));
+            if (stat->filter.kind == filter::Kind::None && normalizeStr(iniFilter) != "none" && normalizeStr(iniFilter) != "false") {
+                logger::warn("INI Config: {} Section: No match for Filter '{}' (ema, oneeuro or hysteresis): Filter disabled", section, iniFilter);
+            }
+            std::vector<std::pair<float*, std::string>> filterValues = {
+                {&stat->filter.time, "FilterTime"},
+                {&stat->filter.cutoff, "FilterCutoff"},
+                {&stat->filter.beta, "FilterBeta"},
+                {&stat->filter.band, "FilterBand"},
+                {&stat->filter.spike, "FilterSpike"}
+            };
+            for (auto [dest, key]: filterValues) {
+                auto iniVal = iniStruct.get(section).get(key);
+                if (iniVal.empty()) continue;
+                if (auto value = readNumber(section, key, iniVal)) *dest = *value;
+            }
+            for (auto [value, fallback, key]: {
+                std::tuple{&stat->filter.time, settings.defaultValues.filter.time, "FilterTime"},
+                std::tuple{&stat->filter.cutoff, settings.defaultValues.filter.cutoff, "FilterCutoff"},
+                std::tuple{&stat->filter.band, settings.defaultValues.filter.band, "FilterBand"}}) {
+                if (*value <= 0.0f) {
+                    logger::warn("INI Config: {} Section: {} '{:.2}' must be above 0: Using default value: {:.2}", section, key, *value, fallback);
+                    *value = fallback;
+                }
+            }
+            if (stat->filter.beta < 0.0f) {
+                logger::warn("INI Config: {} Section: FilterBeta '{:.2}' is less than 0: Using 0", section, stat->filter.beta);
+                stat->filter.beta = 0.0f;
+            }
+            if (stat->filter.spike < 0.0f) {
+                logger::warn("INI Config: {} Section: FilterSpike '{:.2}' is less than 0: Spikes are filtered too", section, stat->filter.spike);
+                stat->filter.spike = 0.0f;
+            }
+        }
+        // extrapolate the filtered stat ahead by this many updates, so the effect keeps up with fast drains (try variations on key)
+        std::string iniPredict = "";
+        for (auto key: {"Predict","Prediction","PredictAhead","Lookahead"}) {
+            iniPredict = iniStruct.get(section).get(key);
+            if (!iniPredict.empty()) break;
+        }
+        if (!iniPredict.empty()) {
+            auto normalized = normalizeStr(iniPredict);
+            if (normalized == "true" || normalized == "on") stat->predict.lead = 1.0f;
+            else if (normalized == "false" || normalized == "off" || normalized == "none") stat->predict.lead = 0.0f;
+            else if (auto value = readNumber(section, "Predict", iniPredict)) stat->predict.lead = std::max(0.0f, *value);
+            for (auto [dest, key]: {std::pair{&stat->predict.limit, "PredictLimit"}, std::pair{&stat->predict.reversal, "PredictReversal"}}) {
+                auto iniVal = iniStruct.get(section).get(key);
+                if (iniVal.empty()) continue;
+                if (auto value = readNumber(section, key, iniVal)) *dest = *value;
+            }
+            if (stat->predict.limit <= 0.0f || stat->predict.limit > 1.0f) {
+                logger::warn("INI Config: {} Section: PredictLimit '{:.2}' must be above 0 and at most 1: Using default value: {:.2}", section, stat->predict.limit, settings.defaultValues.predict.limit);
+                stat->predict.limit = settings.defaultValues.predict.limit;
+            }
+            if (stat->predict.reversal < 0.0f) {
+                logger::warn("INI Config: {} Section: PredictReversal '{:.2}' is less than 0: Using 0", section, stat->predict.reversal);
+                stat->predict.reversal = 0.0f;
+            }
+        }
+        // actor(s) this overlay follows, and how multiple actors are combined (try variations on key)
+        std::string iniTarget = "";
+        for (auto key: {"Target","Actor","ActorTarget","BindTo","Follow"}) {
+            iniTarget = iniStruct.get(section).get(key);
+            if (!iniTarget.empty()) break;
+        }
+        if (!iniTarget.empty()) {
+            stat->target = actors::getTargetString(normalizeStr(iniTarget), &stat->aggregate);
+            if (stat->target == actors::Target::Player && normalizeStr(iniTarget) != "player") {
+                logger::warn("INI Config: {} Section: No match for Target '{}': Using 'player' default", section, iniTarget);
+            }
+        }
+        std::string iniAggregate = "";
+        for (auto key: {"Aggregate","Aggregation","Combine","CombineBy"}) {
+            iniAggregate = iniStruct.get(section).get(key);
+            if (!iniAggregate.empty()) break;
+        }
+        if (!iniAggregate.empty()) {
+            stat->aggregate = actors::getAggregateString(normalizeStr(iniAggregate));
+            if (stat->aggregate == actors::Aggregate::Min && normalizeStr(iniAggregate) != "min") {
+                logger::warn("INI Config: {} Section: No match for Aggregate '{}': Using 'min' default", section, iniAggregate);
+            }
+        }
+        // a stat another plugin pushes through the plugin API, followed instead of the actor value (try variations on key)
+        std::string iniSource = "";
+        for (auto key: {"Source","StatSource","ExternalSource","Meter"}) {
+            iniSource = iniStruct.get(section).get(key);
+            if (!iniSource.empty()) break;
+        }
+        if (!iniSource.empty() && normalizeStr(iniSource) != "none") {
+            stat->source = sources::registry.bind(normalizeStr(iniSource));
+            if (stat->source == sources::none) {
+                logger::warn("INI Config: {} Section: Could not bind Source '{}' (letters, digits and _, up to {} characters, at most {} sources): Using its actor value", section, iniSource, sources::maxName - 1, sources::maxSources);
+            } else if (sources::registry.updates(stat->source) == 0) {
+                logger::info("INI Config: {} Section: Source '{}' has no values yet: Full until its plugin pushes one", section, sources::registry.name(stat->source));
+            }
+        }
+        // player situations the overlay runs in, e.g. "combat" or "weapondrawn, !sneaking" (try variations on key)
+        std::string iniCondition = "";
+        for (auto key: {"Conditions","Condition","When","OnlyWhen","Gate"}) {
+            iniCondition = iniStruct.get(section).get(key);
+            if (!iniCondition.empty()) break;
+        }
+        if (!iniCondition.empty() && !conditions::parse(normalizeStr(iniCondition), stat->condition)) {
+            logger::warn("INI Config: {} Section: Could not understand Conditions '{}' (combat, weapondrawn, sneaking, each optionally with '!'): Using 'always' default", section, iniCondition);
+        }
+        // seconds to fade out over when the conditions stop holding, instead of clearing at once (try variations on key)
+        std::string iniReleaseTime = "";
+        for (auto key: {"ReleaseTime","Release","FadeOutTime","ReleaseFade"}) {
+            iniReleaseTime = iniStruct.get(section).get(key);
+            if (!iniReleaseTime.empty()) break;
+        }
+        if (!iniReleaseTime.empty()) {
+            auto value = readNumber(section, "ReleaseTime", iniReleaseTime);
+            if (value && *value >= 0.0f) stat->releaseTime = static_cast<int>(round(*value * 1000.0f));
+            else if (value) logger::warn("INI Config: {} Section: ReleaseTime '{:.2}' is less than 0: Clearing at once", section, *value);
+        }
+        // intensity formula (see expr.h), compiled here. Without one, the Range and Curve above make the default (try variations on key)
+        const expr::Context context{stat->startFraction, stat->endFraction, stat->easingFunction};
+        stat->intensity = expr::defaultProgram(context);
+        std::string iniIntensity = "";
+        for (auto key: intensityKeys) {
+            iniIntensity = iniStruct.get(section).get(key);
+            if (!iniIntensity.empty()) break;
+        }
+        if (!iniIntensity.empty()) {
+            auto program = expr::compile(iniIntensity, context);
+            if (!program) {
+                logger::warn("INI Config: {} Section: Could not understand Intensity '{}' ({} at character {}): Using default '{}'", section, iniIntensity, expr::describe(program.error()), program.error().position+1, stat->intensity.source);
+            } else {
+                stat->intensity = std::move(*program);
+                if (stat->keyframes > 1) {
+                    logger::warn("INI Config: {} Section: Keyframes bake the Curve, not an Intensity formula: Ignoring Keyframes", section);
+                    stat->keyframes = 0;
+                }
+            }
+        }
+        // log the final stats for this section
+        if (stat->enabled) logger::info("SETTINGS LOADED: [{}] EditorID:'{}' Tint:({:.2},{:.2},{:.2},{:.2}) Contrast:(x{:.2}+{:.2}) Brightness:(x{:.2}+{:.2}) Saturation:(x{:.2}+{:.2}) Range:({:.2},{:.2}) Curve:'{}' Intensity:'{}' Delta:({:.4},-{:.4},+{:.4}) Every:{}ms Keyframes:{} Pulse:'{}'({:.2}Hz x{:.2} +{:.2}) Filter:'{}'(spike {:.2}) Predict:{:.2}(limit {:.2}) Target:'{}'({}) Source:'{}' When:'{}'(release {}ms)", section, stat->editorID, stat->tint.red, stat->tint.green, stat->tint.blue, stat->tint.alpha, stat->contrastMult, stat->contrastAdd, stat->brightnessMult, stat->brightnessAdd, stat->saturationMult, stat->saturationAdd, stat->endFraction, stat->startFraction, easingf::describe(stat->easingFunction), stat->intensity.source, stat->minDelta, stat->maxDelta, stat->maxDeltaPos, stat->updateInterval, stat->keyframes, oscillator::getStringWaveform(stat->pulse.waveform), stat->pulse.frequency, stat->pulse.depth, stat->pulse.rise, filter::getStringKind(stat->filter.kind), stat->filter.spike, stat->predict.lead, stat->predict.limit, actors::getStringTarget(stat->target), actors::getStringAggregate(stat->aggregate), sources::registry.name(stat->source), conditions::describe(stat->condition), stat->releaseTime);
+        else logger::info("SETTINGS LOADED: [{}] Disabled", section);
+    };
+    initOverlay(&(settings.health), "Health", iniStruct);
+    initOverlay(&(settings.magicka), "Magicka", iniStruct);
+    initOverlay(&(settings.stamina), "Stamina", iniStruct);
+    // tiered stages: every [Health:Name] section in file order, read as its stat's section with the stage's keys on top
+    // (its own form, and Below/Blend as a shorthand for Range), then compiled into the stat's breakpoint table
+    for (auto [statStages, base, section, prefix]: {
+        std::tuple{&settings.healthStages, &settings.health, "Health", std::string("health:")},
+        std::tuple{&settings.magickaStages, &settings.magicka, "Magicka", std::string("magicka:")},
+        std::tuple{&settings.staminaStages, &settings.stamina, "Stamina", std::string("stamina:")}}) {
+        statStages->looks.clear();
+        for (auto const& [sectionName, stageSection]: iniStruct) {
+            if (!sectionName.starts_with(prefix)) continue;
+            if (statStages->looks.size() >= stages::maxStages) {
+                logger::warn("INI Config: {} Section: more than {} stages: Ignoring [{}]", section, stages::maxStages, sectionName);
+                continue;
+            }
+            mINI::INIStructure merged;
+            merged[sectionName] = iniStruct.get(section);
+            for (auto key: editorIDKeys) { merged[sectionName].remove(key); }
+            for (auto key: intensityKeys) { merged[sectionName].remove(key); }
+            for (auto const& [key, value]: stageSection) { merged[sectionName].set(key, value); }
+            Settings::OverlayData look;
+            initOverlay(&look, sectionName, merged);
+            if (!look.enabled) continue;
+            if (look.editorID == base->editorID) {
+                logger::warn("INI Config: [{}]: a stage needs an imod form of its own, not [{}]'s '{}': Ignoring stage", sectionName, section, look.editorID);
+                continue;
+            }
+            // Below = 0.3 starts the stage at 30%, and Blend (default 0.05) is how far below that it reaches full strength
+            auto iniBelow = stageSection.get("Below");
+            if (!iniBelow.empty()) {
+                auto below = readNumber(sectionName, "Below", iniBelow);
+                float blend = 0.05f;
+                auto iniBlend = stageSection.get("Blend");
+                if (!iniBlend.empty()) {
+                    if (auto value = readNumber(sectionName, "Blend", iniBlend)) blend = *value;
+                }
+                if (below && *below >= 0.0f && *below <= 1.0f && blend >= 0.0f) {
+                    look.startFraction = *below;
+                    look.endFraction = std::max(0.0f, *below - blend);
+                } else if (below) {
+                    logger::warn("INI Config: [{}]: Below '{:.2}' must be in range 0 to 1 and Blend '{:.2}' at least 0: Using Range", sectionName, *below, blend);
+                }
+            }
+            // a stage is driven by a single key, at the strength its own curve gives the stat's smoothed value
+            if (look.keyframes > 1 || look.pulse.waveform != oscillator::Waveform::None || std::any_of(intensityKeys.begin(), intensityKeys.end(), [&](auto key) { return stageSection.has(key); })) {
+                logger::warn("INI Config: [{}]: stages have no Keyframes, Pulse or Intensity of their own: Ignoring them", sectionName);
+                look.keyframes = 0;
+                look.pulse.waveform = oscillator::Waveform::None;
+            }
+            statStages->looks.push_back(look);
+        }
+        std::vector<stages::Range> ranges;
+        for (auto &look: statStages->looks) { ranges.push_back({look.startFraction, look.endFraction}); }
+        statStages->table.compile(ranges);
+        for (std::size_t i = 0; i < statStages->looks.size(); i++) {
+            auto &look = statStages->looks[i];
+            logger::info("SETTINGS LOADED: [{}] Stage {}: EditorID:'{}' Range:({:.2},{:.2}) Curve:'{}'", section, i+1, look.editorID, look.endFraction, look.startFraction, easingf::describe(look.easingFunction));
+        }
+        if (!statStages->looks.empty()) {
+            logger::info("SETTINGS LOADED: [{}] Stages:{} Breakpoints:{}", section, statStages->table.size(), statStages->table.points().size());
+        }
+    }
+    ResetProfiles(settings, profiles);
+    // compile each [Profile:Name] section: the base sections, with the profile's Stat.Setting keys (e.g. Health.Tint) on top
+    for (auto const& [sectionName, profileSection]: iniStruct) {
+        if (!sectionName.starts_with("profile:")) continue;
+        auto profile = std::make_unique<Profile>();
+        profile->name = sectionName.substr(8);
+        logger::info("INI Config: Compiling profile '{}'", profile->name);
+        mINI::INIStructure merged;
+        for (auto stat: {"Health","Magicka","Stamina"}) { merged[stat] = iniStruct.get(stat); }
+        for (auto const& [key, value]: profileSection) {
+            auto dot = key.find('.');
+            if (dot == std::string::npos || !merged.has(key.substr(0, dot))) {
+                logger::warn("INI Config: Profile '{}': '{}' is not a Stat.Setting key (e.g. Health.Tint): Ignoring", profile->name, key);
+                continue;
+            }
+            merged[key.substr(0, dot)].set(key.substr(dot+1), value);
+        }
+        for (auto [stat, base, section]: {
+            std::tuple{&profile->health, &settings.health, "Health"},
+            std::tuple{&profile->magicka, &settings.magicka, "Magicka"},
+            std::tuple{&profile->stamina, &settings.stamina, "Stamina"}}) {
+            initOverlay(stat, section, merged);
+            // every profile drives the same imod form, so only the base config picks it
+            if (stat->enabled && !stat->editorID.empty() && stat->editorID != base->editorID) {
+                logger::warn("INI Config: Profile '{}': {} EditorID can only be set in the base [{}] section: Using '{}'", profile->name, section, section, base->editorID);
+            }
+            stat->editorID = base->editorID;
+        }
+        profiles.bank.push_back(std::move(profile));
+    }
+    // start on the profile named in [Global] Profile, if there is one
+    if (!settings.profile.empty()) {
+        auto found = std::find_if(profiles.bank.begin(), profiles.bank.end(), [&settings, strLower](auto &profile) { return profile->name == strLower(settings.profile); });
+        if (found == profiles.bank.end()) {
+            logger::warn("INI Config: Global Section: No profile named '{}': Using the base config", settings.profile);
+        } else {
+            profiles.index = static_cast<std::size_t>(found - profiles.bank.begin());
+            profiles.active.store(found->get(), std::memory_order_release);
+        }
+    }
+    // log
+    logger::info("INI Config: ALL SETTINGS DONE LOADING FROM INI FILE");
+    logger::info("SETTINGS LOADED: [Global] SleepTime:'{}' Reload:'{}' Telemetry:'{}' LogLevel:'{}' Faults:(budget {}, backoff {}-{} ticks) Profiles:{} (active '{}', hotkey {}) Trace:'{}'(hotkey {}, {} events)", settings.sleepTime, settings.reload, settings.telemetryFeed ? settings.telemetryName : "off", settings.logLevel, settings.faults.budget, settings.faults.backoffTicks, settings.faults.maxBackoffTicks, profiles.bank.size(), profiles.active.load()->name, settings.profileHotkey, settings.trace, settings.traceHotkey, settings.traceEvents);
+}
@@ -0,0 +1,158 @@
+/* Settings model: every overlay's configuration, the profile bank, and reading both from a parsed ini.
+ * ----------
+ * Game-independent (part of statfx_core). The plugin reads the file and hands the parsed structure to
+ * ReadSettings, which fills in the settings and compiles every profile.
+ *
+ * usage:
+ * Settings settings; Profiles profiles;
+ * ReadSettings(iniStruct, settings, profiles);
+ * auto profile = profiles.active.load();
+*/
+#pragma once
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#include "ini.h"
+#include "easing.h"
+#include "easingf.h"
+#include "timeline.h"
+#include "oscillator.h"
+#include "filter.h"
+#include "predict.h"
+#include "stages.h"
+#include "expr.h"
+#include "actors.h"
+#include "sources.h"
+#include "telemetry.h"
+#include "breaker.h"
+#include "conditions.h"
+#include "trace.h"
+
+// linear rgba color, each channel 0 to 1
+struct Color {
+    float red = 0.0f;
+    float green = 0.0f;
+    float blue = 0.0f;
+    float alpha = 0.0f;
+};
+
+// settings to be filled in from ini file
+class Settings {
+    public:
+    struct OverlayData {
+        bool enabled = true;
+        std::string editorID;
+        Color tint = {1.0f, 1.0f, 1.0f, 0.0f};
+        float contrastAdd = 0.0f;
+        float contrastMult = 1.0f;
+        float brightnessAdd = 0.0f;
+        float brightnessMult = 1.0f;
+        float saturationAdd = 0.0f;
+        float saturationMult = 1.0f;
+        float startFraction = 1.0f;
+        float endFraction = 0.0f;
+        easing::easingFunction easingFunction = easing::linear;
+        float minDelta = 0.01f;
+        float maxDelta = 0.015f;
+        float maxDeltaPos = 0.015f;
+        int updateInterval = 25; // ms between this overlay's updates, the Global SleepTime unless it sets its own
+        int keyframes = 0; // 0 = single key driven by Trigger strength, 2+ = curve baked into the imod timeline
+        oscillator::Settings pulse;
+        filter::Settings filter; // noise filter on the sampled stat, off by default
+        predict::Settings predict; // extrapolation of the filtered stat, off by default
+        actors::Target target = actors::Target::Player;
+        actors::Aggregate aggregate = actors::Aggregate::Min;
+        int source = sources::none; // a plugin's stat (Source key, see sources.h) followed instead of an actor value
+        conditions::Condition condition; // player situations the overlay runs in, always by default
+        int releaseTime = 0; // ms to fade out over when the conditions stop holding, 0 = clear at once
+        expr::Program intensity = expr::defaultProgram(expr::Context()); // compiled Intensity, or ease(range(stat)) with this Range and Curve
+    } stamina, magicka, health, defaultValues;
+    const std::vector<OverlayData*> stats = {&stamina, &magicka, &health};
+    // tiered stages of a stat ([Health:Name] sections, see stages.h). They follow the stat's own overlay (its sampling,
+    // smoothing and schedule) and are the same in every profile
+    struct Stages {
+        std::vector<OverlayData> looks; // in file order, each with its own imod form
+        stages::Table table;            // compiled from the looks' ranges
+    } staminaStages, magickaStages, healthStages;
+    int sleepTime = 25;
+    std::string iniPath = "StatFX.ini";
+    bool reload = true;
+    bool telemetryFeed = false;
+    std::string telemetryName = telemetry::defaultName;
+    std::string logLevel = "info";
+    breaker::Settings faults;
+    std::string profile = "";  // profile to start on, empty for the base config
+    int profileHotkey = 0;     // keyboard scan code that cycles through the profiles, 0 = none
+    bool trace = false;        // record the timeline tracer from the start (see trace.h)
+    int traceHotkey = 0;       // keyboard scan code that starts the tracer, or stops it and writes the trace, 0 = none
+    int traceEvents = static_cast<int>(trace::defaultCapacity); // events the tracer keeps per thread
+    const std::map<std::string, std::string> defaultEditorIDs = {
+        {"Stamina", "StatFXImodStam"},
+        {"Magicka", "StatFXImodMag"},
+        {"Health", "StatFXImodHealth"}
+    };
+    // reset to default values
+    void Reset() {
+        stamina = OverlayData();
+        magicka = OverlayData();
+        health = OverlayData();
+        staminaStages = Stages();
+        magickaStages = Stages();
+        healthStages = Stages();
+        sleepTime = 25;
+        iniPath = "StatFX.ini";
+        reload = true;
+        telemetryFeed = false;
+        telemetryName = telemetry::defaultName;
+        logLevel = "info";
+        faults = breaker::Settings();
+        profile = "";
+        profileHotkey = 0;
+        trace = false;
+        traceHotkey = 0;
+        traceEvents = static_cast<int>(trace::defaultCapacity);
+    }
+};
+
+// A named preset of every overlay's settings. Compiled once when the config loads (settings in ReadSettings, baked
+// tracks in the plugin's initForms), so switching between profiles needs no file access or parsing
+struct Profile {
+    std::string name;
+    Settings::OverlayData stamina, magicka, health;
+    timeline::Track staminaTrack, magickaTrack, healthTrack; // baked imod timeline, for overlays that use Keyframes
+};
+
+// All compiled profiles. The first is the base config ([Health], [Magicka] and [Stamina] sections), followed by
+// each [Profile:Name] section in file order. The main thread reads the overlay settings through active.
+// Once the main thread runs, only it switches profiles or replaces the bank: a reload offers a new bank and the
+// profile hotkey counts a press, and the main thread takes both between ticks, so nothing frees a profile it still reads
+struct Profiles {
+    using Bank = std::vector<std::unique_ptr<Profile>>;
+    Bank bank;
+    std::atomic<Profile*> active = nullptr;
+    std::size_t index = 0;
+    std::atomic<unsigned> cycles = 0; // profile hotkey presses not taken yet, each steps on to the next profile
+
+    // hand a freshly loaded bank to the main thread, to start on profile start. An empty bank is not offered
+    void offer(Bank loaded, std::size_t start);
+    // on the main thread: swap in an offered bank (the old one is moved to retired, for the caller to free once active
+    // points into the new one) and step on by the hotkey presses. The index of the profile to switch to, if any.
+    // Parses and allocates nothing
+    std::optional<std::size_t> take(Bank &retired);
+
+private:
+    std::mutex handoff;
+    std::optional<std::pair<Bank, std::size_t>> offered;
+    std::atomic<bool> pending = false;
+};
+
+// rebuild the bank with only the base config, taken from the current settings
+void ResetProfiles(const Settings &settings, Profiles &profiles);
+
+// fill in settings from a parsed ini (on top of their current values, call Reset first for a clean read) and compile
+// the profile bank. Every value that can't be understood is logged and left at its default. LogLevel is not read here
+void ReadSettings(const mINI::INIStructure &iniStruct, Settings &settings, Profiles &profiles);
@@ -0,0 +1,122 @@
+/* External stat sources: named stats other plugins push through the plugin API (statfxapi.h), for overlays to follow.
+ * ----------
+ * A fixed table of up to maxSources named slots, shared by every plugin. A name gets its slot the first time it is
+ * bound, by a plugin registering it or by an ini section's Source key (whichever comes first), and keeps it until the
+ * game exits, so a source registered after the config loads still reaches the overlays bound to it. Binding takes a
+ * lock (registration and config loads only). Pushing and reading never do: a slot's value and its update count are
+ * one 64-bit atomic, written whole by its source's plugin and read whole by the overlay thread every tick.
+ *
+ * usage:
+ * auto hunger = sources::registry.bind("hunger");
+ * sources::registry.push(hunger, 0.8f); // the source's plugin, any thread
+ * float value = sources::registry.value(hunger); // overlay thread, every tick
+*/
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include "statfxapi.h"
+
+namespace sources
+{
+    constexpr std::size_t maxSources = 32;
+    constexpr std::size_t maxName = 32; // including the terminator
+    constexpr int none = StatFXAPI::invalidSource;
+
+    class Registry {
+    public:
+        // a source's index by name, adding it if it's new. none for a bad name (see statfxapi.h) or a full table
+        int bind(std::string_view name) {
+            if (!valid(name)) { return none; }
+            std::lock_guard guard(lock);
+            if (auto found = find(name); found != none) { return found; }
+            auto index = count.load(std::memory_order_relaxed);
+            if (index >= maxSources) { return none; }
+            auto &slot = slots[index];
+            std::transform(name.begin(), name.end(), slot.name.begin(), [](char c) { return static_cast<char>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c); });
+            slot.name[name.size()] = '\0';
+            slot.packed.store(initial, std::memory_order_relaxed);
+            count.store(index + 1, std::memory_order_release); // publishes the name
+            return static_cast<int>(index);
+        }
+
+        // a source's index by name without adding it, none if nobody bound it. Lock-free
+        int find(std::string_view name) const {
+            auto n = count.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < n; i++) {
+                std::string_view known(slots[i].name.data());
+                if (known.size() == name.size() && std::equal(known.begin(), known.end(), name.begin(), [](char a, char b) {
+                    return a == (b >= 'A' && b <= 'Z' ? b - 'A' + 'a' : b);
+                })) { return static_cast<int>(i); }
+            }
+            return none;
+        }
+
+        // set a source's value, clamped to 0 to 1. Lock-free and wait-free. False for an unknown source or a non-number
+        bool push(int source, float value) {
+            if (!bound(source) || !std::isfinite(value)) { return false; }
+            auto &packed = slots[source].packed;
+            auto updates = (packed.load(std::memory_order_relaxed) >> 32) + 1;
+            packed.store((updates << 32) | std::bit_cast<std::uint32_t>(std::clamp(value, 0.0f, 1.0f)), std::memory_order_release);
+            return true;
+        }
+
+        // a source's last value and how many pushes it took to get there (wraps at 2^32), both from the same push
+        struct Reading {
+            float value = 1.0f;
+            std::uint32_t updates = 0;
+        };
+        Reading read(int source) const {
+            if (!bound(source)) { return {}; }
+            auto packed = slots[source].packed.load(std::memory_order_acquire);
+            return {std::bit_cast<float>(static_cast<std::uint32_t>(packed)), static_cast<std::uint32_t>(packed >> 32)};
+        }
+
+        // a source's last value, 1 (full, no effect) until something is pushed or for an unknown source. Lock-free
+        float value(int source) const { return read(source).value; }
+        std::uint32_t updates(int source) const { return read(source).updates; }
+
+        const char* name(int source) const { return bound(source) ? slots[source].name.data() : "none"; }
+        std::size_t size() const { return count.load(std::memory_order_acquire); }
+
+        // letters, digits and _, 1 to maxName - 1 characters
+        static bool valid(std::string_view name) {
+            return !name.empty() && name.size() < maxName && std::all_of(name.begin(), name.end(), [](char c) {
+                return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+            });
+        }
+
+    private:
+        static constexpr std::uint64_t initial = 0x3F800000; // no updates, and 1.0f
+        struct Slot {
+            std::array<char, maxName> name = {};
+            std::atomic<std::uint64_t> packed = initial; // update count in the high half, the value's float bits in the low half
+        };
+
+        bool bound(int source) const { return source >= 0 && static_cast<std::size_t>(source) < count.load(std::memory_order_acquire); }
+
+        std::array<Slot, maxSources> slots;
+        std::atomic<std::size_t> count = 0; // slots in use, each name written before it's counted
+        std::mutex lock;                    // bind only
+    };
+
+    // the one table every plugin and the overlay thread share
+    inline Registry registry;
+
+    // the plugin API (statfxapi.h) over the registry, handed out to other plugins
+    class Api final : public StatFXAPI::IStatFX1 {
+    public:
+        StatFXAPI::Version GetVersion() const override { return StatFXAPI::Version::V1; }
+        StatFXAPI::Source RegisterSource(const char *name) override { return name ? registry.bind(name) : none; }
+        bool Push(StatFXAPI::Source source, float value) override { return registry.push(source, value); }
+        float Get(StatFXAPI::Source source) const override { return registry.value(source); }
+    };
+
+    inline Api api;
+}
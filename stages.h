@@ -0,0 +1,114 @@
+/* Tiered stages of a stat: extra overlays on the same stat, each with its own look, curve and imod form, that take over
+ * at lower and lower values (say a subtle tint below 60%, desaturation below 30%, a different imod below 10%).
+ * ----------
+ * Each stage is off above its start, ramps along its curve down to its end, and stays full below that. Stages whose
+ * ranges overlap blend: the lower one fades in while the one above is still fading. A table compiled once from the
+ * stages' ranges sorts every start and end into breakpoints, and records each stage's state in every segment between
+ * two of them. A tick checks whether the stat is still in last tick's segment (nearly always, as stats move a little a
+ * tick) and only searches the breakpoints when it left, then only touches the imods of stages that ramp in that
+ * segment or changed state since the last tick. The lookup itself is no faster than classifying every stage until
+ * there are more than a handful of stages (tools/stage_bench.cpp); what the table saves is the imod updates.
+ *
+ * usage:
+ * stages::Table table;
+ * table.compile(ranges);
+ * auto segment = table.find(0.42f, cursor.segment);
+ * if (table.state(segment, 2) == stages::State::Ramping) { ... }
+*/
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace stages
+{
+    // most stages a stat can have
+    constexpr std::size_t maxStages = 32;
+
+    enum class State : std::uint8_t { Off, Ramping, Full };
+
+    // a stage's stat range: off at or above start, full below end
+    struct Range {
+        float start = 1.0f;
+        float end = 0.0f;
+    };
+
+    // state of a stage at a stat value, straight from its range
+    inline State classify(const Range &range, float value) {
+        if (value >= range.start) { return State::Off; }
+        if (value < range.end) { return State::Full; }
+        return State::Ramping;
+    }
+
+    class Table {
+    public:
+        static constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+
+        // compile the breakpoints and per-segment states of the stages' ranges (in any order, at most maxStages)
+        void compile(std::span<const Range> ranges) {
+            count = std::min(ranges.size(), maxStages);
+            breakpoints.clear();
+            for (std::size_t i = 0; i < count; i++) {
+                breakpoints.push_back(ranges[i].start);
+                breakpoints.push_back(ranges[i].end);
+            }
+            std::sort(breakpoints.begin(), breakpoints.end());
+            breakpoints.erase(std::unique(breakpoints.begin(), breakpoints.end()), breakpoints.end());
+            // segment s holds the values from breakpoint s-1 (included) up to breakpoint s, so every stage has one state in it
+            states.assign(segments() * count, State::Off);
+            ramping.clear();
+            firstRamping.assign(segments() + 1, 0);
+            for (std::size_t s = 0; s < segments(); s++) {
+                firstRamping[s] = static_cast<std::uint16_t>(ramping.size());
+                float low = s == 0 ? -std::numeric_limits<float>::infinity() : breakpoints[s - 1];
+                float high = s == breakpoints.size() ? std::numeric_limits<float>::infinity() : breakpoints[s];
+                for (std::size_t i = 0; i < count; i++) {
+                    auto &range = ranges[i];
+                    auto state = low >= range.start ? State::Off : high <= range.end ? State::Full : State::Ramping;
+                    states[s * count + i] = state;
+                    if (state == State::Ramping) { ramping.push_back(static_cast<std::uint8_t>(i)); }
+                }
+            }
+            firstRamping[segments()] = static_cast<std::uint16_t>(ramping.size());
+        }
+
+        std::size_t size() const { return count; }
+        std::size_t segments() const { return breakpoints.size() + 1; }
+        std::span<const float> points() const { return breakpoints; }
+
+        // segment a stat value falls in
+        std::size_t find(float value) const {
+            return static_cast<std::size_t>(std::upper_bound(breakpoints.begin(), breakpoints.end(), value) - breakpoints.begin());
+        }
+
+        // the same, trying hint (the segment of the last tick) first: between two ticks the stat almost always stays put
+        std::size_t find(float value, std::size_t hint) const {
+            if (hint < segments() && (hint == 0 || breakpoints[hint - 1] <= value) && (hint == breakpoints.size() || value < breakpoints[hint])) { return hint; }
+            return find(value);
+        }
+
+        State state(std::size_t segment, std::size_t stage) const { return states[segment * count + stage]; }
+
+        // stages that ramp in a segment, in stage order
+        std::span<const std::uint8_t> rampingIn(std::size_t segment) const {
+            return std::span<const std::uint8_t>(ramping).subspan(firstRamping[segment], firstRamping[segment + 1] - firstRamping[segment]);
+        }
+
+    private:
+        std::size_t count = 0;
+        std::vector<float> breakpoints;          // every start and end, sorted and unique
+        std::vector<State> states;               // segments() x count
+        std::vector<std::uint8_t> ramping;       // ramping stages of each segment, back to back
+        std::vector<std::uint16_t> firstRamping; // where each segment's ramping stages begin
+    };
+
+    // where a stat's stages were last driven to. Reset whenever their imods are stopped, so the next tick touches them all
+    struct Cursor {
+        std::size_t segment = Table::none;
+        float value = 0.0f;
+        void reset() { segment = Table::none; }
+    };
+}
@@ -0,0 +1,61 @@
+/* StatFX plugin API: lets other SKSE plugins drive StatFX overlays with stats of their own (hunger, cold, fatigue...).
+ * ----------
+ * Copy this header into your plugin. It depends on nothing but the standard library. Ask StatFX for the interface with
+ * a message through the SKSE messaging interface, once every plugin is loaded (kPostLoad or later). StatFX answers
+ * while the message is being dispatched, so the interface is there as soon as Dispatch returns:
+ *
+ *   StatFXAPI::InterfaceRequest request;
+ *   SKSE::GetMessagingInterface()->Dispatch(StatFXAPI::RequestInterface, &request, sizeof(request), StatFXAPI::PluginName);
+ *   if (auto statfx = request.api) {
+ *       auto hunger = statfx->RegisterSource("hunger");
+ *       statfx->Push(hunger, 0.8f); // whenever the stat changes, from any one thread
+ *   }
+ *
+ * and in StatFx.ini, an overlay follows the source instead of an actor value:
+ *   [Stamina]
+ *   Source = hunger
+ *
+ * Values are normalized like the game's stats: 1 is full (no effect), 0 is empty (full effect). A source nobody has
+ * pushed to yet reads as full. Each source has one slot that is written whole and read whole without locks: push from
+ * one thread per source. Pushes from several threads never tear, the last one simply wins.
+ * The interface is versioned: a plugin built against version 1 keeps working with StatFX builds that add later
+ * versions, and StatFX leaves api null when asked for a version it doesn't have.
+*/
+#pragma once
+#include <cstdint>
+
+namespace StatFXAPI
+{
+    constexpr const char* PluginName = "StatFX";
+
+    // the message to send StatFX, with an InterfaceRequest as its data
+    constexpr std::uint32_t RequestInterface = 0x53465801; // 'SFX' 01
+
+    enum class Version : std::uint32_t { V1 = 1 };
+
+    // a named source, or invalid
+    using Source = std::int32_t;
+    constexpr Source invalidSource = -1;
+
+    class IStatFX1 {
+    public:
+        // the interface version this is
+        virtual Version GetVersion() const = 0;
+        // register a source by name (letters, digits and _, up to 31 characters, case insensitive). Registering a name
+        // again, from any plugin, gives the same source. Returns invalidSource for a bad name or when all 32 are taken
+        virtual Source RegisterSource(const char *name) = 0;
+        // set a source's value, 0 to 1 (clamped). Lock-free, from any thread. False for an unknown source or a non-number
+        virtual bool Push(Source source, float value) = 0;
+        // the source's last value (1 if nothing was pushed yet)
+        virtual float Get(Source source) const = 0;
+
+    protected:
+        ~IStatFX1() = default;
+    };
+
+    // data of a RequestInterface message. StatFX fills in api (if it has the version asked for) before Dispatch returns
+    struct InterfaceRequest {
+        Version version = Version::V1;
+        IStatFX1 *api = nullptr;
+    };
+}
@@ -0,0 +1,198 @@
+/* Opt-in telemetry feed of live stat and intensity values, for external tools (HUDs, stream overlays, tuning dashboards).
+ * ----------
+ * A single-producer ring buffer in named shared memory. Each slot is guarded by a sequence number (seqlock):
+ * the writer marks the slot odd, writes the record, then marks it even again. Publishing is wait-free for the
+ * producer (a handful of stores, no locks, no syscalls) and readers never block the writer. A reader that falls
+ * more than a full ring behind simply skips ahead to the oldest record still available.
+ *
+ * usage (reader):
+ * telemetry::Consumer feed;
+ * if (feed.open()) { telemetry::Record r; while (feed.poll(r)) { ... } }
+*/
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace telemetry
+{
+    constexpr const char* defaultName = "StatFX.Telemetry";
+    constexpr std::uint32_t magic = 0x54584653; // "SFXT"
+    constexpr std::uint32_t version = 1;
+    constexpr std::uint32_t capacity = 1024; // records in the ring, must be a power of two
+
+    // one tick of data. Stat order is health, stamina, magicka (same as actors::Stat)
+    struct Record {
+        std::uint64_t timestampNs = 0; // steady clock, nanoseconds
+        std::uint64_t tick = 0;
+        float actual[3] = {};    // sampled stat percentages
+        float current[3] = {};   // smoothed stat percentages
+        float intensity[3] = {}; // emitted imod strength
+    };
+
+    struct Slot {
+        std::atomic<std::uint64_t> sequence; // 2n+1 while record n is being written, 2n+2 once it is complete
+        Record record;
+    };
+
+    struct Header {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t capacity;
+        std::uint32_t recordSize;
+        std::atomic<std::uint64_t> published; // number of records published so far
+    };
+
+    struct Ring {
+        Header header;
+        Slot slots[capacity];
+    };
+
+    inline std::uint64_t nowNs() {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // named shared memory mapping of the ring
+    class Mapping {
+    public:
+        Mapping() = default;
+        Mapping(const Mapping&) = delete;
+        Mapping& operator=(const Mapping&) = delete;
+        ~Mapping() { close(); }
+
+        Ring* open(const std::string &name, bool create) {
+            close();
+#ifdef _WIN32
+            auto fullName = "Local\\" + name;
+            handle = create
+                ? CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, sizeof(Ring), fullName.c_str())
+                : OpenFileMappingA(FILE_MAP_READ | FILE_MAP_WRITE, FALSE, fullName.c_str());
+            if (!handle) { return nullptr; }
+            ring = static_cast<Ring*>(MapViewOfFile(handle, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, sizeof(Ring)));
+#else
+            shmName = "/" + name;
+            int fd = shm_open(shmName.c_str(), create ? (O_CREAT | O_RDWR) : O_RDWR, 0644);
+            if (fd < 0) { return nullptr; }
+            if (create && ftruncate(fd, sizeof(Ring)) != 0) { ::close(fd); return nullptr; }
+            void *view = mmap(nullptr, sizeof(Ring), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            ::close(fd);
+            ring = view == MAP_FAILED ? nullptr : static_cast<Ring*>(view);
+            owner = create;
+#endif
+            if (!ring) { close(); }
+            return ring;
+        }
+
+        void close() {
+#ifdef _WIN32
+            if (ring) { UnmapViewOfFile(ring); }
+            if (handle) { CloseHandle(handle); }
+            handle = nullptr;
+#else
+            if (ring) { munmap(ring, sizeof(Ring)); }
+            if (owner) { shm_unlink(shmName.c_str()); }
+            owner = false;
+#endif
+            ring = nullptr;
+        }
+
+        Ring *ring = nullptr;
+
+    private:
+#ifdef _WIN32
+        HANDLE handle = nullptr;
+#else
+        std::string shmName;
+        bool owner = false;
+#endif
+    };
+
+    // the writing side, owned by the main thread
+    class Producer {
+    public:
+        bool open(const std::string &name = defaultName) {
+            Ring *ring = mapping.open(name, true);
+            if (!ring) { return false; }
+            ring->header.magic = magic;
+            ring->header.version = version;
+            ring->header.capacity = capacity;
+            ring->header.recordSize = sizeof(Record);
+            ring->header.published.store(0, std::memory_order_relaxed);
+            for (auto &slot: ring->slots) { slot.sequence.store(0, std::memory_order_relaxed); }
+            next = 0;
+            return true;
+        }
+        void close() { mapping.close(); }
+        bool isOpen() const { return mapping.ring != nullptr; }
+
+        // wait-free: never blocks or retries, regardless of readers
+        void publish(const Record &record) {
+            Ring *ring = mapping.ring;
+            if (!ring) { return; }
+            Slot &slot = ring->slots[next & (capacity - 1)];
+            slot.sequence.store(2 * next + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            std::memcpy(&slot.record, &record, sizeof(Record));
+            slot.sequence.store(2 * next + 2, std::memory_order_release);
+            ring->header.published.store(++next, std::memory_order_release);
+        }
+
+    private:
+        Mapping mapping;
+        std::uint64_t next = 0;
+    };
+
+    // the reading side, for external tools
+    class Consumer {
+    public:
+        bool open(const std::string &name = defaultName) {
+            Ring *ring = mapping.open(name, false);
+            if (!ring || ring->header.magic != magic || ring->header.version != version || ring->header.recordSize != sizeof(Record)) {
+                mapping.close();
+                return false;
+            }
+            next = ring->header.published.load(std::memory_order_acquire);
+            return true;
+        }
+        void close() { mapping.close(); }
+
+        // read the next record. Returns false when caught up with the producer
+        bool poll(Record &out) {
+            Ring *ring = mapping.ring;
+            if (!ring) { return false; }
+            for (;;) {
+                auto published = ring->header.published.load(std::memory_order_acquire);
+                if (next >= published) { return false; }
+                // lapped by the producer: skip to the oldest record that can still be intact
+                if (published - next > capacity) {
+                    dropped += published - capacity - next;
+                    next = published - capacity;
+                }
+                Slot &slot = ring->slots[next & (capacity - 1)];
+                auto before = slot.sequence.load(std::memory_order_acquire);
+                std::memcpy(&out, &slot.record, sizeof(Record));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                auto after = slot.sequence.load(std::memory_order_relaxed);
+                if (before == after && before == 2 * next + 2) { next++; return true; }
+                // torn or overwritten while copying: count it and move on
+                dropped++;
+                next++;
+            }
+        }
+
+        std::uint64_t dropped = 0; // records skipped because the reader fell behind or caught a slot mid-write
+
+    private:
+        Mapping mapping;
+        std::uint64_t next = 0;
+    };
+}
@@ -0,0 +1,88 @@
+// actors.h and overlay::ActorSets: every aggregate of a batch against computing it per stat, an empty set reading as
+// full stats, and a tick sampling only the sets it was asked for
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <random>
+#include "check.h"
+#include "standins.h"
+
+static check::Case aggregates("actors.aggregates", []() {
+    std::mt19937 random(28);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    bool same = true;
+    actors::SampleBatch batch;
+    for (std::size_t n: {1, 2, 10, 100}) {
+        batch.clear();
+        std::vector<std::array<float, actors::StatCount>> actors(n);
+        for (auto &actor: actors) {
+            actor = {unit(random), unit(random), unit(random)};
+            batch.push(actor[actors::Health], actor[actors::Stamina], actor[actors::Magicka]);
+        }
+        auto out = actors::aggregate(batch);
+        auto lowest = std::min_element(actors.begin(), actors.end(), [](auto &a, auto &b) { return a[actors::Health] < b[actors::Health]; });
+        same = same && out.count == n;
+        for (int s = 0; s < actors::StatCount; s++) {
+            float min = 2.0f, max = -1.0f, sum = 0.0f;
+            for (auto &actor: actors) { min = std::min(min, actor[s]); max = std::max(max, actor[s]); sum += actor[s]; }
+            auto stat = static_cast<actors::Stat>(s);
+            same = same && out.get(actors::Aggregate::Min, stat) == min && out.get(actors::Aggregate::Max, stat) == max
+                && out.get(actors::Aggregate::Average, stat) == sum / n && out.get(actors::Aggregate::LowestHealth, stat) == (*lowest)[s];
+        }
+    }
+    check::expect(same, "one pass gives the min, max, average and lowest-health actor's stats");
+    batch.clear();
+    // a broken read among good ones shows in every aggregate of its stat, so the overlay's tick faults on it
+    batch.push(0.5f, 0.5f, 0.5f);
+    batch.push(0.2f, std::numeric_limits<float>::quiet_NaN(), 0.3f);
+    auto broken = actors::aggregate(batch);
+    check::expect(std::isnan(broken.get(actors::Aggregate::Min, actors::Stamina)) && std::isnan(broken.get(actors::Aggregate::Max, actors::Stamina)) && std::isnan(broken.get(actors::Aggregate::Average, actors::Stamina)), "a NaN read isn't hidden by min or max");
+    check::expect(broken.get(actors::Aggregate::Min, actors::Health) == 0.2f && broken.get(actors::Aggregate::LowestHealth, actors::Magicka) == 0.3f, "the other stats aggregate as usual");
+    batch.clear();
+    auto empty = actors::aggregate(batch);
+    check::expect(empty.count == 0 && empty.get(actors::Aggregate::Min, actors::Health) == 1.0f && empty.get(actors::Aggregate::Average, actors::Magicka) == 1.0f, "an empty set reads as full stats");
+});
+
+static check::Case sets("actors.sets", []() {
+    standin::Values values;
+    values.player = {0.9f, 0.8f, 0.7f};
+    values.combatTarget = {0.2f, 0.3f, 0.4f};
+    values.followers = {{0.5f, 0.1f, 1.0f}, {0.3f, 0.6f, 0.2f}};
+    overlay::ActorSets actorSets;
+    actorSets.sample(values, true, false, false);
+    check::expect(values.reads == 1, "only the sets wanted are sampled");
+    actorSets.sample(values, true, true, true);
+    check::expect(values.reads == 4, "each wanted set is sampled once a tick");
+    Settings::OverlayData stat;
+    check::expect(actorSets.value(stat, actors::Stamina) == 0.8f, "an overlay follows the player by default");
+    stat.target = actors::Target::CombatTarget;
+    check::expect(actorSets.value(stat, actors::Health) == 0.2f, "an overlay bound to the combat target reads its stat");
+    stat.target = actors::Target::Followers;
+    stat.aggregate = actors::Aggregate::LowestHealth;
+    check::expect(actorSets.value(stat, actors::Stamina) == 0.6f, "lowest health reads the weakest follower's stat");
+    stat.aggregate = actors::Aggregate::Max;
+    check::expect(actorSets.value(stat, actors::Magicka) == 1.0f, "max reads the highest of the followers");
+    // no combat target: the set is empty and reads as full, so the effect fades out
+    values.hasTarget = false;
+    actorSets.sample(values, false, true, false);
+    stat.target = actors::Target::CombatTarget;
+    check::expect(actorSets.value(stat, actors::Health) == 1.0f, "no combat target reads as full stats");
+    // the batch is reused, so a steady tick doesn't allocate once it has held the biggest set
+    check::Allocations allocations;
+    for (int tick = 0; tick < 100; tick++) { actorSets.sample(values, true, true, true); }
+    check::expect(allocations.count() == 0, "sampling reuses the batch");
+});
+
+static check::Case names("actors.names", []() {
+    actors::Aggregate implied = actors::Aggregate::Min;
+    check::expect(actors::getTargetString("CombatTarget") == actors::Target::CombatTarget && actors::getTargetString("Party") == actors::Target::Followers, "targets by name, any case");
+    check::expect(actors::getTargetString("lowesthealthteammate", &implied) == actors::Target::Followers && implied == actors::Aggregate::LowestHealth, "the lowest health teammate is the followers' lowest health");
+    check::expect(actors::getTargetString("nobody") == actors::Target::Player && actors::getAggregateString("median") == actors::Aggregate::Min, "unknown names fall back to the player and min");
+    for (auto target: {actors::Target::Player, actors::Target::CombatTarget, actors::Target::Followers}) {
+        check::expect(actors::getTargetString(actors::getStringTarget(target)) == target, "a target's name reads back as it");
+    }
+    for (auto aggregate: {actors::Aggregate::Min, actors::Aggregate::Max, actors::Aggregate::Average, actors::Aggregate::LowestHealth}) {
+        check::expect(actors::getAggregateString(actors::getStringAggregate(aggregate)) == aggregate, "an aggregate's name reads back as it");
+    }
+});
@@ -0,0 +1,169 @@
+// The steady state tick allocates nothing: the overlay thread's loop (sampling, every overlay's tick, stages, the update
+// schedule and the sequence executor) runs thousands of simulated ticks under the counting operator new, on the shipped
+// config and on one that switches on every per-tick feature, with and without the tracer, and the fault path (a throw
+// from a tick). The build runs this file's cases after linking the tests (STATFX_ALLOC_CHECK), so a per-tick allocation
+// fails the build instead of turning into frame time hitches. The game side in plugin.cpp isn't linked here; its part of
+// the loop (the follower roster refresh queued about once a second) reuses preallocated objects by hand.
+#include <array>
+#include <cmath>
+#include "check.h"
+#include "standins.h"
+#include "../timerwheel.h"
+#include "../sequence.h"
+#include "../trace.h"
+
+// the player, a combat target and a few followers, all on their own stat traces
+class TraceValues : public game::ActorValues {
+public:
+    void sample(actors::Target target, actors::SampleBatch &batch) override {
+        switch (target) {
+            case actors::Target::CombatTarget: batch.push(enemy, 1.0f, 0.5f); break;
+            case actors::Target::Followers: for (int i = 0; i < 4; i++) { batch.push(std::fmod(health + i * 0.2f, 1.0f), stamina, magicka); } break;
+            default: batch.push(health, stamina, magicka);
+        }
+    }
+    // stats at ms: health takes a hit every 4 s and regenerates, stamina drains in sprints, magicka is channelled
+    void at(std::uint64_t ms) {
+        health = 1.0f - 0.3f * static_cast<float>((ms / 4000) % 3) + 0.05f * static_cast<float>(ms % 4000) / 4000.0f;
+        stamina = 0.5f + 0.5f * std::cos(static_cast<float>(ms) / 1500.0f);
+        magicka = ms % 6000 < 2000 ? 1.0f - static_cast<float>(ms % 6000) / 2500.0f : 0.2f + static_cast<float>(ms % 6000 - 2000) / 5000.0f;
+        enemy = std::fmod(1.0f - static_cast<float>(ms) / 20000.0f, 1.0f);
+    }
+    float health = 1.0f, stamina = 1.0f, magicka = 1.0f, enemy = 1.0f;
+};
+
+// every per-tick feature switched on somewhere
+static mINI::INIStructure EveryFeature() {
+    mINI::INIStructure ini;
+    ini["Global"]["SleepTime"] = "10";
+    ini["Health"]["Tint"] = "0.5,0,0,0.6";
+    ini["Health"]["Pulse"] = "heartbeat";
+    ini["Health"]["Filter"] = "oneeuro";
+    ini["Health"]["Predict"] = "1";
+    ini["Health"]["Target"] = "followers";
+    ini["Health"]["Aggregate"] = "average";
+    ini["Health"]["Intensity"] = "ease(quad, 1 - health) * max(0, 1 - stamina*2) + combat * 0.1";
+    ini["Stamina"]["SaturationMult"] = "0.3";
+    ini["Stamina"]["Keyframes"] = "16";
+    ini["Stamina"]["Filter"] = "hysteresis";
+    ini["Stamina"]["UpdateInterval"] = "40";
+    ini["Magicka"]["BrightnessMult"] = "0.6";
+    ini["Magicka"]["Target"] = "combattarget";
+    ini["Magicka"]["Filter"] = "ema";
+    ini["Magicka"]["Pulse"] = "sine";
+    ini["Magicka"]["Curve"] = "easeOutBounce";
+    ini["Magicka"]["UpdateInterval"] = "16";
+    ini["Health:Tinted"]["EditorID"] = "StatFXImodHealthStageTinted";
+    ini["Health:Tinted"]["Below"] = "0.6";
+    ini["Health:Grey"]["EditorID"] = "StatFXImodHealthStageGrey";
+    ini["Health:Grey"]["Below"] = "0.3";
+    ini["Health:Grey"]["Blend"] = "0.2";
+    return ini;
+}
+
+static sequence::Task EveryTick(sequence::Executor &executor, int *ticks) {
+    while (true) { co_await executor.nextTick(); (*ticks)++; }
+}
+
+static sequence::Task OnChange(sequence::Executor &executor, sequence::Signal &signal, int *changes) {
+    while (true) { co_await executor.changed(signal, 0.05f); (*changes)++; }
+}
+
+// the overlay thread's loop, minus the game: warm up, then count allocations over 5000 ticks more
+static long Run(const mINI::INIStructure &ini, bool traced) {
+    constexpr int ticks = 5000;
+    Settings settings;
+    Profiles profiles;
+    ReadSettings(ini, settings, profiles);
+    const Profile &profile = *profiles.bank.front();
+    trace::Enable(traced);
+    TraceValues values;
+    overlay::ActorSets sets;
+    std::array<standin::Imod, actors::StatCount> imods;
+    std::array<oscillator::Oscillator, actors::StatCount> oscillators;
+    std::array<filter::Filter, actors::StatCount> filters;
+    std::array<predict::Predictor, actors::StatCount> predictors;
+    std::array<lifecycle::Phase, actors::StatCount> phases = {};
+    std::array<float, actors::StatCount> current = {1.0f, 1.0f, 1.0f}, actual = current, emitted = {};
+    std::array<standin::Imod, stages::maxStages> stageSlots;
+    std::array<game::Imod*, stages::maxStages> stageImods;
+    for (std::size_t i = 0; i < stages::maxStages; i++) { stageImods[i] = &stageSlots[i]; }
+    stages::Cursor cursor;
+    timerwheel::Wheel schedule(actors::StatCount);
+    sequence::Executor sequences;
+    sequence::Signal healthSignal(sequences, 1.0f);
+    int sequenceTicks = 0, changes = 0;
+    sequences.spawn(actors::StatCount, EveryTick(sequences, &sequenceTicks));
+    sequences.spawn(actors::StatCount, OnChange(sequences, healthSignal, &changes));
+    const std::array<const Settings::OverlayData*, actors::StatCount> stats = {&profile.health, &profile.stamina, &profile.magicka};
+    for (std::size_t which = 0; which < actors::StatCount; which++) { if (stats[which]->enabled) schedule.schedule(which, 0); }
+    std::uint64_t now = 0;
+    std::array<bool, actors::StatCount> due = {};
+    long allocations = 0;
+    for (int t = -ticks / 10; t < ticks; t++) {
+        // the first tenth warms up: buffers reach their size, tracer buffers are allocated
+        check::Allocations tick;
+        now += 5;
+        values.at(now);
+        due.fill(false);
+        schedule.advance(now, [&](std::size_t which) { due[which] = true; });
+        for (std::size_t which = 0; which < actors::StatCount; which++) {
+            if (due[which]) { schedule.schedule(which, timerwheel::periodic(schedule.deadline(which), stats[which]->updateInterval, now)); }
+        }
+        healthSignal.set(current[actors::Health]);
+        sequences.tick(now);
+        if (due[0] || due[1] || due[2]) {
+            STATFX_TRACE_SPAN("loop");
+            sets.sample(values, true, true, true);
+            expr::Vars shared = {};
+            expr::setShared(shared, current[actors::Health], current[actors::Stamina], current[actors::Magicka], (now / 3000) % 2 ? conditions::InCombat : 0u);
+            for (std::size_t which = 0; which < actors::StatCount; which++) {
+                if (!due[which] || !stats[which]->enabled) continue;
+                auto stat = static_cast<actors::Stat>(which);
+                overlay::Tick(&current[which], &actual[which], stat, *stats[which], sets, shared, imods[which], &oscillators[which], &filters[which], &predictors[which], &phases[which], &emitted[which], stats[which]->updateInterval / 1000.0f);
+                if (stat == actors::Health) { overlay::TickStages(current[which], settings.healthStages, &cursor, stageImods); }
+            }
+        }
+        if (t >= 0) { allocations += tick.count(); }
+    }
+    trace::Enable(false);
+    check::expect(sequenceTicks > 0, "the sequences ran");
+    return allocations;
+}
+
+static check::Case shipped("alloc.shipped", []() {
+    mINI::INIFile iniFile(check::source("StatFx.ini").string());
+    mINI::INIStructure ini;
+    check::expect(iniFile.read(ini), "the shipped StatFx.ini reads");
+    check::expect(Run(ini, false) == 0, "the shipped config's steady state tick allocates nothing");
+    check::expect(Run(ini, true) == 0, "nor does it traced");
+});
+
+static check::Case everyFeature("alloc.features", []() {
+    check::expect(Run(EveryFeature(), false) == 0, "every per-tick feature's steady state tick allocates nothing");
+    check::expect(Run(EveryFeature(), true) == 0, "nor does it traced");
+});
+
+// a fault is thrown with a fixed message: the exception itself comes from the runtime's exception heap, not operator new
+static check::Case fault("alloc.fault", []() {
+    Settings::OverlayData stat;
+    overlay::ActorSets sets;
+    standin::Imod missing;
+    missing.isLoaded = false;
+    oscillator::Oscillator osc;
+    filter::Filter noise;
+    predict::Predictor lead;
+    lifecycle::Phase phase = lifecycle::Phase::Inactive;
+    float current = 1.0f, actual = 1.0f, emitted = 0.0f;
+    expr::Vars shared = {};
+    int faults = 0;
+    check::Allocations counted;
+    for (int i = 0; i < 100; i++) {
+        try {
+            overlay::Tick(&current, &actual, actors::Health, stat, sets, shared, missing, &osc, &noise, &lead, &phase, &emitted, 0.025f);
+        } catch (const overlay::Fault&) {
+            faults++;
+        }
+    }
+    check::expect(faults == 100 && counted.count() == 0, "throwing a fault allocates nothing");
+});
@@ -0,0 +1,96 @@
+// breaker.h and overlay faults: faults injected into one overlay's tick (a broken actor value read, a missing imod
+// form, a non-finite intensity) back only that overlay off on the doubling schedule, trip it once its budget is used
+// up, and leave the other overlays ticking every tick. A healthy streak forgives a fault, a reload re-enables it.
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "check.h"
+#include "standins.h"
+
+// one overlay behind its breaker, the way the overlay thread's guardedTick runs it
+struct Guarded {
+    standin::Overlay overlay;
+    breaker::CircuitBreaker cb;
+    std::vector<std::uint64_t> ran;
+    int faults = 0;
+
+    void tick(std::uint64_t tick, float sample, const breaker::Settings &settings) {
+        if (!cb.allow(tick)) { return; }
+        ran.push_back(tick);
+        try {
+            overlay.tick(sample);
+            cb.success(settings);
+        } catch (const overlay::Fault&) {
+            faults++;
+            if (cb.failure(tick, settings)) { overlay.imod.stop(); }
+        }
+    }
+};
+
+static check::Case schedule("breaker.schedule", []() {
+    breaker::Settings settings;
+    Guarded broken, health;
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    float value = 1.0f;
+    bool othersRan = true;
+    for (std::uint64_t tick = 0; tick < 3000; tick++) {
+        value = 0.5f + 0.4f * std::sin(tick * 0.01f);
+        broken.tick(tick, nan, settings);
+        auto before = health.ran.size();
+        health.tick(tick, value, settings);
+        othersRan = othersRan && health.ran.size() == before + 1;
+    }
+    // backoff doubles from 10 ticks up to the 400 tick cap, and the 10th fault trips the breaker
+    const std::vector<std::uint64_t> expected = {0, 10, 30, 70, 150, 310, 630, 1030, 1430, 1830};
+    check::expect(broken.ran == expected, "a failing overlay retries on the doubling backoff schedule");
+    check::expect(broken.cb.tripped && broken.faults == settings.budget && !broken.overlay.imod.on, "the budget used up trips the breaker and takes the effect off screen");
+    check::expect(othersRan && health.faults == 0 && health.overlay.imod.updates() > 0, "the other overlays tick every tick throughout");
+    // a reload resets the breaker, and a fixed overlay runs again
+    broken.cb.reset();
+    broken.tick(3000, 0.3f, settings);
+    check::expect(broken.ran.back() == 3000 && broken.faults == settings.budget && broken.overlay.imod.on, "a reload re-enables a tripped overlay");
+});
+
+static check::Case injected("breaker.injected", []() {
+    breaker::Settings settings;
+    settings.budget = 3;
+    // a missing imod form
+    Guarded missing;
+    missing.overlay.imod.isLoaded = false;
+    // an Intensity formula that goes non-finite at the bottom of its range
+    Guarded formula;
+    expr::Context context{formula.overlay.stat.startFraction, formula.overlay.stat.endFraction, formula.overlay.stat.easingFunction};
+    auto program = expr::compile("1 / stat", context);
+    if (!check::expect(program.has_value(), "the formula compiles")) { return; }
+    formula.overlay.stat.intensity = *program;
+    for (std::uint64_t tick = 0; tick < 2000; tick++) {
+        missing.tick(tick, 0.4f, settings);
+        formula.tick(tick, tick < 1000 ? 0.5f : 0.0f, settings);
+    }
+    check::expect(missing.cb.tripped && missing.faults == 3 && missing.overlay.imod.updates() == 0, "a missing imod form faults before touching anything");
+    check::expect(formula.cb.tripped && formula.faults == 3 && formula.ran.front() == 0 && formula.ran[formula.ran.size() - 3] >= 1000, "a non-finite intensity faults only once the formula goes bad");
+    check::expect(!formula.overlay.imod.on, "a tripped overlay's effect is off screen");
+});
+
+static check::Case forgiveness("breaker.forgiveness", []() {
+    breaker::Settings settings;
+    settings.budget = 3;
+    settings.forgiveTicks = 100;
+    Guarded flaky;
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    // a hiccup now and then, with long healthy streaks in between: never disabled
+    std::uint64_t tick = 0;
+    for (int hiccup = 0; hiccup < 20; hiccup++) {
+        flaky.tick(tick++, nan, settings);
+        for (int i = 0; i < 150; i++) { flaky.tick(tick++, 0.5f, settings); }
+    }
+    check::expect(!flaky.cb.tripped && flaky.faults == 20 && flaky.cb.faults == 0, "a healthy streak forgives each rare fault");
+    // the same faults close together use up the budget
+    Guarded bursty;
+    tick = 0;
+    for (int hiccup = 0; hiccup < 20 && !bursty.cb.tripped; hiccup++) {
+        bursty.tick(tick++, nan, settings);
+        for (int i = 0; i < 50; i++) { bursty.tick(tick++, 0.5f, settings); }
+    }
+    check::expect(bursty.cb.tripped && bursty.faults == 3, "faults closer together than the forgiveness streak trip the breaker");
+});
@@ -0,0 +1,41 @@
+/* StatFX tests: a small runner of its own, so the tests build from the core alone with no test framework to install.
+ * ----------
+ * A case is a named function registered by a static check::Case. Its name is "<file>.<what>", and ctest runs each
+ * tests/<file>_test.cpp as one test: StatFXTests <file> runs the cases named <file>.*, StatFXTests alone runs them all.
+ * expect records a failure with its file and line and carries on, so one run shows every broken expectation.
+ * Allocations counts the operator new calls made on the calling thread while it's alive.
+ *
+ * usage:
+ * static check::Case wheelOrder("timerwheel.order", []() {
+ *     check::expect(wheel.nextDeadline() == 16, "the next deadline is the earliest timer's");
+ * });
+*/
+#pragma once
+#include <filesystem>
+#include <source_location>
+
+namespace check
+{
+    struct Case {
+        Case(const char *name, void (*run)());
+    };
+
+    // false records a failure of the running case (what, and where the expectation is)
+    bool expect(bool ok, const char *what, std::source_location where = std::source_location::current());
+
+    // a file in the source tree, e.g. the shipped StatFx.ini
+    std::filesystem::path source(const char *relative);
+
+    // a fresh, empty folder under the temp folder for a case's files
+    std::filesystem::path scratch(const char *name);
+
+    // operator new calls on this thread since construction
+    class Allocations {
+    public:
+        Allocations();
+        long count() const;
+
+    private:
+        long start;
+    };
+}
@@ -0,0 +1,104 @@
+// conditions.h: overlays gated on the player's situation by a stand-in event source that flips the flags the way the
+// plugin's event sinks do. A gated off overlay reads no actor values (none at all while every one is gated off), and
+// the overlay thread parks while a menu is open, reading nothing until it closes
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include "check.h"
+#include "standins.h"
+
+// the game events behind each flag, as the plugin's sinks turn them into PlayerState updates
+struct EventSource {
+    conditions::PlayerState &state;
+    void combat(bool started) { state.set(conditions::InCombat, started); }   // TESCombatEvent
+    void draw(bool drawn) { state.set(conditions::WeaponDrawn, drawn); }       // SKSE action event: begin draw, end sheathe
+    void sneak(bool sneaking) { state.set(conditions::Sneaking, sneaking); }  // tailSneak animation events
+    void menu(bool open) { state.set(conditions::InMenu, open); }             // MenuOpenCloseEvent of a menu that pauses the game
+};
+
+static Settings::OverlayData Gated(const char *condition, actors::Target target) {
+    Settings::OverlayData stat;
+    conditions::parse(condition, stat.condition);
+    stat.target = target;
+    return stat;
+}
+
+static check::Case gated("conditions.gated", []() {
+    conditions::PlayerState state;
+    EventSource events{state};
+    standin::Values values;
+    values.followers.resize(3);
+    overlay::ActorSets sets;
+    const auto health = Gated("combat", actors::Target::Player);
+    const auto stamina = Gated("combat,!sneaking", actors::Target::Followers);
+    const auto magicka = Gated("weapondrawn", actors::Target::CombatTarget);
+    // random events between ticks, and the overlay thread's sampling on each tick
+    std::mt19937 random(35);
+    long allGatedTicks = 0, readsWhileGated = 0, expectedReads = 0;
+    bool matched = true;
+    for (int tick = 0; tick < 5000; tick++) {
+        switch (random() % 12) {
+            case 0: events.combat(true); break;
+            case 1: events.combat(false); break;
+            case 2: events.draw(random() % 2); break;
+            case 3: events.sneak(random() % 2); break;
+            default: break;
+        }
+        auto situation = state.load();
+        bool runHealth = health.condition.allows(situation), runStamina = stamina.condition.allows(situation), runMagicka = magicka.condition.allows(situation);
+        auto wanted = overlay::Wanted({{&stamina, runStamina}, {&magicka, runMagicka}, {&health, runHealth}});
+        matched = matched && wanted.player == runHealth && wanted.followers == runStamina && wanted.combatTarget == runMagicka;
+        auto before = values.reads;
+        if (wanted.any()) { sets.sample(values, wanted.player, wanted.combatTarget, wanted.followers); }
+        expectedReads += runHealth + runStamina + runMagicka;
+        if (!runHealth && !runStamina && !runMagicka) { allGatedTicks++; readsWhileGated += values.reads - before; }
+    }
+    check::expect(matched, "only the sets of the overlays whose conditions hold are wanted");
+    check::expect(values.reads == expectedReads, "one read per running overlay's set, none for a gated off one");
+    check::expect(allGatedTicks > 100 && readsWhileGated == 0, "no actor value is read while every overlay is gated off");
+    // an overlay following a plugin's source reads nothing even when it runs
+    auto sourced = Gated("", actors::Target::Player);
+    sourced.source = 1;
+    check::expect(!overlay::Wanted({{&sourced, true}}).any(), "a plugin's source is read, not sampled");
+});
+
+static check::Case parked("conditions.parked", []() {
+    conditions::PlayerState state;
+    EventSource events{state};
+    standin::Values values;
+    overlay::ActorSets sets;
+    std::atomic<bool> running = true;
+    std::atomic<long> reads = 0, parks = 0;
+    // the overlay thread's loop: park while a menu is open, otherwise sample and tick
+    events.menu(true);
+    std::thread overlayThread([&]() {
+        while (running) {
+            if (state.load() & conditions::InMenu) {
+                parks++;
+                state.waitWhile(conditions::InMenu, [&]() { return running.load(); });
+                continue;
+            }
+            sets.sample(values, true, false, false);
+            reads++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    check::expect(reads == 0 && parks == 1, "the loop parks once while the menu is open, reading nothing");
+    events.menu(false);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (reads < 5 && std::chrono::steady_clock::now() < deadline) { std::this_thread::yield(); }
+    check::expect(reads >= 5, "closing the menu wakes it");
+    // opened again, then the thread is told to stop while parked: a wake lets it see the state change
+    events.menu(true);
+    deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (parks < 2 && std::chrono::steady_clock::now() < deadline) { std::this_thread::yield(); }
+    auto parkedReads = reads.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    check::expect(parks == 2 && reads == parkedReads, "a menu opened again parks it again");
+    running = false;
+    state.wake();
+    overlayThread.join();
+    check::expect(values.reads == reads, "every read was on a running tick");
+});
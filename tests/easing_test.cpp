@@ -0,0 +1,42 @@
+// easing.h and easingf.h: the polynomial curves against their closed forms, and every float32 approximation within its
+// stated error of the double precision reference
+#include <cmath>
+#include "check.h"
+#include "../easingf.h"
+
+static check::Case closedForms("easing.closedforms", []() {
+    // the curves that step t down by one before using it, against the formulas they implement
+    struct Form { easing::easingFunction curve; double (*expected)(double); };
+    const Form forms[] = {
+        {easing::easeOutCubic, [](double t) { return 1 + std::pow(t - 1, 3); }},
+        {easing::easeInOutCubic, [](double t) { return t < 0.5 ? 4 * t * t * t : 1 + 4 * std::pow(t - 1, 3); }},
+        {easing::easeOutQuart, [](double t) { return 1 - std::pow(t - 1, 4); }},
+        {easing::easeInOutQuart, [](double t) { return t < 0.5 ? 8 * std::pow(t, 4) : 1 - 8 * std::pow(t - 1, 4); }},
+        {easing::easeOutQuint, [](double t) { return 1 + std::pow(t - 1, 5); }},
+        {easing::easeInOutQuint, [](double t) { return t < 0.5 ? 16 * std::pow(t, 5) : 1 + 16 * std::pow(t - 1, 5); }},
+        {easing::easeOutBack, [](double t) { return 1 + std::pow(t - 1, 2) * (2.70158 * (t - 1) + 1.70158); }},
+        {easing::easeInOutBack, [](double t) { return t < 0.5 ? t * t * (7 * t - 2.5) * 2 : 1 + std::pow(t - 1, 2) * 2 * (7 * (t - 1) + 2.5); }},
+    };
+    for (auto &form: forms) {
+        double worst = 0.0;
+        for (int i = 0; i <= 1000; i++) {
+            double t = i / 1000.0;
+            worst = std::max(worst, std::abs(form.curve(t) - form.expected(t)));
+        }
+        check::expect(worst < 1e-12, easing::getStringEasingFunction(form.curve));
+        check::expect(std::abs(form.curve(0.0)) < 1e-12 && std::abs(form.curve(1.0) - 1.0) < 1e-12, "curves run from 0 to 1");
+    }
+});
+
+static check::Case approximations("easing.approximations", []() {
+    constexpr int samples = 1 << 16;
+    for (auto &curve: easingf::curves) {
+        double worst = 0.0;
+        for (int i = 0; i < samples; i++) {
+            double t = static_cast<double>(i) / (samples - 1);
+            worst = std::max(worst, std::abs(curve.approx(t) - curve.reference(t)));
+        }
+        check::expect(worst <= curve.maxError, easing::getStringEasingFunction(curve.reference));
+        check::expect(easingf::approximate(curve.reference) == curve.approx && easingf::reference(curve.approx) == curve.reference, "approximate and reference map both ways");
+    }
+});
@@ -0,0 +1,107 @@
+// expr.h: every overlay of the shipped config (base sections and profiles) and every curve over random Ranges compile
+// to an Intensity program giving exactly the floats overlay::EasedValue gives, and the evaluator and compiler on known
+// expressions and errors
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "check.h"
+#include "../overlay.h"
+
+// the overlay's program against EasedValue, bit for bit: a sweep, the Range ends and the floats either side of them
+static bool SameAsToday(const Settings::OverlayData &stat, const expr::Program &program) {
+    std::vector<float> values;
+    for (int i = 0; i <= 1000; i++) { values.push_back(i / 1000.0f); }
+    for (auto point: {stat.startFraction, stat.endFraction}) {
+        values.push_back(point);
+        values.push_back(std::nextafter(point, -1.0f));
+        values.push_back(std::nextafter(point, 2.0f));
+    }
+    expr::Vars vars = {};
+    for (auto value: values) {
+        vars[expr::Stat] = value;
+        float today = overlay::EasedValue(value, stat.startFraction, stat.endFraction, stat.easingFunction);
+        float compiled = program.run(vars);
+        if (std::memcmp(&today, &compiled, sizeof(float)) != 0) { return false; }
+    }
+    return true;
+}
+
+static check::Case defaults("expr.defaults", []() {
+    mINI::INIFile iniFile(check::source("StatFx.ini").string());
+    mINI::INIStructure iniStruct;
+    check::expect(iniFile.read(iniStruct), "the shipped StatFx.ini reads");
+    Settings settings;
+    Profiles profiles;
+    ReadSettings(iniStruct, settings, profiles);
+    int overlays = 0;
+    for (auto &profile: profiles.bank) {
+        for (auto stat: {&profile->health, &profile->stamina, &profile->magicka}) {
+            if (!stat->enabled || stat->intensity.source != "ease(range(stat))") continue;
+            check::expect(SameAsToday(*stat, stat->intensity), "a shipped overlay's default program matches EasedValue");
+            overlays++;
+        }
+    }
+    check::expect(overlays > 0, "the shipped config has overlays on the default program");
+    check::expect(expr::defaultProgram({}).native && !expr::compile("ease(range(stat))", {})->native, "only the default program runs as EasedValue");
+    // and every curve (exact and float32 approximation) over random Ranges, through the default and the written-out form
+    std::mt19937 random(46);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (int e = 0; e <= easing::EaseInOutBounce; e++) {
+        auto exact = easing::getEasingFunction(static_cast<easing::easing_functions>(e));
+        for (auto curve: {exact, easingf::approximate(exact)}) {
+            for (int r = 0; r < 20; r++) {
+                Settings::OverlayData stat;
+                float a = unit(random), b = unit(random);
+                stat.startFraction = std::max(a, b);
+                stat.endFraction = std::min(a, b);
+                stat.easingFunction = curve;
+                expr::Context context{stat.startFraction, stat.endFraction, curve};
+                auto written = expr::compile("ease(range(stat))", context);
+                if (!check::expect(written.has_value(), "ease(range(stat)) compiles")) { return; }
+                check::expect(SameAsToday(stat, expr::defaultProgram(context)), easing::getStringEasingFunction(exact));
+                check::expect(SameAsToday(stat, *written), easing::getStringEasingFunction(exact));
+            }
+        }
+    }
+});
+
+static check::Case language("expr.language", []() {
+    expr::Context context{0.5f, 0.1f, easing::easeInQuad};
+    expr::Vars vars = {};
+    vars[expr::Stat] = 0.3f; vars[expr::Actual] = 0.25f;
+    expr::setShared(vars, 0.3f, 0.2f, 0.8f, conditions::InCombat);
+    struct Case { const char *source; float expected; };
+    const Case cases[] = {
+        {"1 + 2 * 3", 7.0f}, {"(1 + 2) * 3", 9.0f}, {"-2 - -3", 1.0f}, {"8 / 4 / 2", 1.0f}, {"2 * .5", 1.0f},
+        {"health", 0.3f}, {"STAMINA + Magicka", 1.0f}, {"actual", 0.25f}, {"combat", 1.0f}, {"sneaking", 0.0f},
+        {"min(health, stamina)", 0.2f}, {"max(0, 1 - stamina*2)", 0.6f}, {"clamp(magicka * 2, 0, 1)", 1.0f}, {"abs(stamina - health)", 0.1f},
+        {"health < stamina", 0.0f}, {"health >= 0.3", 1.0f}, {"1 <= 1", 1.0f}, {"2 > 1 + 1", 0.0f},
+        {"range(stat)", 0.5f}, {"range(0.3, 0, 1)", 0.7f}, {"range(0.3, 1, 0)", 0.7f}, {"range(2)", 0.0f}, {"range(0)", 1.0f},
+        {"ease(0.5)", 0.25f}, {"ease(linear, 0.5)", 0.5f}, {"ease(cubic, 0.5)", 0.125f}, {"ease(easeOutQuad, 0.5)", 0.75f},
+        {"ease(quad, 1 - health) * max(0, 1 - stamina*2)", 0.49f * 0.6f}, {"combat * ease(range(stat))", 0.25f},
+    };
+    for (auto &c: cases) {
+        auto program = expr::compile(c.source, context);
+        if (!check::expect(program.has_value(), c.source)) continue;
+        check::expect(std::abs(program->run(vars) - c.expected) <= 1e-6f, c.source);
+    }
+    // constant parts are folded, and only programs that read more than stat are dynamic
+    auto folded = expr::compile("stat * (2 * 3 - max(1, 2))", context);
+    check::expect(folded && folded->ops.size() == 3 && !folded->dynamic, "constant parts are folded");
+    auto dynamic = expr::compile("stat * combat", context);
+    check::expect(dynamic && dynamic->dynamic, "a program reading combat is dynamic");
+    struct Bad { const char *source; expr::Errc code; std::size_t position; };
+    const Bad bad[] = {
+        {"", expr::Errc::Empty, 0}, {"  ", expr::Errc::Empty, 0}, {"1 +", expr::Errc::Syntax, 3}, {"(1", expr::Errc::Syntax, 2},
+        {"healht", expr::Errc::UnknownName, 0}, {"2 * sqrt(stat)", expr::Errc::UnknownName, 4}, {"ease(wobbly, stat)", expr::Errc::UnknownCurve, 5},
+        {"min(stat)", expr::Errc::ArgumentCount, 0}, {"range(stat, health, 1)", expr::Errc::NotConstant, 0}, {"stat stat", expr::Errc::TrailingCharacters, 5},
+        {"((((((((((((((((1))))))))))))))))+stat*(stat*(stat*(stat*(stat*(stat*(stat*(stat*(stat*(stat*(stat*(stat*(stat*(stat*(stat*(stat*stat)))))))))))))))", expr::Errc::TooDeep, 0},
+    };
+    for (auto &b: bad) {
+        auto program = expr::compile(b.source, context);
+        bool positionOk = b.code == expr::Errc::TooDeep || (!program && program.error().position == b.position);
+        check::expect(!program && program.error().code == b.code && positionOk, b.source);
+    }
+});
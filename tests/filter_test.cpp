@@ -0,0 +1,99 @@
+// filter.h: each noise filter's response to steps, ramps and jitter. The ema's step response, the One-Euro speed
+// estimate following the raw samples' rate (not the filter's own lag), hysteresis holding within its band, and a
+// spike passing straight through every filter
+#include <cmath>
+#include <random>
+#include "check.h"
+#include "../filter.h"
+
+static filter::Settings Of(filter::Kind kind) {
+    filter::Settings settings;
+    settings.kind = kind;
+    return settings;
+}
+
+static check::Case ema("filter.ema", []() {
+    auto settings = Of(filter::Kind::Ema);
+    settings.time = 0.5f;
+    filter::Filter f;
+    check::expect(f.step(settings, 0.5f, 0.025f) == 0.5f, "the first sample is taken as it is");
+    // a step smaller than the spike threshold: 1 - exp(-t / time) of the way after t seconds
+    float value = 0.0f;
+    for (int i = 0; i < 20; i++) { value = f.step(settings, 0.55f, 0.025f); }
+    check::expect(std::abs(value - (0.5f + 0.05f * (1.0f - std::exp(-1.0f)))) < 1e-4f, "the step response of a time constant");
+    filter::Filter none;
+    check::expect(none.step(Of(filter::Kind::None), 0.3f, 0.025f) == 0.3f && none.step(Of(filter::Kind::None), 0.31f, 0.025f) == 0.31f, "no filter passes every sample through");
+});
+
+static check::Case oneEuro("filter.oneeuro", []() {
+    auto settings = Of(filter::Kind::OneEuro);
+    // a steady ramp: the speed is the ramp's rate, however far the filtered value lags behind
+    for (float rate: {0.02f, 0.2f, 1.0f}) {
+        filter::Filter f;
+        float sample = 0.0f;
+        for (int i = 0; i < 400; i++) { f.step(settings, sample += rate * 0.025f, 0.025f); }
+        check::expect(std::abs(f.speed - rate) < rate * 1e-3f, "the speed is the raw samples' rate of change");
+    }
+    // jitter about a fixed value has no speed on average, so it is smoothed at the resting cutoff
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> jitter(-0.003f, 0.003f);
+    filter::Filter still;
+    float worst = 0.0f;
+    for (int i = 0; i < 2000; i++) {
+        float value = still.step(settings, 0.5f + jitter(random), 0.025f);
+        if (i > 200) { worst = std::max(worst, std::abs(value - 0.5f)); }
+    }
+    check::expect(worst < 0.002f, "jitter is smoothed down");
+    // fast movement opens the cutoff: it lags a fast ramp far less than the same filter without beta
+    auto rigid = settings;
+    rigid.beta = 0.0f;
+    filter::Filter adaptive, fixed;
+    float sample = 0.0f, lagAdaptive = 0.0f, lagFixed = 0.0f;
+    for (int i = 0; i < 30; i++) {
+        sample += 0.02f; // 0.8 a second, under the spike threshold each sample
+        lagAdaptive = sample - adaptive.step(settings, sample, 0.025f);
+        lagFixed = sample - fixed.step(rigid, sample, 0.025f);
+    }
+    check::expect(lagAdaptive < lagFixed * 0.5f, "fast movement barely lags");
+});
+
+static check::Case hysteresis("filter.hysteresis", []() {
+    auto settings = Of(filter::Kind::Hysteresis);
+    settings.band = 0.03f;
+    filter::Filter f;
+    f.step(settings, 0.5f, 0.025f);
+    bool held = true;
+    for (float sample: {0.51f, 0.49f, 0.525f, 0.475f}) { held = held && f.step(settings, sample, 0.025f) == 0.5f; }
+    check::expect(held, "moves within the band are held");
+    check::expect(f.step(settings, 0.535f, 0.025f) == 0.535f && f.step(settings, 0.52f, 0.025f) == 0.535f, "a move of a whole band jumps to the sample, and holds from there");
+    check::expect(f.step(settings, 1.0f, 0.025f) == 1.0f && f.step(settings, 0.99f, 0.025f) == 1.0f, "a full stat comes through");
+    // slow regen: one update per band instead of one per sample
+    filter::Filter regen;
+    int changes = 0;
+    float previous = regen.step(settings, 0.2f, 0.025f);
+    for (int i = 1; i <= 400; i++) {
+        float value = regen.step(settings, 0.2f + 0.0015f * i, 0.025f);
+        if (value != previous) { changes++; previous = value; }
+    }
+    check::expect(changes >= 19 && changes <= 20, "regen over 60% is followed in 3% steps, not 400 samples");
+});
+
+static check::Case spikes("filter.spikes", []() {
+    bool through = true;
+    for (auto kind: {filter::Kind::Ema, filter::Kind::OneEuro, filter::Kind::Hysteresis}) {
+        auto settings = Of(kind);
+        filter::Filter f;
+        for (int i = 0; i < 100; i++) { f.step(settings, 0.8f, 0.025f); }
+        through = through && f.step(settings, 0.5f, 0.025f) == 0.5f && f.speed == 0.0f;
+        // and the filter carries on from the new value
+        through = through && std::abs(f.step(settings, 0.5f, 0.025f) - 0.5f) < 1e-6f;
+    }
+    check::expect(through, "a hit of at least the spike threshold passes straight through every filter");
+    auto settings = Of(filter::Kind::Ema);
+    settings.spike = 0.0f;
+    filter::Filter f;
+    f.step(settings, 0.8f, 0.025f);
+    check::expect(f.step(settings, 0.2f, 0.025f) > 0.2f, "a threshold of 0 filters spikes too");
+    f.reset();
+    check::expect(f.step(settings, 0.2f, 0.025f) == 0.2f, "a reset filter takes the next sample as it is");
+});
@@ -0,0 +1,81 @@
+// forms.h: the form cache resolving ini references against a stand-in of the game's form table (FormIDs per plugin
+// and editor IDs), the way the plugin's LookupImod does through parse::formRef. Every spelling of a reference shares
+// one entry, a reload with the same references looks nothing up, and a reference that finds nothing is retried
+#include <map>
+#include <string>
+#include <utility>
+#include "check.h"
+#include "../forms.h"
+
+struct Form { const char *name; };
+
+// the game's data: forms by (plugin, local FormID) and by editor ID, both matched without regard to case
+struct FormTable {
+    std::map<std::pair<std::string, std::uint32_t>, Form*> byID;
+    std::map<std::string, Form*> byEditorID;
+    int calls = 0;
+
+    static std::string lower(std::string_view text) {
+        std::string out(text);
+        for (auto &c: out) { if (c >= 'A' && c <= 'Z') { c = static_cast<char>(c - 'A' + 'a'); } }
+        return out;
+    }
+    void add(Form *form, std::string_view plugin, std::uint32_t localID, std::string_view editorID) {
+        byID[{lower(plugin), localID}] = form;
+        byEditorID[lower(editorID)] = form;
+    }
+    // LookupImod: a plugin-qualified FormID through the data handler, or an editor ID
+    Form* lookup(std::string_view reference) {
+        calls++;
+        if (auto ref = parse::formRef(reference)) {
+            auto found = byID.find({lower(ref->plugin), ref->localID});
+            return found == byID.end() ? nullptr : found->second;
+        }
+        auto found = byEditorID.find(lower(reference));
+        return found == byEditorID.end() ? nullptr : found->second;
+    }
+};
+
+static check::Case spellings("forms.spellings", []() {
+    Form health{"health"}, other{"other"};
+    FormTable table;
+    table.add(&health, "StatFX.esp", 0x801, "StatFXHealthImod");
+    table.add(&other, "Other.esp", 0x801, "OtherImod");
+    forms::Cache<Form> cache;
+    auto lookup = [&table](std::string_view reference) { return table.lookup(reference); };
+    // every way the ini can name the same FormID
+    bool same = true;
+    for (auto reference: {"StatFX.esp|0x801", "0x801~StatFX.esp", " statfx.ESP | 801 ", "StatFX.esp|0x00000801", "StatFX.esp|0xFE000801", "0X801~STATFX.ESP"}) {
+        same = same && cache.resolve(reference, lookup) == &health;
+    }
+    check::expect(same && table.calls == 1 && cache.lookups == 1 && cache.hits == 5 && cache.size() == 1, "every spelling of a FormID shares one entry, looked up once");
+    check::expect(forms::key("0x801~StatFX.esp") == "statfx.esp|000801", "the canonical key of a FormID");
+    // editor IDs, in any case
+    check::expect(cache.resolve("StatFXHealthImod", lookup) == &health && cache.resolve("statfxhealthimod", lookup) == &health && table.calls == 2, "an editor ID in any case is one entry");
+    // the same local FormID in another plugin is another form
+    check::expect(cache.resolve("Other.esp|0x801", lookup) == &other && cache.size() == 3, "the plugin is part of a FormID");
+    // a reload with the same references looks nothing up
+    auto calls = table.calls;
+    for (int reload = 0; reload < 100; reload++) {
+        cache.resolve("StatFX.esp|0x801", lookup);
+        cache.resolve("StatFXHealthImod", lookup);
+        cache.resolve("0x801~Other.esp", lookup);
+    }
+    check::expect(table.calls == calls, "a reload with the same references looks nothing up");
+});
+
+static check::Case misses("forms.misses", []() {
+    Form late{"late"};
+    FormTable table;
+    forms::Cache<Form> cache;
+    auto lookup = [&table](std::string_view reference) { return table.lookup(reference); };
+    // a plugin that isn't loaded, an editor ID nothing has, a reference that isn't a form at all
+    check::expect(!cache.resolve("Late.esp|0x12", lookup) && !cache.resolve("LateImod", lookup) && !cache.resolve("Late.txt|0x12", lookup), "references that find nothing resolve to null");
+    check::expect(cache.size() == 0 && table.calls == 3, "and aren't cached");
+    check::expect(!cache.resolve("Late.esp|0x12", lookup) && table.calls == 4, "so they are looked up again");
+    // once the form exists, the next reload finds it and keeps it
+    table.add(&late, "Late.esp", 0x12, "LateImod");
+    check::expect(cache.resolve("Late.esp|0x12", lookup) == &late && cache.resolve("late.esp|12", lookup) == &late && table.calls == 5, "a form that appears later resolves, then is cached");
+    cache.clear();
+    check::expect(cache.resolve("0x12~Late.esp", lookup) == &late && table.calls == 6, "a cleared cache looks up again");
+});
@@ -0,0 +1,68 @@
+// layers.h: which files Discover picks up and in what order, that Merge applies them key by key in that order (later
+// keys win, new sections go after existing ones, each key's source is the layer that set it last), and that the result
+// is the same whatever the thread count and however the parsing interleaves
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "check.h"
+#include "../layers.h"
+#include "../settings.h"
+
+static void WriteFile(const std::filesystem::path &path, const std::string &text) {
+    std::ofstream file(path, std::ios::binary);
+    file << text;
+}
+
+// the merged config as text, sections and keys in order, with each key's source
+static std::string Dump(const layers::Merged &merged) {
+    std::ostringstream out;
+    for (auto const& [section, keys]: merged.ini) {
+        out << "[" << section << "]\n";
+        for (auto const& [key, value]: keys) {
+            auto source = merged.source.find(section + "." + key);
+            out << key << "=" << value << " <" << (source == merged.source.end() ? "?" : merged.files[source->second]) << ">\n";
+        }
+    }
+    return out.str();
+}
+
+static check::Case order("layers.order", []() {
+    auto folder = check::scratch("layers");
+    WriteFile(folder / "StatFx.ini", "[Global]\nSleepTime = 25\n[Health]\nTint = 1,0,0,0.5\nCurve = 1\n[Magicka]\nCurve = 2\n");
+    WriteFile(folder / "StatFx_b.ini", "[Health]\nCurve = 3\n[Profile:Dark]\nHealth.Tint = 0,0,0,1\n");
+    WriteFile(folder / "statfx_A.ini", "[HEALTH]\ncurve = 2\nRange = 0.5,0\n[Health:Stage1]\nBelow = 0.3\n");
+    WriteFile(folder / "StatFx_c.txt", "[Health]\nCurve = 9\n");
+    WriteFile(folder / "Other.ini", "[Health]\nCurve = 9\n");
+    WriteFile(folder / "StatFxExtra.ini", "[Health]\nCurve = 9\n");
+    std::filesystem::create_directories(folder / "StatFx_folder.ini");
+    auto files = layers::Discover(folder / "StatFx.ini");
+    std::vector<std::string> names;
+    for (auto &file: files) { names.push_back(file.filename().string()); }
+    check::expect(names == std::vector<std::string>{"StatFx.ini", "statfx_A.ini", "StatFx_b.ini"}, "the base first, then StatFx_*.ini by case insensitive name, nothing else");
+    auto merged = layers::Merge(layers::Read(files));
+    auto health = merged.ini.get("Health");
+    check::expect(health.get("Curve") == "3" && merged.files[merged.source["health.curve"]] == "StatFx_b.ini", "the last layer's key wins");
+    check::expect(health.get("Tint") == "1,0,0,0.5" && merged.source["health.tint"] == 0, "keys no layer overrides keep the base value");
+    check::expect(health.get("Range") == "0.5,0" && merged.files[merged.source["health.range"]] == "statfx_A.ini", "a layer adds keys to existing sections");
+    std::vector<std::string> sections;
+    for (auto const& [section, keys]: merged.ini) { sections.push_back(section); }
+    check::expect(sections == std::vector<std::string>{"global", "health", "magicka", "health:stage1", "profile:dark"}, "new sections go after existing ones, in layer order");
+    // the same merge on any number of threads, run after run
+    auto expected = Dump(merged);
+    for (int threads = 1; threads <= 8; threads++) {
+        for (int run = 0; run < 10; run++) { check::expect(Dump(layers::Merge(layers::Read(files, threads))) == expected, "the merge doesn't depend on the threads"); }
+    }
+    // a layer that can't be read is left out, and the rest merge as before
+    auto missing = files;
+    missing.insert(missing.begin() + 1, folder / "StatFx_gone.ini");
+    auto skipped = layers::Merge(layers::Read(missing));
+    check::expect(Dump(skipped) == expected && skipped.files.size() == 3, "an unreadable layer is skipped");
+    check::expect(layers::Discover(folder / "Missing.ini").empty(), "no base and no overrides is no layers");
+    // the merged config loads like a single file would
+    Settings settings;
+    Profiles profiles;
+    ReadSettings(merged.ini, settings, profiles);
+    check::expect(settings.health.startFraction == 0.5f && settings.health.easingFunction == easing::easeInCubic, "the merged values reach the settings");
+    check::expect(profiles.bank.size() == 2 && settings.healthStages.looks.empty(), "sections added by a layer reach the settings");
+});
@@ -0,0 +1,119 @@
+// lifecycle.h and overlay::Tick: against a stand-in imod manager that keeps the engine's list of live instances, no
+// instance exists while every stat sits above its Range, one is created only when intensity first rises above zero,
+// and it is released as soon as intensity drops back to zero
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+#include "check.h"
+#include "standins.h"
+
+// the engine's live imod instances, and how many times a form went from no instance to one
+struct Manager {
+    struct Instance { const void *form; float strength; };
+    std::vector<Instance> live;
+    long created = 0;
+    bool replacing = false; // a trigger's stop and start, which replaces the instance rather than creating one
+
+    Instance* find(const void *form) {
+        auto found = std::find_if(live.begin(), live.end(), [form](auto &instance) { return instance.form == form; });
+        return found == live.end() ? nullptr : &*found;
+    }
+    void add(const void *form, float strength) { live.push_back({form, strength}); if (!replacing) { created++; } }
+    void remove(const void *form) { std::erase_if(live, [form](auto &instance) { return instance.form == form; }); }
+};
+
+// game::Imod over the manager, with the plugin's GameImod semantics: a trigger replaces the instance, a drive
+// creates one if there is none, a stop removes it
+class ManagedImod : public game::Imod {
+public:
+    explicit ManagedImod(Manager &manager) : manager(manager) {}
+    bool loaded() const override { return true; }
+    bool live() const override { return manager.find(this) != nullptr; }
+    void trigger(float strength) override {
+        manager.replacing = live();
+        manager.remove(this);
+        manager.add(this, strength);
+        manager.replacing = false;
+    }
+    void drive(float, float strength) override {
+        if (!manager.find(this)) { manager.add(this, 1.0f); }
+        manager.find(this)->strength = strength;
+    }
+    void hold() override {}
+    void stop() override { manager.remove(this); }
+    void apply(const overlay::ImodParams&) override {}
+private:
+    Manager &manager;
+};
+
+// the three overlays, each its own look: plain, pulsing and baked
+struct Overlays {
+    Manager manager;
+    std::array<ManagedImod, actors::StatCount> imods = {ManagedImod(manager), ManagedImod(manager), ManagedImod(manager)};
+    std::array<Settings::OverlayData, actors::StatCount> stats;
+    std::array<oscillator::Oscillator, actors::StatCount> oscillators;
+    std::array<filter::Filter, actors::StatCount> filters;
+    std::array<predict::Predictor, actors::StatCount> predictors;
+    std::array<lifecycle::Phase, actors::StatCount> phases = {};
+    std::array<float, actors::StatCount> current = {1.0f, 1.0f, 1.0f}, actual = current, emitted = {};
+    standin::Values values;
+    overlay::ActorSets sets;
+
+    Overlays() {
+        for (auto &stat: stats) {
+            stat.startFraction = 0.6f;
+            stat.intensity = expr::defaultProgram(expr::Context{stat.startFraction, stat.endFraction, stat.easingFunction});
+        }
+        stats[actors::Stamina].pulse = {oscillator::Waveform::Sine, 1.0f, 0.5f, 0.0f};
+        stats[actors::Magicka].keyframes = 8;
+    }
+
+    void tick(float health, float stamina, float magicka) {
+        values.player = {health, stamina, magicka};
+        sets.sample(values, true, false, false);
+        expr::Vars shared = {};
+        expr::setShared(shared, current[actors::Health], current[actors::Stamina], current[actors::Magicka], 0);
+        for (std::size_t which = 0; which < actors::StatCount; which++) {
+            auto stat = static_cast<actors::Stat>(which);
+            overlay::Tick(&current[which], &actual[which], stat, stats[which], sets, shared, imods[which], &oscillators[which], &filters[which], &predictors[which], &phases[which], &emitted[which], 0.025f);
+        }
+    }
+};
+
+static check::Case aboveRange("lifecycle.aboveRange", []() {
+    Overlays overlays;
+    std::mt19937 random(36);
+    std::uniform_real_distribution<float> above(0.62f, 1.0f);
+    // stats wandering about above the Range, moving far more than MinDelta every tick
+    bool none = true, inactive = true;
+    for (int tick = 0; tick < 5000; tick++) {
+        overlays.tick(above(random), above(random), above(random));
+        none = none && overlays.manager.live.empty();
+        inactive = inactive && std::all_of(overlays.phases.begin(), overlays.phases.end(), [](auto phase) { return phase == lifecycle::Phase::Inactive; });
+    }
+    check::expect(none && overlays.manager.created == 0, "no instance exists while every stat sits above its Range");
+    check::expect(inactive, "and every overlay stays inactive");
+});
+
+static check::Case crossing("lifecycle.crossing", []() {
+    Overlays overlays;
+    // health drains into its Range and recovers, three times over, then magicka (baked) does; the rest stay full
+    bool onlyInRange = true, released = true;
+    for (int round = 0; round < 4; round++) {
+        auto which = round < 3 ? actors::Health : actors::Magicka;
+        for (float value: {0.9f, 0.7f, 0.5f, 0.3f, 0.3f, 0.5f, 0.8f, 1.0f}) {
+            for (int tick = 0; tick < 200; tick++) {
+                std::array<float, actors::StatCount> sample = {1.0f, 1.0f, 1.0f};
+                sample[which] = value;
+                overlays.tick(sample[actors::Health], sample[actors::Stamina], sample[actors::Magicka]);
+                bool shown = overlays.emitted[which] > 0.0f;
+                onlyInRange = onlyInRange && shown == (overlays.manager.find(&overlays.imods[which]) != nullptr) && overlays.manager.live.size() <= 1;
+            }
+        }
+        released = released && overlays.manager.live.empty() && overlays.phases[which] == lifecycle::Phase::Inactive;
+    }
+    check::expect(onlyInRange, "an instance is live exactly while intensity is above zero, and only the drained stat's");
+    check::expect(released, "recovering above the Range releases the instance");
+    check::expect(overlays.manager.created == 4, "an instance is created only when intensity first rises above zero");
+});
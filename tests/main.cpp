@@ -0,0 +1,116 @@
+// StatFX tests: runs the cases registered with check::Case (see check.h), all of them or the ones named on the command
+// line, and exits non-zero if any expectation failed.
+// usage: StatFXTests [file or file.case ...] [--list]
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+#include <spdlog/spdlog.h>
+#include "check.h"
+
+namespace
+{
+    struct Registered {
+        const char *name;
+        void (*run)();
+    };
+
+    std::vector<Registered>& Cases() {
+        static std::vector<Registered> cases;
+        return cases;
+    }
+
+    int failures = 0;
+    thread_local long allocations = 0;
+
+    void* Allocate(std::size_t size) {
+        allocations++;
+        if (void *p = std::malloc(size ? size : 1)) { return p; }
+        throw std::bad_alloc();
+    }
+
+    void* AllocateAligned(std::size_t size, std::align_val_t align) {
+        allocations++;
+        auto alignment = static_cast<std::size_t>(align);
+        if (void *p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)) { return p; }
+        throw std::bad_alloc();
+    }
+
+    // a case runs if it's named, or its file is
+    bool Selected(const std::string &name, const std::vector<std::string> &wanted) {
+        if (wanted.empty()) { return true; }
+        for (auto &want: wanted) {
+            if (name == want || (name.starts_with(want) && name.size() > want.size() && name[want.size()] == '.')) { return true; }
+        }
+        return false;
+    }
+}
+
+// every operator new goes through the counter, so a case can check a path doesn't allocate
+void* operator new(std::size_t size) { return Allocate(size); }
+void* operator new[](std::size_t size) { return Allocate(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { try { return Allocate(size); } catch (...) { return nullptr; } }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { try { return Allocate(size); } catch (...) { return nullptr; } }
+void* operator new(std::size_t size, std::align_val_t align) { return AllocateAligned(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return AllocateAligned(size, align); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace check
+{
+    Case::Case(const char *name, void (*run)()) { Cases().push_back({name, run}); }
+
+    bool expect(bool ok, const char *what, std::source_location where) {
+        if (!ok) {
+            std::printf("  FAILED: %s (%s:%u)\n", what, std::filesystem::path(where.file_name()).filename().string().c_str(), where.line());
+            failures++;
+        }
+        return ok;
+    }
+
+    std::filesystem::path source(const char *relative) { return std::filesystem::path(STATFX_SOURCE_DIR) / relative; }
+
+    std::filesystem::path scratch(const char *name) {
+        auto folder = std::filesystem::temp_directory_path() / "statfx_tests" / name;
+        std::filesystem::remove_all(folder);
+        std::filesystem::create_directories(folder);
+        return folder;
+    }
+
+    Allocations::Allocations() : start(allocations) {}
+    long Allocations::count() const { return allocations - start; }
+}
+
+int main(int argc, char **argv) {
+    spdlog::set_level(spdlog::level::off);
+    std::vector<std::string> wanted;
+    bool list = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--list") { list = true; } else { wanted.push_back(arg); }
+    }
+    int ran = 0, failed = 0;
+    for (auto &c: Cases()) {
+        if (!Selected(c.name, wanted)) continue;
+        if (list) { std::printf("%s\n", c.name); continue; }
+        auto before = failures;
+        c.run();
+        ran++;
+        if (failures > before) { failed++; }
+        std::printf("%-36s %s\n", c.name, failures > before ? "FAILED" : "ok");
+    }
+    if (list) { return 0; }
+    if (ran == 0) {
+        std::printf("no cases match\n");
+        return 1;
+    }
+    std::printf("%d cases, %d failed\n", ran, failed);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,84 @@
+// oscillator.h: the phase locked to the tick clock, carried over a pause, and continuous when the tick length
+// (SleepTime, the update interval) changes mid-pulse
+#include <cmath>
+#include "check.h"
+#include "standins.h"
+
+// distance between two phases around the cycle
+static double PhaseDistance(double a, double b) {
+    double d = std::abs(a - b);
+    return std::min(d, 1.0 - d);
+}
+
+static check::Case tickClock("oscillator.clock", []() {
+    oscillator::Settings settings{oscillator::Waveform::Sine, 1.3f, 0.5f, 0.0f};
+    oscillator::Oscillator osc;
+    bool locked = true, inRange = true;
+    for (int tick = 1; tick <= 4000; tick++) {
+        float gain = osc.step(settings, 0.025f, 1.0f);
+        locked = locked && PhaseDistance(osc.phase, std::fmod(settings.frequency * static_cast<double>(0.025f) * tick, 1.0)) < 1e-6;
+        inRange = inRange && osc.phase >= 0.0 && osc.phase < 1.0 && gain >= 1.0f - settings.depth && gain <= 1.0f;
+    }
+    check::expect(locked, "the phase is the ticks' total time times the frequency");
+    check::expect(inRange, "the phase wraps within 0 to 1 and the gain stays within depth");
+    // the same second of pulse at a shorter tick lands on the same phase
+    oscillator::Oscillator fine, coarse;
+    for (int tick = 0; tick < 100; tick++) { fine.step(settings, 0.010f, 1.0f); }
+    for (int tick = 0; tick < 40; tick++) { coarse.step(settings, 0.025f, 1.0f); }
+    check::expect(PhaseDistance(fine.phase, coarse.phase) < 1e-5, "the pulse doesn't depend on the tick length");
+    check::expect(osc.step(oscillator::Settings{}, 0.025f, 1.0f) == 1.0f, "no waveform is a gain of 1");
+});
+
+static check::Case sleepTime("oscillator.sleeptime", []() {
+    // the tick length changes mid-pulse (a new SleepTime or update interval): the phase carries on from where it was
+    // and only the step changes, so there's no jump in the gain
+    oscillator::Settings settings{oscillator::Waveform::Triangle, 0.8f, 0.6f, 0.5f};
+    oscillator::Oscillator osc;
+    const float lengths[] = {0.025f, 0.1f, 0.005f, 0.05f};
+    bool continuous = true;
+    for (auto seconds: lengths) {
+        for (int tick = 0; tick < 300; tick++) {
+            float intensity = 0.5f + 0.5f * std::sin(tick * 0.05f);
+            double before = osc.phase;
+            osc.step(settings, seconds, intensity);
+            double expected = settings.frequency * (1.0 + settings.rise * intensity) * seconds;
+            continuous = continuous && PhaseDistance(osc.phase, std::fmod(before + expected, 1.0)) < 1e-9;
+        }
+    }
+    check::expect(continuous, "each step moves the phase by the frequency at the intensity times that tick's length");
+});
+
+static check::Case pauseResume("oscillator.pause", []() {
+    // an overlay pulsing on a settled stat
+    standin::Overlay paused;
+    paused.stat.pulse = {oscillator::Waveform::Sine, 1.0f, 0.5f, 0.0f};
+    for (int tick = 0; tick < 60; tick++) { paused.tick(0.4f); }
+    double before = paused.osc.phase;
+    float shown = paused.imod.strength;
+    auto kept = paused.phase;
+    // paused the way the overlay thread pauses: its imod stopped, no ticks for a while, the lifecycle state kept, and
+    // the filter and predictor restarted on the way back to running
+    paused.imod.stop();
+    paused.noise.reset();
+    paused.lead.reset();
+    // the first tick after the resume moves the phase one step on from where it paused, and shows the pulse again
+    // with no bigger change in gain than one tick's
+    const double step = paused.stat.pulse.frequency * static_cast<double>(0.025f);
+    paused.tick(0.4f);
+    check::expect(paused.phase == kept && PhaseDistance(paused.osc.phase, std::fmod(before + step, 1.0)) < 1e-9, "resuming carries on one step from the phase it paused at");
+    float slope = static_cast<float>(paused.stat.pulse.depth * 2.0 * 3.14159265358979 * step); // the sine gain's largest change in a step
+    check::expect(paused.imod.on && std::abs(paused.imod.strength - shown) <= slope + 1e-6f, "and the pulse doesn't jump");
+    bool stepping = true;
+    for (int tick = 0; tick < 200; tick++) {
+        double last = paused.osc.phase;
+        paused.tick(0.4f);
+        stepping = stepping && PhaseDistance(paused.osc.phase, std::fmod(last + step, 1.0)) < 1e-9;
+    }
+    check::expect(stepping, "then steps on as before");
+    // and while the effect is off (stat above its Range) the phase holds too, so it comes back where it left off
+    paused.tick(1.0f);
+    for (int tick = 0; tick < 100 && paused.phase != lifecycle::Phase::Inactive; tick++) { paused.tick(1.0f); }
+    double phase = paused.osc.phase;
+    for (int tick = 0; tick < 50; tick++) { paused.tick(1.0f); }
+    check::expect(paused.phase == lifecycle::Phase::Inactive && paused.osc.phase == phase, "an overlay with no effect doesn't advance its pulse");
+});
@@ -0,0 +1,145 @@
+// parse.h: every parser on a table of good and bad values (the value, or the error and where it was found), floats
+// and integers round-tripping through their shortest text in every decoration the ini allows, every hex byte of a
+// color, and no allocation anywhere
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <string>
+#include "check.h"
+#include "../parse.h"
+
+// the error a parser gave, or false if it gave a value
+template <class T>
+static bool Fails(const parse::Result<T> &result, parse::Errc code, std::size_t position) {
+    return !result && result.error().code == code && result.error().position == position;
+}
+
+static check::Case numbers("parse.numbers", []() {
+    struct Good { const char *value; float expected; };
+    const Good good[] = {
+        {"1.5", 1.5f}, {" +2 ", 2.0f}, {"(0.3)", 0.3f}, {"-0.25", -0.25f}, {".5", 0.5f}, {"1e-3", 0.001f}, {"\t7\r\n", 7.0f},
+        {"( 42 )", 42.0f}, {"0", 0.0f}, {"1E2", 100.0f}
+    };
+    bool goodOk = true;
+    for (auto [value, expected]: good) { auto parsed = parse::number(value); goodOk = goodOk && parsed && *parsed == expected; }
+    check::expect(goodOk, "numbers in every form the ini allows");
+    check::expect(Fails(parse::number(""), parse::Errc::Empty, 0) && Fails(parse::number("   "), parse::Errc::Empty, 3) && Fails(parse::number("()"), parse::Errc::Empty, 1), "an empty value");
+    check::expect(Fails(parse::number("abc"), parse::Errc::Syntax, 0) && Fails(parse::number("  x1"), parse::Errc::Syntax, 2) && Fails(parse::number("+"), parse::Errc::Syntax, 0), "not a number, and where");
+    check::expect(Fails(parse::number("1.5x"), parse::Errc::TrailingCharacters, 3) && Fails(parse::number(" 2 3"), parse::Errc::TrailingCharacters, 2), "characters after the number, and where");
+    check::expect(Fails(parse::number("1e99"), parse::Errc::OutOfRange, 0), "a number too big for a float");
+    check::expect(Fails(parse::number("1,2"), parse::Errc::TrailingCharacters, 1), "a list where one number goes");
+    // integers: decimal and 0x hex, for key codes
+    check::expect(parse::integer("66") == 66 && parse::integer("0x42") == 0x42 && parse::integer(" 0XfF ") == 255 && parse::integer("-3") == -3, "integers, decimal and hex");
+    check::expect(Fails(parse::integer("0x"), parse::Errc::TrailingCharacters, 1) && Fails(parse::integer("4.5"), parse::Errc::TrailingCharacters, 1)
+        && Fails(parse::integer("0x1g"), parse::Errc::TrailingCharacters, 3) && Fails(parse::integer("99999999999"), parse::Errc::OutOfRange, 0)
+        && Fails(parse::integer(""), parse::Errc::Empty, 0), "bad integers, and where");
+});
+
+static check::Case roundTrip("parse.roundtrip", []() {
+    // random finite floats of every magnitude, written the shortest way and decorated like an ini value
+    std::mt19937 random(32);
+    const char *decorations[][2] = {{"", ""}, {"  ", "\t"}, {"(", ")"}, {"( ", " )"}, {"+", ""}};
+    bool same = true;
+    char text[64];
+    for (int i = 0; i < 200000; i++) {
+        auto bits = static_cast<std::uint32_t>(random());
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        if (!std::isfinite(value)) continue;
+        auto end = std::to_chars(text, text + sizeof(text), value).ptr;
+        auto &decoration = decorations[i % 5];
+        if (decoration[0][0] == '+' && text[0] == '-') continue; // "+-1" isn't a number
+        auto decorated = std::string(decoration[0]) + std::string(text, end) + decoration[1];
+        auto parsed = parse::number(decorated);
+        same = same && parsed && (*parsed == value || (value == 0.0f && *parsed == 0.0f));
+    }
+    check::expect(same, "every finite float reads back exactly from its shortest text");
+    bool integers = true;
+    for (int i = 0; i < 100000; i++) {
+        auto value = static_cast<int>(random() & 0x7fffffff) >> (random() % 31);
+        integers = integers && parse::integer(std::to_string(value)) == value;
+        auto end = std::to_chars(text, text + sizeof(text), value, 16).ptr;
+        integers = integers && parse::integer("0x" + std::string(text, end)) == value;
+    }
+    check::expect(integers, "integers read back in decimal and hex");
+});
+
+static check::Case pairs("parse.pairs", []() {
+    auto range = parse::pair("( 0.95, 0.05 )");
+    check::expect(range && range->first == 0.95f && range->second == 0.05f, "a pair in parentheses");
+    range = parse::pair(".05,.75");
+    check::expect(range && range->first == 0.05f && range->second == 0.75f, "a bare pair");
+    check::expect(Fails(parse::pair("0.5"), parse::Errc::TooFewValues, 3), "one value where two go, at the end");
+    check::expect(Fails(parse::pair("1,2,3"), parse::Errc::TooManyValues, 4), "a third value, where it starts");
+    check::expect(Fails(parse::pair("1, x"), parse::Errc::Syntax, 3) && Fails(parse::pair("1,,2"), parse::Errc::Empty, 2) && Fails(parse::pair("1,"), parse::Errc::Empty, 2), "a bad second value, and where");
+    check::expect(Fails(parse::pair(""), parse::Errc::Empty, 0), "an empty pair");
+    auto fade = parse::numberOrPair("3");
+    check::expect(fade && fade->first == 3.0f && fade->second == 3.0f, "one value fills both halves");
+    fade = parse::numberOrPair("(10, 3)");
+    check::expect(fade && fade->first == 10.0f && fade->second == 3.0f, "or a pair");
+    check::expect(Fails(parse::numberOrPair("1,2,3"), parse::Errc::TooManyValues, 4), "but not three");
+});
+
+static check::Case colors("parse.colors", []() {
+    auto tint = parse::color("#c3b09166");
+    check::expect(tint && tint->components == 4 && tint->r == 0xc3 / 255.0f && tint->a == 0x66 / 255.0f, "#rrggbbaa");
+    tint = parse::color(" #C3B091 ");
+    check::expect(tint && tint->components == 3 && tint->b == 0x91 / 255.0f && tint->a == 0.0f, "#rrggbb, any case, alpha left at 0");
+    tint = parse::color("rgba(255, 128, 0, 0.5)");
+    check::expect(tint && tint->components == 4 && tint->r == 1.0f && tint->g == 128 / 255.0f && tint->b == 0.0f && tint->a == 0.5f, "rgba() with 0-255 and 0-1 channels");
+    tint = parse::color("rgb(0.2, 0.4, 0.6)");
+    check::expect(tint && tint->components == 3 && tint->g == 0.4f, "rgb()");
+    tint = parse::color("0.1, 0.2");
+    check::expect(tint && tint->components == 2 && tint->b == 0.0f, "bare channels, the missing ones left at 0 and counted");
+    check::expect(Fails(parse::color("#12345"), parse::Errc::TooFewValues, 1) && Fails(parse::color("#123456789"), parse::Errc::TooManyValues, 1), "a hex color of the wrong length");
+    check::expect(Fails(parse::color("#12x456"), parse::Errc::Syntax, 3) && Fails(parse::color("  #1234g6"), parse::Errc::Syntax, 7), "a bad hex digit, and where");
+    check::expect(Fails(parse::color("1,2,3,4,5"), parse::Errc::TooManyValues, 8) && Fails(parse::color("rgb(1, red, 3)"), parse::Errc::Syntax, 7), "bad channel lists, and where");
+    check::expect(Fails(parse::color(""), parse::Errc::Empty, 0) && Fails(parse::color("rgb()"), parse::Errc::Empty, 4), "an empty color");
+    // every byte in every channel, both cases of hex digit
+    bool bytes = true;
+    const char *digits[] = {"0123456789abcdef", "0123456789ABCDEF"};
+    for (int byte = 0; byte < 256; byte++) {
+        for (auto hex: digits) {
+            std::string pair = {hex[byte >> 4], hex[byte & 15]};
+            for (int channel = 0; channel < 4; channel++) {
+                std::string value = "#00000000";
+                value.replace(1 + 2 * channel, 2, pair);
+                auto parsed = parse::color(value);
+                if (!parsed) { bytes = false; continue; }
+                const float read[] = {parsed->r, parsed->g, parsed->b, parsed->a};
+                bytes = bytes && read[channel] == byte / 255.0f;
+            }
+        }
+    }
+    check::expect(bytes, "every hex byte in every channel");
+});
+
+static check::Case formRefs("parse.formrefs", []() {
+    auto form = parse::formRef("StatFX.esp|0x801");
+    check::expect(form && form->plugin == "StatFX.esp" && form->localID == 0x801, "Plugin.esp|0xFormID");
+    form = parse::formRef("0x801~StatFX.esp");
+    check::expect(form && form->plugin == "StatFX.esp" && form->localID == 0x801, "0xFormID~Plugin.esp");
+    form = parse::formRef(" Update.ESM | 801 ");
+    check::expect(form && form->plugin == "Update.ESM" && form->localID == 0x801, "spaces, any case of extension, no 0x");
+    form = parse::formRef("Mod.esl|0x0A000801");
+    check::expect(form && form->localID == 0x801, "the load order byte is dropped");
+    check::expect(parse::isFormRef("Mod.esp|0x1") && parse::isFormRef("0x1~Mod.esp") && !parse::isFormRef("StatFXHealthImod"), "form references told apart from editor IDs");
+    check::expect(Fails(parse::formRef("Mod.txt|0x1"), parse::Errc::Syntax, 7) && Fails(parse::formRef(".esp|0x1"), parse::Errc::Syntax, 4), "a plugin that isn't a .esp, .esm or .esl");
+    check::expect(Fails(parse::formRef("Mod.esp|"), parse::Errc::Empty, 8) && Fails(parse::formRef("Mod.esp|0x"), parse::Errc::Syntax, 9) && Fails(parse::formRef("|0x1"), parse::Errc::Empty, 0), "a missing plugin or FormID");
+    check::expect(Fails(parse::formRef("Mod.esp|0x80g"), parse::Errc::Syntax, 12) && Fails(parse::formRef("Mod.esp|0x123456789"), parse::Errc::OutOfRange, 10), "a bad FormID, and where");
+    check::expect(Fails(parse::formRef("Mod.esp"), parse::Errc::TooFewValues, 7) && Fails(parse::formRef(""), parse::Errc::Empty, 0), "no separator, or nothing");
+});
+
+static check::Case noAllocation("parse.allocations", []() {
+    check::Allocations allocations;
+    float sum = 0.0f;
+    for (int i = 0; i < 1000; i++) {
+        sum += parse::number(" ( 0.75 ) ").value_or(0.0f);
+        if (auto range = parse::pair("(0.9, 0.1)")) { sum += range->first; }
+        if (auto tint = parse::color("rgba(255, 128, 0, 0.5)")) { sum += tint->g; }
+        if (auto ref = parse::formRef("StatFX.esp|0x801")) { sum += static_cast<float>(ref->localID); }
+        sum += parse::number("bad").value_or(0.0f);
+    }
+    check::expect(allocations.count() == 0 && sum > 0.0f, "parsing, good values and bad, never allocates");
+});
@@ -0,0 +1,105 @@
+// persistence.h: snapshots round-tripping bit for bit through BufferWriter and BufferReader, every truncated, wrong
+// version or garbage record turned away, and an overlay restored from a save picking up exactly where it was saved
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include "check.h"
+#include "standins.h"
+#include "../persistence.h"
+
+static bool SameBits(const persistence::Snapshot &a, const persistence::Snapshot &b) {
+    for (std::size_t i = 0; i < a.overlays.size(); i++) {
+        auto &x = a.overlays[i], &y = b.overlays[i];
+        if (std::memcmp(&x.current, &y.current, sizeof(float)) || std::memcmp(&x.phase, &y.phase, sizeof(double)) || std::memcmp(&x.emitted, &y.emitted, sizeof(float))) { return false; }
+    }
+    return true;
+}
+
+static check::Case roundTrip("persistence.roundtrip", []() {
+    std::mt19937 random(33);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    bool same = true, sized = true;
+    for (int i = 0; i < 1000; i++) {
+        persistence::Snapshot snapshot;
+        for (auto &overlay: snapshot.overlays) { overlay = {unit(random), static_cast<double>(unit(random)) / 3.0, unit(random)}; }
+        persistence::BufferWriter out;
+        same = same && persistence::save(out, snapshot);
+        sized = sized && out.bytes.size() == sizeof(std::uint32_t) + actors::StatCount * (sizeof(float) + sizeof(double) + sizeof(float));
+        persistence::BufferReader in(out.bytes);
+        auto restored = persistence::load(in, persistence::version);
+        same = same && restored && SameBits(*restored, snapshot);
+    }
+    check::expect(same, "a snapshot reads back bit for bit");
+    check::expect(sized, "the record is the count and each overlay's fields, nothing else");
+});
+
+static check::Case rejected("persistence.rejected", []() {
+    persistence::Snapshot snapshot;
+    snapshot.overlays[actors::Stamina] = {0.4f, 0.25, 0.6f};
+    persistence::BufferWriter out;
+    persistence::save(out, snapshot);
+    // every truncation of a good record
+    bool truncated = true;
+    for (std::size_t size = 0; size < out.bytes.size(); size++) {
+        std::vector<std::byte> part(out.bytes.begin(), out.bytes.begin() + static_cast<std::ptrdiff_t>(size));
+        persistence::BufferReader in(part);
+        truncated = truncated && !persistence::load(in, persistence::version);
+    }
+    check::expect(truncated, "a truncated record restores nothing");
+    persistence::BufferReader other(out.bytes);
+    check::expect(!persistence::load(other, persistence::version + 1), "a record from another version restores nothing");
+    // a different overlay count
+    auto bytes = out.bytes;
+    std::uint32_t count = actors::StatCount + 1;
+    std::memcpy(bytes.data(), &count, sizeof(count));
+    persistence::BufferReader wrongCount(bytes);
+    check::expect(!persistence::load(wrongCount, persistence::version), "a record with another overlay count restores nothing");
+    // non-finite values in any field
+    bool garbage = true;
+    for (auto bad: {std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::infinity()}) {
+        for (int field = 0; field < 3; field++) {
+            auto broken = snapshot;
+            auto &overlay = broken.overlays[actors::Magicka];
+            if (field == 0) { overlay.current = bad; } else if (field == 1) { overlay.phase = bad; } else { overlay.emitted = bad; }
+            persistence::BufferWriter badOut;
+            persistence::save(badOut, broken);
+            persistence::BufferReader in(badOut.bytes);
+            garbage = garbage && !persistence::load(in, persistence::version);
+        }
+    }
+    check::expect(garbage, "a record holding NaN or infinity restores nothing");
+});
+
+static check::Case resume("persistence.resume", []() {
+    // an overlay pulsing on a drained stat, saved mid-pulse
+    standin::Overlay saved;
+    saved.stat.pulse = {oscillator::Waveform::Sine, 1.2f, 0.4f, 0.0f};
+    for (int tick = 0; tick < 137; tick++) { saved.tick(0.3f); }
+    persistence::Snapshot snapshot;
+    snapshot.overlays[actors::Health] = {saved.current, saved.osc.phase, saved.emitted};
+    persistence::BufferWriter out;
+    persistence::save(out, snapshot);
+    // the game is loaded: the effect was stopped by the pause, filters and predictors start over, the state is restored
+    saved.imod.stop();
+    saved.phase = lifecycle::Phase::Inactive;
+    saved.noise.reset();
+    saved.lead.reset();
+    standin::Overlay loaded, fresh;
+    loaded.stat = fresh.stat = saved.stat;
+    persistence::BufferReader in(out.bytes);
+    auto restored = persistence::load(in, persistence::version);
+    if (!check::expect(restored.has_value(), "the save restores")) { return; }
+    loaded.current = restored->overlays[actors::Health].current;
+    loaded.osc.phase = restored->overlays[actors::Health].phase;
+    loaded.emitted = restored->overlays[actors::Health].emitted;
+    bool same = true;
+    for (int tick = 0; tick < 100; tick++) {
+        saved.tick(0.3f);
+        loaded.tick(0.3f);
+        same = same && loaded.imod.strength == saved.imod.strength && loaded.current == saved.current && loaded.osc.phase == saved.osc.phase;
+    }
+    check::expect(same, "a restored overlay carries on exactly as the saved one would have");
+    fresh.tick(0.3f);
+    check::expect(fresh.current > 0.9f, "without a save the effect would ramp in from a full stat");
+});
@@ -0,0 +1,56 @@
+// predict.h: the fitted rate of a steady drain, the prediction held within its limit and dropped on hits and reversals,
+// and an overlay following a sprint's stamina drain closer with prediction on than off
+#include <cmath>
+#include <vector>
+#include "check.h"
+#include "standins.h"
+
+static check::Case predictor("predict.predictor", []() {
+    predict::Settings settings{1.0f, 0.05f, 0.005f};
+    predict::Predictor lead;
+    // a steady drain of 1% an update
+    float target = 0.0f;
+    for (int i = 0; i < 10; i++) { target = lead.step(settings, 0.9f - 0.01f * i); }
+    check::expect(std::abs(lead.rate() + 0.01f) < 1e-5f, "the rate of a steady drain is its slope");
+    check::expect(std::abs(target - (0.81f - 0.01f)) < 1e-5f, "the prediction is one update ahead");
+    // a hit: a step bigger than the limit starts over, and there's no prediction until a new trend
+    check::expect(lead.step(settings, 0.5f) == 0.5f && lead.count == 1, "a hit drops the prediction");
+    check::expect(lead.step(settings, 0.49f) < 0.49f, "a new trend predicts again");
+    // a reversal: a step against the trend bigger than reversal starts over
+    lead.step(settings, 0.48f);
+    check::expect(lead.step(settings, 0.49f) == 0.49f, "a reversal drops the prediction");
+    // never further than the limit, never outside 0 to 1
+    settings.lead = 20.0f;
+    lead.reset();
+    for (int i = 0; i < 4; i++) { target = lead.step(settings, 0.03f - 0.01f * i); }
+    check::expect(target == 0.0f, "the prediction stays within 0 to 1");
+    lead.reset();
+    for (int i = 0; i < 4; i++) { target = lead.step(settings, 0.9f - 0.01f * i); }
+    check::expect(std::abs(target - (0.87f - settings.limit)) < 1e-5f, "the prediction stays within the limit of the sample");
+    check::expect(lead.step(predict::Settings{}, 0.3f) == 0.3f, "lead 0 is off");
+});
+
+// the smoothed stat against the truth every ms, sampled once an update, over a sprint: drain, stop, regen
+static double MeanError(float leadUpdates) {
+    standin::Overlay overlay;
+    overlay.stat.predict.lead = leadUpdates;
+    constexpr int tickMs = 25;
+    std::vector<float> truth;
+    float value = 1.0f;
+    for (int repeat = 0; repeat < 4; repeat++) {
+        for (int ms = 0; ms < 3500; ms++) { truth.push_back(value = std::max(0.0f, value - 0.00025f)); }
+        for (int ms = 0; ms < 800; ms++) { truth.push_back(value); }
+        for (int ms = 0; ms < 4000; ms++) { truth.push_back(value = std::min(1.0f, value + 0.00012f)); }
+    }
+    double error = 0.0;
+    for (std::size_t ms = 0; ms < truth.size(); ms++) {
+        if (ms % tickMs == 0) { overlay.tick(truth[ms], tickMs / 1000.0f); }
+        error += std::abs(overlay.current - truth[ms]);
+    }
+    return error / truth.size();
+}
+
+static check::Case replay("predict.replay", []() {
+    auto off = MeanError(0.0f), on = MeanError(1.0f);
+    check::expect(on < off * 0.8, "prediction brings the effect closer to a sprint's stamina");
+});
@@ -0,0 +1,189 @@
+// preview.h: contact sheets of three looks over a test card, compared with the golden images in tests/golden (each
+// golden checked in turn against a double precision evaluation of the formula in preview.h), the vector kernel
+// matching the scalar reference bit for bit, and the same result on any number of threads.
+// Set STATFX_UPDATE_GOLDEN=1 to rewrite the goldens after a deliberate change to the look of the preview
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "check.h"
+#include "../preview.h"
+#include "../overlay.h"
+
+// a test card: hue ramp across, brightness ramp down, with out of range (above 1) highlights in the bottom rows.
+// An odd size, so the vector kernel has tails and the thread bands are uneven
+static preview::Image Card() {
+    preview::Image card;
+    card.resize(37, 23);
+    for (int y = 0; y < card.height; y++) {
+        for (int x = 0; x < card.width; x++) {
+            auto i = static_cast<std::size_t>(y) * card.width + x;
+            float hue = static_cast<float>(x) / card.width * 6.0f, value = 1.0f - static_cast<float>(y) / card.height;
+            if (y >= card.height - 3) { value = 1.5f; }
+            for (int p = 0; p < preview::PlaneCount; p++) {
+                float h = std::fmod(hue + 2.0f * p, 6.0f);
+                card.planes[p][i] = value * std::clamp(std::abs(h - 3.0f) - 1.0f, 0.0f, 1.0f);
+            }
+        }
+    }
+    return card;
+}
+
+struct Look { const char *name; Settings::OverlayData stat; };
+
+static std::vector<Look> Looks() {
+    std::vector<Look> looks(3);
+    looks[0].name = "desaturate";
+    looks[0].stat.saturationMult = 0.1f;
+    looks[1].name = "tint";
+    looks[1].stat.tint = {0.8f, 0.05f, 0.0f, 0.6f};
+    looks[1].stat.brightnessMult = 0.8f;
+    looks[2].name = "contrast";
+    looks[2].stat.contrastMult = 1.6f;
+    looks[2].stat.brightnessAdd = 0.15f;
+    looks[2].stat.saturationAdd = -0.3f;
+    for (auto &look: looks) {
+        look.stat.startFraction = 0.6f;
+        look.stat.easingFunction = easing::easeInQuad;
+    }
+    return looks;
+}
+
+// the card graded at each stat value, side by side
+static const float statValues[] = {1.0f, 0.45f, 0.25f, 0.0f};
+
+static preview::Image Sheet(const preview::Image &card, const Settings::OverlayData &stat, int threads) {
+    preview::Image sheet, graded;
+    sheet.resize(card.width * 4, card.height);
+    for (int column = 0; column < 4; column++) {
+        preview::Apply(preview::GradeAt(stat, statValues[column]), card, graded, threads);
+        preview::Blit(graded, sheet, column * card.width, 0);
+    }
+    return sheet;
+}
+
+// goldens are little endian color PFMs, rows bottom to top like the preview tool writes them
+static bool ReadPfm(const std::filesystem::path &path, preview::Image &image) {
+    std::ifstream file(path, std::ios::binary);
+    std::string magic;
+    int width = 0, height = 0;
+    float scale = 0.0f;
+    if (!(file >> magic >> width >> height >> scale) || magic != "PF" || width <= 0 || height <= 0 || scale >= 0.0f) { return false; }
+    file.get();
+    std::vector<float> raster(static_cast<std::size_t>(width) * height * 3);
+    if (!file.read(reinterpret_cast<char*>(raster.data()), raster.size() * sizeof(float))) { return false; }
+    image.resize(width, height);
+    for (std::size_t i = 0; i < image.pixels(); i++) {
+        auto row = i / width, column = i % width;
+        for (int p = 0; p < preview::PlaneCount; p++) { image.planes[p][i] = raster[((height - 1 - row) * width + column) * 3 + p]; }
+    }
+    return true;
+}
+
+static void WritePfm(const std::filesystem::path &path, const preview::Image &image) {
+    std::ofstream file(path, std::ios::binary);
+    file << "PF\n" << image.width << " " << image.height << "\n-1.0\n";
+    std::vector<float> raster(image.pixels() * 3);
+    for (std::size_t i = 0; i < image.pixels(); i++) {
+        auto row = i / image.width, column = i % image.width;
+        for (int p = 0; p < preview::PlaneCount; p++) { raster[((image.height - 1 - row) * image.width + column) * 3 + p] = image.planes[p][i]; }
+    }
+    file.write(reinterpret_cast<const char*>(raster.data()), raster.size() * sizeof(float));
+}
+
+// largest difference between two images of the same size (infinity if the sizes differ)
+static float MaxDifference(const preview::Image &a, const preview::Image &b) {
+    if (a.width != b.width || a.height != b.height) { return INFINITY; }
+    float worst = 0.0f;
+    for (int p = 0; p < preview::PlaneCount; p++) {
+        for (std::size_t i = 0; i < a.pixels(); i++) { worst = std::max(worst, std::abs(a.planes[p][i] - b.planes[p][i])); }
+    }
+    return worst;
+}
+
+// the formula in preview.h in double precision, from the overlay's settings and its eased intensity
+static preview::Image Reference(const preview::Image &card, const Settings::OverlayData &stat) {
+    preview::Image sheet;
+    sheet.resize(card.width * 4, card.height);
+    for (int column = 0; column < 4; column++) {
+        double t = overlay::EasedValue(statValues[column], stat.startFraction, stat.endFraction, stat.easingFunction);
+        auto fade = [t](double mult, double add) { return 1.0 + (mult - 1.0) * t + add * t; };
+        double saturation = fade(stat.saturationMult, stat.saturationAdd), brightness = fade(stat.brightnessMult, stat.brightnessAdd);
+        double contrast = fade(stat.contrastMult, stat.contrastAdd), alpha = stat.tint.alpha * t;
+        const double tint[] = {stat.tint.red, stat.tint.green, stat.tint.blue};
+        for (std::size_t i = 0; i < card.pixels(); i++) {
+            const double c[] = {card.planes[0][i], card.planes[1][i], card.planes[2][i]};
+            double grey = 0.2125 * c[0] + 0.7154 * c[1] + 0.0721 * c[2];
+            auto to = (i / card.width) * sheet.width + column * card.width + i % card.width;
+            for (int p = 0; p < preview::PlaneCount; p++) {
+                double v = grey + (c[p] - grey) * saturation;
+                v = v + (tint[p] * grey - v) * alpha;
+                sheet.planes[p][to] = static_cast<float>(0.5 + (v * brightness - 0.5) * contrast);
+            }
+        }
+    }
+    return sheet;
+}
+
+static check::Case golden("preview.golden", []() {
+    auto card = Card();
+    bool update = std::getenv("STATFX_UPDATE_GOLDEN") != nullptr;
+    for (auto &[name, stat]: Looks()) {
+        auto path = check::source("tests/golden").append(std::string("preview_") + name + ".pfm");
+        auto sheet = Sheet(card, stat, 1);
+        if (update) { WritePfm(path, sheet); }
+        preview::Image expected;
+        if (!check::expect(ReadPfm(path, expected), "the golden image reads")) { continue; }
+        // a little slack for builds that fuse the kernel's multiply and add
+        check::expect(MaxDifference(sheet, expected) <= 1e-5f, "the sheet matches its golden image");
+        check::expect(MaxDifference(expected, Reference(card, stat)) <= 1e-5f, "the golden image is the formula in preview.h");
+        check::expect(MaxDifference(Sheet(card, stat, 5), sheet) == 0.0f, "any number of threads gives the same image");
+    }
+    // no effect at a full stat: the first column is the card itself
+    auto sheet = Sheet(card, Looks()[1].stat, 1);
+    preview::Image first;
+    first.resize(card.width, card.height);
+    preview::Blit(sheet, first, 0, 0);
+    check::expect(MaxDifference(first, card) <= 1e-6f, "a full stat leaves the image as it is");
+});
+
+static check::Case kernels("preview.kernels", []() {
+    auto card = Card();
+    bool same = true;
+    for (auto &[name, stat]: Looks()) {
+        for (float value: statValues) {
+            auto grade = preview::GradeAt(stat, value);
+            // every count, so each vector width's tail is covered
+            for (std::size_t count = 0; count <= 33; count++) {
+                std::vector<float> wide(count * 3), scalar(count * 3);
+                const std::array<const float*, preview::PlaneCount> in = {card.planes[0].data(), card.planes[1].data(), card.planes[2].data()};
+                preview::Kernel(grade, in, {wide.data(), wide.data() + count, wide.data() + 2 * count}, count);
+                preview::KernelScalar(grade, in, {scalar.data(), scalar.data() + count, scalar.data() + 2 * count}, count);
+                same = same && std::memcmp(wide.data(), scalar.data(), wide.size() * sizeof(float)) == 0;
+            }
+        }
+    }
+    check::expect(same, "the vector kernel matches the scalar reference bit for bit");
+    // graded in place
+    auto inPlace = card;
+    auto grade = preview::GradeAt(Looks()[2].stat, 0.2f);
+    preview::Apply(grade, inPlace, inPlace, 3);
+    preview::Image copied;
+    preview::Apply(grade, card, copied, 3);
+    check::expect(MaxDifference(inPlace, copied) == 0.0f, "an image graded in place is the same as a graded copy");
+    // a blit clipped on every side
+    preview::Image small;
+    small.resize(4, 4);
+    small.planes[0].assign(16, 1.0f);
+    preview::Image target;
+    target.resize(6, 6);
+    preview::Blit(small, target, -2, 4);
+    float sum = 0.0f;
+    for (auto v: target.planes[0]) { sum += v; }
+    check::expect(sum == 4.0f && target.planes[0][4 * 6] == 1.0f && target.planes[0][4 * 6 + 2] == 0.0f, "a blit is clipped to the image");
+});
@@ -0,0 +1,117 @@
+// settings.h Profiles: a reloaded bank and hotkey presses handed to the main thread and taken between ticks, the
+// old bank kept alive until the switch away from it, and switching profiles parsing and allocating nothing
+#include <array>
+#include "check.h"
+#include "standins.h"
+
+static mINI::INIStructure ThreeProfiles(const char *start) {
+    mINI::INIStructure ini;
+    ini["Global"].set("Profile", start);
+    ini["Health"].set("SaturationMult", "0.4");
+    ini["Profile:Combat"].set("Health.Tint", "rgba(255, 0, 0, 0.9)");
+    ini["Profile:Combat"].set("Health.Keyframes", "8");
+    ini["Profile:Calm"].set("Stamina.Active", "false");
+    return ini;
+}
+
+// the main thread's side: take the requests, then switch the way SwitchProfile does
+struct MainThread {
+    explicit MainThread(Profiles &profiles) : profiles(profiles) {}
+    Profiles &profiles;
+    standin::Imod stamina, magicka, health;
+    Profiles::Bank retired;
+
+    void tick() {
+        if (auto index = profiles.take(retired)) {
+            overlay::ApplyProfile(*profiles.bank[*index], stamina, magicka, health);
+            profiles.index = *index;
+            profiles.active.store(profiles.bank[*index].get());
+        }
+    }
+};
+
+// a load as initSettings and initForms do it: read, bake, offer
+static void Load(Profiles &profiles, const char *start) {
+    Settings settings;
+    Profiles loading;
+    ReadSettings(ThreeProfiles(start), settings, loading);
+    for (auto &profile: loading.bank) {
+        if (profile->health.keyframes > 1) { profile->healthTrack = timeline::bake(profile->health.easingFunction, profile->health.keyframes); }
+    }
+    profiles.offer(std::move(loading.bank), loading.index);
+}
+
+static check::Case handoff("profiles.handoff", []() {
+    Profiles profiles;
+    MainThread thread(profiles);
+    Load(profiles, "combat");
+    check::expect(profiles.bank.empty() && profiles.active.load() == nullptr, "an offered bank is not used before the main thread takes it");
+    thread.tick();
+    auto combat = profiles.active.load();
+    check::expect(profiles.bank.size() == 3 && combat && combat->name == "combat" && profiles.index == 1, "the main thread starts on the configured profile");
+    check::expect(thread.health.applies == 1 && thread.health.params.baked && thread.health.params.tint[0].red == 1.0f, "and writes its looks into the imods");
+    // a reload while combat is active: the old profiles outlive the swap until the main thread has switched away
+    Load(profiles, "");
+    check::expect(profiles.active.load() == combat && combat->name == "combat", "the active profile is untouched until the main thread takes the new bank");
+    thread.tick();
+    check::expect(thread.retired.size() == 3 && thread.retired[1].get() == combat, "the old bank is handed back, not freed under the active pointer");
+    check::expect(profiles.active.load() != combat && profiles.active.load()->name == "base" && profiles.index == 0, "the reload switches to its own starting profile");
+    thread.retired.clear();
+    // nothing to take: no switch
+    thread.tick();
+    check::expect(thread.health.applies == 2, "a tick with no requests switches nothing");
+    // an empty bank (a load that didn't happen) is never offered
+    profiles.offer(Profiles::Bank(), 0);
+    thread.tick();
+    check::expect(profiles.bank.size() == 3, "an empty bank is not offered");
+});
+
+static check::Case hotkey("profiles.hotkey", []() {
+    Profiles profiles;
+    MainThread thread(profiles);
+    Load(profiles, "");
+    thread.tick();
+    // presses between ticks add up, and step through the bank in file order
+    profiles.cycles.fetch_add(1);
+    thread.tick();
+    check::expect(profiles.index == 1 && profiles.active.load()->name == "combat", "a press steps on to the next profile");
+    profiles.cycles.fetch_add(1);
+    profiles.cycles.fetch_add(1);
+    thread.tick();
+    check::expect(profiles.index == 0 && thread.health.applies == 3, "two presses in one tick step on twice, and switch once");
+    // a press together with a reload steps on from the reloaded bank's start
+    Load(profiles, "combat");
+    profiles.cycles.fetch_add(1);
+    thread.tick();
+    check::expect(profiles.index == 2 && profiles.active.load()->name == "calm" && !profiles.active.load()->stamina.enabled, "a press with a reload steps on from the new start");
+    thread.retired.clear();
+    // a single profile has nothing to cycle to
+    Profiles single;
+    MainThread alone(single);
+    Settings settings;
+    Profiles loading;
+    ResetProfiles(settings, loading);
+    single.offer(std::move(loading.bank), 0);
+    alone.tick();
+    single.cycles.fetch_add(5);
+    alone.tick();
+    check::expect(single.index == 0 && alone.health.applies == 1 && single.cycles.load() == 0, "presses with one profile are dropped");
+});
+
+static check::Case noAllocation("profiles.allocations", []() {
+    Profiles profiles;
+    MainThread thread(profiles);
+    Load(profiles, "");
+    thread.tick();
+    // a second bank, offered ahead so only the take is counted
+    Load(profiles, "calm");
+    check::Allocations allocations;
+    thread.tick();
+    for (int i = 0; i < 1000; i++) {
+        profiles.cycles.fetch_add(1);
+        thread.tick();
+    }
+    auto counted = allocations.count();
+    check::expect(counted == 0 && thread.health.applies == 1002, "taking a bank and switching profiles never allocates (or parses)");
+    check::expect(profiles.index == (2 + 1000) % 3, "every press switched");
+});
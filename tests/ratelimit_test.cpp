@@ -0,0 +1,79 @@
+// ratelimit.h: one line per interval per limiter, the count of suppressed lines on the next one through, limiters
+// independent of each other (one overlay's faults never hide another's), and no allocation or lost count when
+// threads hammer the same limiter
+#include <atomic>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <spdlog/pattern_formatter.h>
+#include <spdlog/sinks/ostream_sink.h>
+#include "check.h"
+#include "../ratelimit.h"
+
+static check::Case limiters("ratelimit.limiters", []() {
+    auto saved = rate_limited::interval;
+    rate_limited::interval = std::chrono::milliseconds(60000);
+    rate_limited::Limiter health, stamina;
+    std::uint32_t suppressed = 99;
+    check::expect(health.allow(suppressed) && suppressed == 0, "a limiter's first line gets through");
+    bool held = true;
+    for (int i = 0; i < 5; i++) { held = held && !health.allow(suppressed); }
+    check::expect(held, "further lines within the interval are suppressed");
+    check::expect(stamina.allow(suppressed) && suppressed == 0, "another limiter's line still gets through");
+    // the interval passes: the next line through says how many were dropped
+    rate_limited::interval = std::chrono::milliseconds(0);
+    check::expect(health.allow(suppressed) && suppressed == 5, "the next line through counts the suppressed ones");
+    check::expect(health.allow(suppressed) && suppressed == 0, "and the count starts over");
+    // a hot path checking its limiter doesn't allocate
+    rate_limited::interval = std::chrono::milliseconds(60000);
+    check::Allocations allocations;
+    for (int i = 0; i < 1000; i++) { health.allow(suppressed); }
+    check::expect(allocations.count() == 0, "checking a limiter doesn't allocate");
+    rate_limited::interval = saved;
+});
+
+static check::Case concurrent("ratelimit.concurrent", []() {
+    auto saved = rate_limited::interval;
+    rate_limited::interval = std::chrono::milliseconds(60000);
+    rate_limited::Limiter shared;
+    constexpr int threads = 4, calls = 100000;
+    std::atomic<int> allowed = 0;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&]() {
+            std::uint32_t suppressed = 0;
+            for (int i = 0; i < calls; i++) { if (shared.allow(suppressed)) { allowed++; } }
+        });
+    }
+    for (auto &worker: workers) { worker.join(); }
+    check::expect(allowed == 1, "one line per interval, whichever thread gets there first");
+    rate_limited::interval = std::chrono::milliseconds(0);
+    std::uint32_t suppressed = 0;
+    check::expect(shared.allow(suppressed) && suppressed == threads * calls - 1, "every suppressed line is counted");
+    rate_limited::interval = saved;
+});
+
+static check::Case lines("ratelimit.lines", []() {
+    // the lines as they reach the log, through a logger of the case's own
+    std::ostringstream out;
+    auto previous = spdlog::default_logger();
+    auto capture = std::make_shared<spdlog::logger>("ratelimit", std::make_shared<spdlog::sinks::ostream_sink_st>(out));
+    capture->set_formatter(std::make_unique<spdlog::pattern_formatter>("%v", spdlog::pattern_time_type::local, "\n"));
+    capture->set_level(spdlog::level::info);
+    spdlog::set_default_logger(capture);
+    auto saved = rate_limited::interval;
+    rate_limited::interval = std::chrono::milliseconds(60000);
+    rate_limited::Limiter health, stamina;
+    for (int i = 0; i < 3; i++) {
+        rate_limited::warn(health, "Health overlay fault ({})", i);
+        rate_limited::warn(stamina, "Stamina overlay fault ({})", i);
+    }
+    rate_limited::interval = std::chrono::milliseconds(0);
+    rate_limited::warn(health, "Health overlay fault ({})", 3);
+    spdlog::set_default_logger(previous);
+    rate_limited::interval = saved;
+    check::expect(out.str() == "Health overlay fault (0)\nStamina overlay fault (0)\n(2 repeats of the following line suppressed)\nHealth overlay fault (3)\n",
+        "each overlay's first fault is logged, and the next line through counts that overlay's suppressed ones");
+});
@@ -0,0 +1,134 @@
+// sequence.h: tick, sleep and signal waits resume when they should and only then, cancellation on pause and reload
+// ends suspended sequences and runs their destructors, stale waits never resume a sequence that reused a slot, and
+// exceptions end only their sequence
+#include <stdexcept>
+#include "check.h"
+#include "../sequence.h"
+
+// counts the destructors of sequence frames, so cancellation can be seen to run them
+struct Guard {
+    int *destroyed;
+    ~Guard() { (*destroyed)++; }
+};
+
+static sequence::Task CountTicks(sequence::Executor &executor, int *ticks, int *destroyed) {
+    Guard guard{destroyed};
+    while (true) {
+        co_await executor.nextTick();
+        (*ticks)++;
+    }
+}
+
+static sequence::Task SleepThenMark(sequence::Executor &executor, std::uint64_t ms, std::uint64_t *wokeAt, int *destroyed) {
+    Guard guard{destroyed};
+    co_await executor.sleep(ms);
+    *wokeAt = executor.now();
+}
+
+static sequence::Task WaitForChange(sequence::Executor &executor, sequence::Signal &signal, float delta, int *changes, int *destroyed) {
+    Guard guard{destroyed};
+    while (true) {
+        co_await executor.changed(signal, delta);
+        (*changes)++;
+    }
+}
+
+static sequence::Task ThrowOnSecondTick(sequence::Executor &executor) {
+    co_await executor.nextTick();
+    co_await executor.nextTick();
+    throw std::runtime_error("sequence fault");
+}
+
+static sequence::Task SpawnChild(sequence::Executor &executor, int *ticks, int *destroyed) {
+    co_await executor.nextTick();
+    executor.spawn(9, CountTicks(executor, ticks, destroyed));
+    co_await executor.nextTick();
+    (*ticks) += 100;
+}
+
+static check::Case waits("sequence.waits", []() {
+    sequence::Executor executor;
+    int ticks = 0, changes = 0, destroyed = 0;
+    std::uint64_t wokeAt = 0;
+    sequence::Signal stat(executor, 0.5f);
+    executor.spawn(0, CountTicks(executor, &ticks, &destroyed));
+    executor.spawn(1, SleepThenMark(executor, 100, &wokeAt, &destroyed));
+    executor.spawn(2, WaitForChange(executor, stat, 0.05f, &changes, &destroyed));
+    check::expect(executor.size() == 3, "three sequences live after spawning");
+    check::expect(executor.nextDeadline() == 100, "next deadline is the sleep's");
+    for (std::uint64_t now = 10; now <= 90; now += 10) { executor.tick(now); }
+    check::expect(ticks == 9, "a nextTick wait resumes once per tick");
+    check::expect(wokeAt == 0, "a sleep doesn't resume before its deadline");
+    executor.tick(105);
+    check::expect(wokeAt == 105, "a sleep resumes on the first tick past its deadline");
+    check::expect(executor.size() == 2 && !executor.running(1), "a finished sequence is ended");
+    stat.set(0.52f);
+    executor.tick(110);
+    check::expect(changes == 0, "a change within delta doesn't wake");
+    stat.set(0.56f);
+    check::expect(changes == 0, "a signal wakes its waiters on the next tick, not inside set");
+    executor.tick(120);
+    check::expect(changes == 1, "a change past delta wakes once");
+    stat.set(0.57f);
+    executor.tick(130);
+    check::expect(changes == 1, "the delta counts from where the wait started");
+    check::expect(executor.nextDeadline() == sequence::never, "no deadline once the sleep is done");
+    // a sequence spawned from inside another runs, and the outer one still resumes where it left off
+    int childTicks = 0, childDestroyed = 0;
+    executor.spawn(3, SpawnChild(executor, &childTicks, &childDestroyed));
+    executor.tick(140);
+    executor.tick(150);
+    check::expect(childTicks == 101, "a nested spawn runs, and its parent resumes after it");
+    check::expect(executor.running(9) && !executor.running(3), "the child outlives its parent");
+});
+
+static check::Case cancel("sequence.cancel", []() {
+    sequence::Executor executor;
+    int ticks = 0, changes = 0, destroyed = 0;
+    std::uint64_t wokeAt = 0;
+    sequence::Signal stat(executor, 1.0f);
+    executor.spawn(0, CountTicks(executor, &ticks, &destroyed));
+    executor.spawn(1, SleepThenMark(executor, 50, &wokeAt, &destroyed));
+    executor.spawn(2, WaitForChange(executor, stat, 0.0f, &changes, &destroyed));
+    executor.tick(10);
+    // pause: one overlay's sequences end where they are, the rest keep going
+    check::expect(executor.nextDeadline() == 50, "a sleep sets the next deadline");
+    check::expect(executor.cancel(1) == 1 && destroyed == 1, "cancel ends the owner's suspended sequence and runs its destructors");
+    check::expect(executor.nextDeadline() == sequence::never, "and drops its sleep, so nothing wakes the loop for it");
+    stat.set(0.5f);
+    executor.tick(60);
+    check::expect(wokeAt == 0, "a cancelled sleep never resumes");
+    check::expect(ticks == 2 && changes == 1, "other owners keep running after a cancel");
+    // reload: everything ends, and nothing left in the wait lists resumes
+    stat.set(0.4f);
+    check::expect(executor.cancelAll() == 2 && destroyed == 3, "cancelAll ends every sequence");
+    executor.tick(70);
+    check::expect(ticks == 2 && changes == 1 && executor.size() == 0, "nothing resumes after cancelAll");
+    // a new sequence in a reused slot isn't resumed by waits its cancelled predecessor left behind
+    executor.spawn(1, SleepThenMark(executor, 1000, &wokeAt, &destroyed));
+    executor.spawn(4, SleepThenMark(executor, 20, &wokeAt, &destroyed));
+    executor.cancelAll();
+    int fresh = 0;
+    executor.spawn(1, CountTicks(executor, &fresh, &destroyed));
+    executor.spawn(5, CountTicks(executor, &fresh, &destroyed));
+    executor.tick(100);
+    check::expect(fresh == 2 && wokeAt == 0, "stale waits don't resume a sequence that reused their slot");
+    check::expect(executor.nextDeadline() == sequence::never, "no deadline is left from the cancelled sleeps");
+    executor.cancelAll();
+    // a sequence that throws is ended, and the rest of the tick still runs
+    int after = 0;
+    executor.spawn(6, ThrowOnSecondTick(executor));
+    executor.spawn(7, CountTicks(executor, &after, &destroyed));
+    executor.tick(110);
+    bool threw = false;
+    try { executor.tick(120); } catch (const std::runtime_error&) { threw = true; }
+    check::expect(threw, "tick rethrows a sequence's exception");
+    check::expect(after == 2 && !executor.running(6) && executor.running(7), "an exception ends only its sequence");
+    // frames left at destruction are destroyed with the executor
+    int left = 0;
+    {
+        sequence::Executor scoped;
+        scoped.spawn(0, CountTicks(scoped, &ticks, &left));
+    }
+    check::expect(left == 1, "the executor destroys its sequences");
+});
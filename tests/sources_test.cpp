@@ -0,0 +1,105 @@
+// sources.h: names and binding (case, bad names, a full table, a config binding a name before its plugin registers
+// it), concurrent producers' values reaching a reader on another thread whole (value and update count from the same
+// push) and in order, and an overlay with a Source key following its source instead of its actor value
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+#include "check.h"
+#include "../overlay.h"
+#include "../sources.h"
+
+// pushed values are k / scale: exact floats, so a value tells which push wrote it
+static constexpr float scale = 1 << 22;
+
+static check::Case names("sources.names", []() {
+    sources::Registry registry;
+    auto hunger = registry.bind("Hunger");
+    check::expect(hunger == 0 && registry.bind("hunger") == hunger && registry.find("HUNGER") == hunger, "names are case insensitive");
+    check::expect(std::string(registry.name(hunger)) == "hunger", "names are kept lowercase");
+    check::expect(registry.value(hunger) == 1.0f && registry.updates(hunger) == 0, "a source nobody pushed to is full");
+    for (auto bad: {"", "has space", "dash-ed", "tab\tbed", "a_name_that_is_much_too_long_for_a_slot"}) {
+        check::expect(registry.bind(bad) == sources::none, "bad names don't bind");
+    }
+    check::expect(registry.bind("a_name_that_is_31_characters_ok") != sources::none, "31 characters bind");
+    check::expect(registry.find("cold") == sources::none, "find doesn't add");
+    while (registry.size() < sources::maxSources) { registry.bind("filler" + std::to_string(registry.size())); }
+    check::expect(registry.bind("onemore") == sources::none && registry.bind("hunger") == hunger, "a full table binds no new names, known ones still bind");
+    check::expect(registry.push(hunger, 0.25f) && registry.value(hunger) == 0.25f && registry.updates(hunger) == 1, "a push sets the value");
+    check::expect(registry.push(hunger, 2.0f) && registry.value(hunger) == 1.0f && registry.push(hunger, -1.0f) && registry.value(hunger) == 0.0f, "values are clamped");
+    check::expect(!registry.push(hunger, std::nanf("")) && !registry.push(hunger, std::numeric_limits<float>::infinity()) && registry.value(hunger) == 0.0f && registry.updates(hunger) == 3, "non-numbers are rejected");
+    check::expect(!registry.push(sources::none, 0.5f) && !registry.push(static_cast<int>(sources::maxSources), 0.5f) && registry.value(sources::none) == 1.0f, "unknown sources are rejected and read full");
+});
+
+// producers each register a source through the API (all at once, some racing on a shared name) and push 1..pushes / scale
+// to it, while a reader checks every read is whole and in order; the final values must all be visible after the join
+static check::Case concurrent("sources.concurrent", []() {
+    constexpr int producers = 8, pushes = 1 << 18;
+    std::atomic<bool> go = false;
+    std::atomic<int> running = producers;
+    std::vector<StatFXAPI::Source> own(producers, sources::none), shared(producers, sources::none);
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&, p]() {
+            while (!go.load()) { std::this_thread::yield(); }
+            shared[p] = sources::api.RegisterSource("Concurrent_Shared");
+            own[p] = sources::api.RegisterSource(("producer" + std::to_string(p)).c_str());
+            for (int k = 1; k <= pushes; k++) { sources::api.Push(own[p], static_cast<float>(k) / scale); }
+            running--;
+        });
+    }
+    long torn = 0, backwards = 0, outside = 0;
+    std::thread reader([&]() {
+        std::vector<std::uint32_t> last(sources::maxSources, 0);
+        while (!go.load()) { std::this_thread::yield(); }
+        while (running.load() > 0) {
+            for (int s = 0; s < static_cast<int>(sources::registry.size()); s++) {
+                auto reading = sources::registry.read(s);
+                if (reading.value < 0.0f || reading.value > 1.0f) { outside++; }
+                if (reading.updates == 0) continue;
+                if (std::string(sources::registry.name(s)).starts_with("producer") && reading.value != static_cast<float>(reading.updates) / scale) { torn++; }
+                if (reading.updates < last[s]) { backwards++; }
+                last[s] = reading.updates;
+            }
+        }
+    });
+    go = true;
+    for (auto &thread: threads) { thread.join(); }
+    reader.join();
+    bool sameShared = true, allOwn = true, allFinal = true;
+    for (int p = 0; p < producers; p++) {
+        sameShared = sameShared && shared[p] != sources::none && shared[p] == shared[0];
+        allOwn = allOwn && own[p] != sources::none && own[p] != shared[0];
+        for (int q = 0; q < p; q++) { allOwn = allOwn && own[p] != own[q]; }
+        allFinal = allFinal && sources::api.Get(own[p]) == static_cast<float>(pushes) / scale && sources::registry.updates(own[p]) == static_cast<std::uint32_t>(pushes);
+    }
+    check::expect(sameShared, "concurrent registrations of a name get the same source");
+    check::expect(allOwn, "every producer gets a source of its own");
+    check::expect(torn == 0, "a read is one push, never parts of two");
+    check::expect(backwards == 0, "reads never go back to an older push");
+    check::expect(outside == 0, "reads stay in 0 to 1");
+    check::expect(allFinal, "every producer's last push is visible after it's done");
+});
+
+// the config binds a source before its plugin registers it, and the overlay follows what the plugin pushes
+static check::Case binding("sources.binding", []() {
+    mINI::INIStructure ini;
+    ini["Stamina"]["SaturationMult"] = "0.3";
+    ini["Stamina"]["Source"] = "Cold";
+    ini["Magicka"]["BrightnessMult"] = "0.6";
+    ini["Magicka"]["Meter"] = "dash-ed";
+    Settings settings;
+    Profiles profiles;
+    ReadSettings(ini, settings, profiles);
+    const Profile &profile = *profiles.bank.front();
+    auto cold = sources::api.RegisterSource("cold");
+    check::expect(cold != sources::none && profile.stamina.source == cold, "a config binds the source its plugin registers later");
+    check::expect(profile.magicka.source == sources::none && profile.health.source == sources::none, "a bad or missing Source follows the actor value");
+    overlay::ActorSets sets;
+    sets.player.min = sets.player.max = sets.player.average = sets.player.lowestHealth = {0.9f, 0.8f, 0.7f};
+    check::expect(sets.value(profile.stamina, actors::Stamina) == 1.0f, "a source with no values yet is full");
+    sources::api.Push(cold, 0.3f);
+    check::expect(sets.value(profile.stamina, actors::Stamina) == 0.3f && sets.value(profile.magicka, actors::Magicka) == 0.7f, "the overlay follows its source, the others their actor values");
+});
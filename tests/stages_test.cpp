@@ -0,0 +1,104 @@
+// stages.h and overlay::TickStages: the tables against each stage's range on random stage sets (every breakpoint, the
+// floats either side of it, and random values), and every stage's imod left where driving all of them every tick would
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "check.h"
+#include "standins.h"
+
+// n stages with random, often overlapping or touching, ranges and curves
+static Settings::Stages RandomStages(std::mt19937 &random, std::size_t n) {
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    const easing::easingFunction curves[] = {easing::linear, easing::easeInQuad, easing::easeOutCubic, easing::easeInOutSine};
+    Settings::Stages statStages;
+    std::vector<stages::Range> ranges;
+    for (std::size_t i = 0; i < n; i++) {
+        Settings::OverlayData look;
+        // snap some ends to a coarse grid, so stages share breakpoints
+        auto point = [&]() { return random() % 3 == 0 ? std::round(unit(random) * 10.0f) / 10.0f : unit(random); };
+        float a = point(), b = random() % 8 == 0 ? a : point();
+        look.startFraction = std::max(a, b);
+        look.endFraction = std::min(a, b);
+        look.easingFunction = curves[random() % 4];
+        statStages.looks.push_back(look);
+        ranges.push_back({look.startFraction, look.endFraction});
+    }
+    statStages.table.compile(ranges);
+    return statStages;
+}
+
+// where an imod should be with the stat at value, from the stage's look alone
+static bool Matches(const Settings::OverlayData &look, const standin::Imod &imod, float value) {
+    auto state = stages::classify({look.startFraction, look.endFraction}, value);
+    if (state == stages::State::Off) { return !imod.on; }
+    return imod.on && imod.strength == overlay::EasedValue(value, look.startFraction, look.endFraction, look.easingFunction);
+}
+
+static check::Case tables("stages.tables", []() {
+    std::mt19937 random(44);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    bool statesMatch = true, rampingMatch = true, hintsMatch = true;
+    for (int set = 0; set < 500; set++) {
+        auto n = 1 + static_cast<std::size_t>(random() % stages::maxStages);
+        auto statStages = RandomStages(random, n);
+        auto &table = statStages.table;
+        std::vector<float> values = {0.0f, 1.0f, -0.5f, 1.5f};
+        for (auto point: table.points()) {
+            values.push_back(point);
+            values.push_back(std::nextafter(point, -2.0f));
+            values.push_back(std::nextafter(point, 2.0f));
+        }
+        for (int i = 0; i < 200; i++) { values.push_back(unit(random)); }
+        for (auto value: values) {
+            auto segment = table.find(value);
+            std::size_t ramping = 0;
+            for (std::size_t i = 0; i < n; i++) {
+                auto &look = statStages.looks[i];
+                auto expected = stages::classify({look.startFraction, look.endFraction}, value);
+                statesMatch = statesMatch && table.state(segment, i) == expected;
+                ramping += expected == stages::State::Ramping;
+            }
+            rampingMatch = rampingMatch && table.rampingIn(segment).size() == ramping;
+            // whatever the hint, right or wrong
+            for (auto hint: {stages::Table::none, std::size_t{0}, segment, segment + 1, table.segments() - 1, table.segments()}) {
+                hintsMatch = hintsMatch && table.find(value, hint) == segment;
+            }
+        }
+    }
+    check::expect(statesMatch, "every stage's state in the table is the one its range gives, at and either side of every breakpoint");
+    check::expect(rampingMatch, "each segment lists exactly the stages ramping in it");
+    check::expect(hintsMatch, "a hinted lookup finds the same segment as a search");
+});
+
+static check::Case ticks("stages.ticks", []() {
+    std::mt19937 random(45);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    bool matches = true;
+    for (int set = 0; set < 300; set++) {
+        auto n = 1 + static_cast<std::size_t>(random() % stages::maxStages);
+        auto statStages = RandomStages(random, n);
+        auto &table = statStages.table;
+        // a random walk: small steps, hits, values sitting on breakpoints, and the imods stopped now and then
+        std::vector<standin::Imod> imods(n);
+        std::vector<game::Imod*> pointers;
+        for (auto &imod: imods) { pointers.push_back(&imod); }
+        stages::Cursor cursor;
+        float value = 1.0f;
+        for (int tick = 0; tick < 1000; tick++) {
+            switch (random() % 10) {
+                case 0: value = unit(random); break;
+                case 1: if (!table.points().empty()) { value = table.points()[random() % table.points().size()]; } break;
+                case 2: break;
+                default: value = std::clamp(value + (unit(random) - 0.5f) * 0.02f, 0.0f, 1.0f);
+            }
+            if (random() % 50 == 0) {
+                for (auto &imod: imods) { imod.stop(); }
+                cursor.reset();
+            }
+            overlay::TickStages(value, statStages, &cursor, pointers);
+            for (std::size_t i = 0; i < n; i++) { matches = matches && Matches(statStages.looks[i], imods[i], value); }
+        }
+    }
+    check::expect(matches, "only touching the stages that ramp or changed state leaves every imod where driving them all would");
+});
@@ -0,0 +1,82 @@
+/* Stand-ins for the game's side of game.h, for the tests: an imod that remembers what it was asked to do, actor
+ * values set by hand that count how often they're read, and one overlay's tick state run against them.
+*/
+#pragma once
+#include <vector>
+#include "../overlay.h"
+
+namespace standin
+{
+    class Imod : public game::Imod {
+    public:
+        bool loaded() const override { return isLoaded; }
+        bool live() const override { return on; }
+        void trigger(float value) override { on = true; expired = false; age = 0.0f; strength = value; triggers++; }
+        void drive(float at, float value) override {
+            if (expired) { staleWrites++; }
+            on = true;
+            age = driven = at;
+            strength = value;
+            drives++;
+        }
+        void hold() override { if (expired) { staleWrites++; } age = driven; holds++; }
+        void stop() override { if (on) { stops++; } on = false; expired = false; strength = 0.0f; }
+        void apply(const overlay::ImodParams &written) override { params = written; duration = written.baked ? timeline::span : 1.0f; applies++; }
+        long updates() const { return triggers + drives + stops; }
+        // the engine's frames between two ticks: a live instance ages by real time, and past the form's duration it is
+        // retired while the slot still points at it, so the next drive or hold would write through a stale pointer
+        void advance(float seconds) {
+            if (!on) { return; }
+            age += seconds;
+            if (age > duration) { expired = true; }
+        }
+
+        bool isLoaded = true;
+        bool on = false;
+        float strength = 0.0f;
+        float age = 0.0f, driven = 0.0f; // the instance's age (advance moves it on like the engine does) and the last driven one
+        float duration = 1.0f;           // the form's, as the last apply left it
+        bool expired = false;            // retired by the engine, with the slot still set
+        long triggers = 0, drives = 0, stops = 0, holds = 0, applies = 0, staleWrites = 0;
+        overlay::ImodParams params;
+    };
+
+    // the player, the combat target and the followers, each {health, stamina, magicka}
+    class Values : public game::ActorValues {
+    public:
+        struct Actor { float health = 1.0f, stamina = 1.0f, magicka = 1.0f; };
+        void sample(actors::Target target, actors::SampleBatch &batch) override {
+            reads++;
+            switch (target) {
+                case actors::Target::CombatTarget: if (hasTarget) { batch.push(combatTarget.health, combatTarget.stamina, combatTarget.magicka); } break;
+                case actors::Target::Followers: for (auto &follower: followers) { batch.push(follower.health, follower.stamina, follower.magicka); } break;
+                default: batch.push(player.health, player.stamina, player.magicka);
+            }
+        }
+        Actor player, combatTarget;
+        bool hasTarget = true;
+        std::vector<Actor> followers;
+        long reads = 0; // sample calls, one per actor set read
+    };
+
+    // one overlay's state between ticks, ticked on the player's stat like the overlay thread does
+    struct Overlay {
+        Settings::OverlayData stat;
+        Values values;
+        overlay::ActorSets sets;
+        Imod imod;
+        oscillator::Oscillator osc;
+        filter::Filter noise;
+        predict::Predictor lead;
+        lifecycle::Phase phase = lifecycle::Phase::Inactive;
+        float current = 1.0f, actual = 1.0f, emitted = 0.0f;
+
+        void tick(float sample, float seconds = 0.025f) {
+            values.player = {sample, sample, sample};
+            sets.sample(values, true, false, false);
+            expr::Vars shared = {};
+            expr::setShared(shared, sample, sample, sample, 0);
+            overlay::Tick(&current, &actual, actors::Health, stat, sets, shared, imod, &osc, &noise, &lead, &phase, &emitted, seconds);
+        }
+    };
+}
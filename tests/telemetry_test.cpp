@@ -0,0 +1,101 @@
+// telemetry.h: a record caught mid-write or overwritten is skipped and counted, never read torn, a reader lapped by
+// the producer skips ahead to the oldest intact record, and a reader polling while the producer publishes flat out
+// gets every record whole and in order
+#include <atomic>
+#include <string>
+#include <thread>
+#include "check.h"
+#include "../telemetry.h"
+
+// a feed name of this run's own, so parallel test runs don't share a ring
+static std::string FeedName(const char *which) { return "StatFX.Test." + std::to_string(telemetry::nowNs()) + "." + which; }
+
+// every field follows from the tick, so a record mixing two writes shows
+static telemetry::Record Make(std::uint64_t tick) {
+    telemetry::Record record;
+    record.tick = tick;
+    record.timestampNs = tick * 7;
+    for (int s = 0; s < 3; s++) {
+        record.actual[s] = static_cast<float>(tick & 0xffff);
+        record.current[s] = static_cast<float>((tick + 1) & 0xffff);
+        record.intensity[s] = static_cast<float>((tick + 2) & 0xffff);
+    }
+    return record;
+}
+
+static bool Whole(const telemetry::Record &record) {
+    auto expected = Make(record.tick);
+    bool same = record.timestampNs == expected.timestampNs;
+    for (int s = 0; s < 3; s++) {
+        same = same && record.actual[s] == expected.actual[s] && record.current[s] == expected.current[s] && record.intensity[s] == expected.intensity[s];
+    }
+    return same;
+}
+
+static check::Case torn("telemetry.torn", []() {
+    auto name = FeedName("torn");
+    telemetry::Producer producer;
+    telemetry::Consumer consumer;
+    telemetry::Mapping writer; // the producer's view of the ring, to leave a slot mid-write
+    if (!check::expect(producer.open(name) && consumer.open(name) && writer.open(name, false), "the feed opens")) { return; }
+    for (std::uint64_t tick = 0; tick < 3; tick++) { producer.publish(Make(tick)); }
+    // record 1's slot marked odd, as if the producer were still copying it in
+    writer.ring->slots[1].sequence.store(2 * 1 + 1);
+    writer.ring->slots[1].record.actual[0] = -1.0f;
+    telemetry::Record record;
+    check::expect(consumer.poll(record) && record.tick == 0 && Whole(record), "an intact record reads");
+    check::expect(consumer.poll(record) && record.tick == 2 && Whole(record) && consumer.dropped == 1, "a record caught mid-write is skipped and counted");
+    check::expect(!consumer.poll(record), "caught up with the producer");
+    // a slot already holding a later record (overwritten after the reader read the count) is skipped too
+    producer.publish(Make(3));
+    writer.ring->slots[3].sequence.store(2 * (3 + telemetry::capacity) + 2);
+    check::expect(!consumer.poll(record) && consumer.dropped == 2, "an overwritten record is skipped and counted");
+});
+
+static check::Case lapped("telemetry.lapped", []() {
+    auto name = FeedName("lapped");
+    telemetry::Producer producer;
+    telemetry::Consumer consumer;
+    if (!check::expect(producer.open(name) && consumer.open(name), "the feed opens")) { return; }
+    const std::uint64_t published = telemetry::capacity + 10;
+    for (std::uint64_t tick = 0; tick < published; tick++) { producer.publish(Make(tick)); }
+    telemetry::Record record;
+    std::uint64_t read = 0, first = 0;
+    bool whole = true;
+    while (consumer.poll(record)) {
+        if (read++ == 0) { first = record.tick; }
+        whole = whole && Whole(record);
+    }
+    check::expect(first == 10 && read == telemetry::capacity && consumer.dropped == 10, "a lapped reader skips to the oldest record still in the ring");
+    check::expect(whole, "every record read is whole");
+});
+
+static check::Case concurrent("telemetry.concurrent", []() {
+    auto name = FeedName("concurrent");
+    telemetry::Producer producer;
+    telemetry::Consumer consumer;
+    if (!check::expect(producer.open(name) && consumer.open(name), "the feed opens")) { return; }
+    constexpr std::uint64_t published = 1 << 20;
+    std::atomic<bool> done = false;
+    std::thread writer([&]() {
+        for (std::uint64_t tick = 0; tick < published; tick++) { producer.publish(Make(tick)); }
+        done = true;
+    });
+    telemetry::Record record;
+    std::uint64_t read = 0, last = 0;
+    bool whole = true, ordered = true;
+    for (bool finished = false; !finished;) {
+        finished = done.load();
+        while (consumer.poll(record)) {
+            whole = whole && Whole(record);
+            ordered = ordered && (read == 0 || record.tick > last);
+            last = record.tick;
+            read++;
+        }
+        std::this_thread::yield();
+    }
+    writer.join();
+    check::expect(whole, "no record is read torn while the producer writes");
+    check::expect(ordered, "records are read in order");
+    check::expect(read + consumer.dropped == published && last == published - 1, "every record is either read or counted as dropped");
+});
@@ -0,0 +1,114 @@
+// timeline.h and overlay::ComputeImodParams: the baked keys, interpolated the way the engine does, against EasedValue
+// for every curve, and a settled baked overlay pinning its instance's age while the engine carries it on, staying put
+// and alive however far apart its ticks are
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "check.h"
+#include "standins.h"
+
+// the keys of one of the params' tracks, as a timeline::Track on normalized time
+static timeline::Track Keys(const overlay::ImodParams &params, const float *values) {
+    timeline::Track keys;
+    for (int i = 0; i < params.count; i++) { keys.times.push_back(params.times[i] / timeline::span); }
+    keys.values.assign(values, values + params.count);
+    return keys;
+}
+
+static check::Case keys("timeline.keys", []() {
+    bool tintMatches = true, channelsMatch = true, timesMatch = true, closeAtMax = true;
+    for (int e = 0; e <= easing::EaseInOutBounce; e++) {
+        auto curve = easing::getEasingFunction(static_cast<easing::easing_functions>(e));
+        for (int keyframes: {2, 8, 24, timeline::maxKeys}) {
+            Settings::OverlayData stat;
+            stat.startFraction = 0.8f;
+            stat.endFraction = 0.2f;
+            stat.easingFunction = curve;
+            stat.keyframes = keyframes;
+            stat.tint = {1.0f, 0.5f, 0.25f, 0.75f};
+            stat.contrastMult = 0.5f;
+            stat.saturationAdd = -0.3f;
+            stat.brightnessMult = 1.4f;
+            auto track = timeline::bake(curve, keyframes);
+            auto params = overlay::ComputeImodParams(stat, track);
+            timesMatch = timesMatch && params.baked && params.count == track.size() && params.times[params.count - 1] == timeline::span;
+            std::vector<float> alphas;
+            for (int i = 0; i < params.count; i++) { alphas.push_back(params.tint[i].alpha); }
+            auto alpha = Keys(params, alphas.data());
+            auto contrast = Keys(params, params.cinematic[overlay::ContrastMult].data());
+            auto saturation = Keys(params, params.cinematic[overlay::SaturationAdd].data());
+            auto brightness = Keys(params, params.cinematic[overlay::BrightnessMult].data());
+            // the baked track is off the curve by at most its own max error, so each channel is off by that times its span
+            float error = timeline::maxError(track, curve, 4096) + 1e-4f;
+            closeAtMax = closeAtMax && (keyframes < timeline::maxKeys || error < 0.01f);
+            for (int i = 0; i <= 4096; i++) {
+                float value = 1.0f - i / 4096.0f;
+                float t = timeline::progress(value, stat.startFraction, stat.endFraction);
+                float eased = overlay::EasedValue(value, stat.startFraction, stat.endFraction, curve);
+                tintMatches = tintMatches && std::abs(timeline::evaluate(alpha, t) - stat.tint.alpha * eased) <= stat.tint.alpha * error;
+                channelsMatch = channelsMatch
+                    && std::abs(timeline::evaluate(contrast, t) - (1.0f + (stat.contrastMult - 1.0f) * eased)) <= 0.5f * error
+                    && std::abs(timeline::evaluate(saturation, t) - stat.saturationAdd * eased) <= 0.3f * error
+                    && std::abs(timeline::evaluate(brightness, t) - (1.0f + (stat.brightnessMult - 1.0f) * eased)) <= 0.4f * error;
+            }
+        }
+    }
+    check::expect(timesMatch, "the params carry every baked key");
+    check::expect(tintMatches, "the tint's alpha at the driven age is the eased intensity, within the track's error");
+    check::expect(channelsMatch, "each cinematic channel at the driven age goes from neutral to full along the eased curve");
+    check::expect(closeAtMax, "at the most keys every curve's track is within 1% of it");
+    // without Keyframes there's a single key at full strength, and the tick scales it by Trigger strength
+    Settings::OverlayData single;
+    auto params = overlay::ComputeImodParams(single, timeline::Track());
+    check::expect(!params.baked && params.count == 1 && params.tint[0].alpha == single.tint.alpha, "an unbaked overlay writes one key");
+});
+
+// a baked overlay with its keys written into the stand-in's form
+static void Bake(standin::Overlay &overlay) {
+    overlay.stat.keyframes = 16;
+    overlay.stat.startFraction = 0.8f;
+    overlay.stat.endFraction = 0.2f;
+    overlay.imod.apply(overlay::ComputeImodParams(overlay.stat, timeline::bake(overlay.stat.easingFunction, overlay.stat.keyframes)));
+}
+
+static check::Case held("timeline.held", []() {
+    standin::Overlay overlay;
+    Bake(overlay);
+    // drain to 0.5 and settle there
+    for (int i = 0; i < 100; i++) { overlay.tick(0.5f); }
+    float driven = timeline::age(overlay.current, overlay.stat.startFraction, overlay.stat.endFraction);
+    check::expect(overlay.imod.on && overlay.imod.age == driven, "a baked overlay drives its instance to the stat's place on the timeline");
+    // the engine ages the instance between ticks, each settled tick puts it back without another update
+    auto drives = overlay.imod.drives;
+    bool pinned = true;
+    for (int i = 0; i < 100; i++) {
+        overlay.imod.advance(0.3f);
+        overlay.tick(0.5f);
+        pinned = pinned && overlay.imod.age == driven;
+    }
+    check::expect(pinned, "a settled baked overlay pins its instance's age every tick");
+    check::expect(overlay.imod.drives == drives && overlay.imod.holds >= 100, "pinning isn't an update");
+});
+
+static check::Case drift("timeline.drift", []() {
+    // settled at 0.5 and ticked every UpdateInterval, the engine ageing the instance by real time in between
+    bool still = true, alive = true;
+    for (float interval: {0.025f, 0.2f, 1.0f, 5.0f}) {
+        standin::Overlay overlay;
+        Bake(overlay);
+        for (int i = 0; i < 100; i++) { overlay.imod.advance(interval); overlay.tick(0.5f, interval); }
+        float worst = 0.0f;
+        for (int i = 0; i < 100; i++) {
+            overlay.imod.advance(interval);
+            worst = std::max(worst, std::abs(overlay.imod.age - overlay.imod.driven) / timeline::span);
+            overlay.tick(0.5f, interval);
+        }
+        // and a gap as long as a breaker's backoff
+        overlay.imod.advance(60.0f);
+        overlay.tick(0.5f, interval);
+        still = still && worst < 0.002f;
+        alive = alive && overlay.imod.on && !overlay.imod.expired && overlay.imod.staleWrites == 0;
+    }
+    check::expect(still, "between ticks the instance moves on by a hair of its curve, however long the interval");
+    check::expect(alive, "and is never retired by the engine under the overlay, so nothing writes through a stale instance");
+});
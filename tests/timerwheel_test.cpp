@@ -0,0 +1,89 @@
+// timerwheel.h: the wheel against a plain list of deadlines on random schedules, and overlays on their own intervals
+// on a simulated clock (every update on its deadline, one wakeup per distinct deadline)
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+#include "check.h"
+#include "../timerwheel.h"
+
+static check::Case againstList("timerwheel.list", []() {
+    constexpr std::size_t timers = 16;
+    timerwheel::Wheel wheel(timers);
+    std::vector<std::uint64_t> list(timers, timerwheel::never);
+    std::mt19937_64 random(1234);
+    // mostly short deadlines, some over every level of the wheel (and past the top)
+    auto delay = [&random]() -> std::uint64_t {
+        switch (random() % 6) {
+            case 0: return random() % 4;
+            case 1: case 2: return random() % 300;
+            case 3: return random() % 5000;
+            case 4: return random() % 400000;
+            default: return random() % 40000000;
+        }
+    };
+    std::uint64_t now = 0;
+    bool sameFired = true, inOrder = true, sameNext = true;
+    for (int step = 0; step < 200000; step++) {
+        auto id = static_cast<std::size_t>(random() % timers);
+        switch (random() % 4) {
+            case 0: case 1: {
+                auto deadline = now + delay();
+                wheel.schedule(id, deadline);
+                list[id] = deadline;
+                break;
+            }
+            case 2:
+                wheel.cancel(id);
+                list[id] = timerwheel::never;
+                break;
+            default: {
+                auto to = now + delay();
+                std::vector<std::pair<std::uint64_t, std::size_t>> fired, expected;
+                wheel.advance(to, [&](std::size_t which) { fired.push_back({wheel.deadline(which), which}); });
+                for (std::size_t i = 0; i < timers; i++) {
+                    if (list[i] <= to) { expected.push_back({list[i], i}); list[i] = timerwheel::never; }
+                }
+                // timers due on the same millisecond may fire in any order
+                inOrder = inOrder && std::is_sorted(fired.begin(), fired.end(), [](auto &a, auto &b) { return a.first < b.first; });
+                std::sort(fired.begin(), fired.end());
+                std::sort(expected.begin(), expected.end());
+                sameFired = sameFired && fired == expected;
+                now = to + 1;
+                break;
+            }
+        }
+        sameNext = sameNext && wheel.nextDeadline() == *std::min_element(list.begin(), list.end());
+    }
+    check::expect(sameFired, "advance fires exactly the timers due");
+    check::expect(inOrder, "timers fire in deadline order");
+    check::expect(sameNext, "the next deadline is the earliest timer's");
+});
+
+static check::Case simulated("timerwheel.intervals", []() {
+    // the overlay thread's loop on a clock that jumps straight to each next deadline
+    const std::vector<std::uint64_t> intervals = {16, 50, 200};
+    constexpr std::uint64_t duration = 10000;
+    timerwheel::Wheel wheel(intervals.size());
+    timerwheel::Stats stats;
+    std::vector<std::uint64_t> updates(intervals.size(), 0);
+    for (std::size_t i = 0; i < intervals.size(); i++) { wheel.schedule(i, 0); }
+    std::uint64_t wakes = 0;
+    for (auto now = wheel.nextDeadline(); now < duration; now = wheel.nextDeadline()) {
+        wakes++;
+        std::vector<std::size_t> due;
+        wheel.advance(now, [&](std::size_t which) { due.push_back(which); stats.record(wheel.deadline(which), now); });
+        if (!due.empty()) { stats.wakeups++; }
+        for (auto which: due) {
+            updates[which]++;
+            wheel.schedule(which, timerwheel::periodic(wheel.deadline(which), intervals[which], now));
+        }
+    }
+    std::set<std::uint64_t> deadlines;
+    for (auto interval: intervals) { for (std::uint64_t t = 0; t < duration; t += interval) { deadlines.insert(t); } }
+    check::expect(wakes == deadlines.size() && stats.wakeups == wakes, "one wakeup per distinct deadline, none with nothing to do");
+    check::expect(stats.maxLateMs == 0, "every update runs on its deadline");
+    for (std::size_t i = 0; i < intervals.size(); i++) { check::expect(updates[i] == (duration + intervals[i] - 1) / intervals[i], "each overlay updates at its own rate"); }
+    // after a stall (the thread parked for a menu), a periodic timer picks up one interval from now instead of catching up
+    check::expect(timerwheel::periodic(100, 16, 110) == 116 && timerwheel::periodic(100, 16, 5000) == 5016, "periodic deadlines skip missed updates");
+});
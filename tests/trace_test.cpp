@@ -0,0 +1,238 @@
+// trace.h: the written trace parsed back as JSON and checked against the trace-event format (metadata and complete
+// events, their threads, times and escaped names), buffers of the size Enable asked for that drop what doesn't fit,
+// and no event buffer for a thread until it records a span while tracing
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "check.h"
+#include "../trace.h"
+
+// just enough of a JSON parser to read a trace back: rejects anything that isn't strict JSON
+struct Json {
+    enum class Type { Null, Bool, Number, String, Array, Object } type = Type::Null;
+    double number = 0.0;
+    std::string text;
+    std::vector<Json> items;
+    std::map<std::string, Json> fields;
+
+    bool has(const char *name, Type of) const { auto found = fields.find(name); return found != fields.end() && found->second.type == of; }
+    const Json& operator[](const char *name) const { return fields.at(name); }
+};
+
+class JsonParser {
+public:
+    explicit JsonParser(const std::string &in) : in(in) {}
+
+    // the whole input as one value, or nothing if it isn't valid JSON
+    std::unique_ptr<Json> parse() {
+        auto value = std::make_unique<Json>();
+        if (!parseValue(*value)) { return nullptr; }
+        space();
+        return at == in.size() ? std::move(value) : nullptr;
+    }
+
+private:
+    const std::string &in;
+    std::size_t at = 0;
+
+    void space() { while (at < in.size() && (in[at] == ' ' || in[at] == '\n' || in[at] == '\r' || in[at] == '\t')) { at++; } }
+    bool literal(const char *word) {
+        std::string_view w(word);
+        if (in.compare(at, w.size(), w) != 0) { return false; }
+        at += w.size();
+        return true;
+    }
+    bool parseString(std::string &out) {
+        if (at >= in.size() || in[at] != '"') { return false; }
+        for (at++; at < in.size(); at++) {
+            char c = in[at];
+            if (c == '"') { at++; return true; }
+            if (static_cast<unsigned char>(c) < 0x20) { return false; }
+            if (c == '\\') {
+                if (++at >= in.size()) { return false; }
+                switch (in[at]) {
+                    case '"': case '\\': case '/': out += in[at]; break;
+                    case 'n': out += '\n'; break;
+                    case 't': out += '\t'; break;
+                    case 'r': out += '\r'; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'u': if (at + 4 >= in.size()) { return false; } out += '?'; at += 4; break;
+                    default: return false;
+                }
+                continue;
+            }
+            out += c;
+        }
+        return false;
+    }
+    bool parseNumber(double &out) {
+        auto start = at;
+        if (at < in.size() && in[at] == '-') { at++; }
+        if (at >= in.size() || !std::isdigit(static_cast<unsigned char>(in[at]))) { return false; }
+        if (in[at] == '0' && at + 1 < in.size() && std::isdigit(static_cast<unsigned char>(in[at + 1]))) { return false; } // no leading zeros
+        while (at < in.size() && std::isdigit(static_cast<unsigned char>(in[at]))) { at++; }
+        if (at < in.size() && in[at] == '.') {
+            if (++at >= in.size() || !std::isdigit(static_cast<unsigned char>(in[at]))) { return false; }
+            while (at < in.size() && std::isdigit(static_cast<unsigned char>(in[at]))) { at++; }
+        }
+        if (at < in.size() && (in[at] == 'e' || in[at] == 'E')) {
+            at++;
+            if (at < in.size() && (in[at] == '+' || in[at] == '-')) { at++; }
+            if (at >= in.size() || !std::isdigit(static_cast<unsigned char>(in[at]))) { return false; }
+            while (at < in.size() && std::isdigit(static_cast<unsigned char>(in[at]))) { at++; }
+        }
+        out = std::strtod(in.substr(start, at - start).c_str(), nullptr);
+        return true;
+    }
+    bool parseValue(Json &out) {
+        space();
+        if (at >= in.size()) { return false; }
+        switch (in[at]) {
+            case '{': {
+                out.type = Json::Type::Object;
+                at++;
+                space();
+                if (at < in.size() && in[at] == '}') { at++; return true; }
+                while (true) {
+                    space();
+                    std::string name;
+                    if (!parseString(name)) { return false; }
+                    space();
+                    if (at >= in.size() || in[at++] != ':') { return false; }
+                    if (out.fields.contains(name) || !parseValue(out.fields[name])) { return false; }
+                    space();
+                    if (at < in.size() && in[at] == ',') { at++; continue; }
+                    if (at < in.size() && in[at] == '}') { at++; return true; }
+                    return false;
+                }
+            }
+            case '[': {
+                out.type = Json::Type::Array;
+                at++;
+                space();
+                if (at < in.size() && in[at] == ']') { at++; return true; }
+                while (true) {
+                    out.items.emplace_back();
+                    if (!parseValue(out.items.back())) { return false; }
+                    space();
+                    if (at < in.size() && in[at] == ',') { at++; continue; }
+                    if (at < in.size() && in[at] == ']') { at++; return true; }
+                    return false;
+                }
+            }
+            case '"': out.type = Json::Type::String; return parseString(out.text);
+            case 't': out.type = Json::Type::Bool; return literal("true");
+            case 'f': out.type = Json::Type::Bool; return literal("false");
+            case 'n': return literal("null");
+            default: out.type = Json::Type::Number; return parseNumber(out.number);
+        }
+    }
+};
+
+static void Spin(std::uint64_t ns) {
+    auto until = trace::Now() + ns;
+    while (trace::Now() < until) {}
+}
+
+static check::Case json("trace.json", []() {
+    check::expect(!JsonParser("{\"a\":1,}").parse() && !JsonParser("[01]").parse() && !JsonParser("{\"a\":\"\\q\"}").parse() && JsonParser(" {\"a\":[1.5e3,true,null]} ").parse(), "the checker itself rejects bad JSON");
+    trace::Enable(true);
+    // an outer span around inner ones on this thread, and spans on two more threads, one of them named with characters to escape
+    {
+        trace::Span outer("outer \"quoted\"");
+        for (int i = 0; i < 3; i++) { trace::Span inner("inner\\path"); Spin(20000); }
+    }
+    std::thread named([]() {
+        trace::NameThread("Worker \"one\"");
+        for (int i = 0; i < 5; i++) { trace::Span span("work"); Spin(5000); }
+    });
+    named.join();
+    std::thread unnamed([]() { trace::Span span("anonymous"); });
+    unnamed.join();
+    trace::Enable(false);
+    auto text = trace::Json();
+    auto root = JsonParser(text).parse();
+    if (!check::expect(root != nullptr, "the trace is valid JSON")) { return; }
+    check::expect(root->type == Json::Type::Object && root->has("traceEvents", Json::Type::Array) && root->has("displayTimeUnit", Json::Type::String), "a trace-event object with a traceEvents array");
+    // every event has the fields its phase needs
+    std::map<std::string, int> names;
+    std::map<double, std::string> threadNames;
+    bool wellFormed = true, nonNegative = true;
+    double minTs = 1e300, outerEnd = 0.0, outerTs = 0.0, innerTs = 1e300, innerEnd = 0.0;
+    for (auto &event: (*root)["traceEvents"].items) {
+        bool common = event.type == Json::Type::Object && event.has("name", Json::Type::String) && event.has("ph", Json::Type::String) && event.has("pid", Json::Type::Number) && event.has("tid", Json::Type::Number);
+        if (!common) { wellFormed = false; continue; }
+        auto &ph = event["ph"].text;
+        if (ph == "M") {
+            wellFormed = wellFormed && event["name"].text == "thread_name" && event.has("args", Json::Type::Object) && event["args"].has("name", Json::Type::String);
+            if (wellFormed) { threadNames[event["tid"].number] = event["args"]["name"].text; }
+        } else if (ph == "X") {
+            wellFormed = wellFormed && event.has("ts", Json::Type::Number) && event.has("dur", Json::Type::Number);
+            if (!wellFormed) continue;
+            auto ts = event["ts"].number, dur = event["dur"].number;
+            nonNegative = nonNegative && ts >= 0.0 && dur >= 0.0;
+            minTs = std::min(minTs, ts);
+            names[event["name"].text]++;
+            if (event["name"].text == "outer \"quoted\"") { outerTs = ts; outerEnd = ts + dur; }
+            if (event["name"].text == "inner\\path") { innerTs = std::min(innerTs, ts); innerEnd = std::max(innerEnd, ts + dur); }
+        } else {
+            wellFormed = false;
+        }
+    }
+    check::expect(wellFormed && nonNegative, "every event is a thread name or a complete event with a start and a duration");
+    check::expect(names["outer \"quoted\""] == 1 && names["inner\\path"] == 3 && names["work"] == 5 && names["anonymous"] == 1 && trace::EventCount() == 10, "every span is in the trace once, names escaped and read back");
+    check::expect(minTs == 0.0 && outerTs <= innerTs && innerEnd <= outerEnd + 0.001, "times start at 0 and nested spans sit inside their parent");
+    bool workerNamed = false;
+    for (auto &[tid, name]: threadNames) { workerNamed = workerNamed || name == "Worker \"one\""; }
+    check::expect(workerNamed, "a named thread carries its name");
+});
+
+static check::Case capacity("trace.capacity", []() {
+    // a smaller buffer than the default: the rest is dropped and counted
+    trace::Enable(true, 100);
+    for (int i = 0; i < 150; i++) { trace::Span span("event"); }
+    check::expect(trace::EventCount() == 100 && trace::DroppedCount() == 50, "a buffer holds the events Enable asked for, and counts the rest as dropped");
+    // a new start clears the buffer, and a larger size takes effect
+    trace::Enable(true, 1000);
+    for (int i = 0; i < 150; i++) { trace::Span span("event"); }
+    check::expect(trace::EventCount() == 150 && trace::DroppedCount() == 0, "a start with another size gets a buffer of that size");
+    trace::Enable(false);
+    auto root = JsonParser(trace::Json()).parse();
+    check::expect(root && (*root)["traceEvents"].items.size() >= 150, "a stopped trace can still be written");
+});
+
+static check::Case allocation("trace.allocation", []() {
+    // a thread that only spans while tracing is off allocates nothing
+    trace::Enable(false);
+    long idle = -1;
+    std::thread quiet([&idle]() {
+        check::Allocations allocations;
+        for (int i = 0; i < 100; i++) { trace::Span span("off"); }
+        idle = allocations.count();
+    });
+    quiet.join();
+    check::expect(idle == 0, "no buffer for a thread while tracing is off");
+    // once tracing starts: its buffer at the first span, nothing after
+    trace::Enable(true, 500);
+    long first = -1, after = -1;
+    std::thread busy([&first, &after]() {
+        {
+            check::Allocations allocations;
+            { trace::Span span("first"); }
+            first = allocations.count();
+        }
+        check::Allocations allocations;
+        for (int i = 0; i < 100; i++) { trace::Span span("next"); }
+        after = allocations.count();
+    });
+    busy.join();
+    trace::Enable(false);
+    check::expect(first > 0 && after == 0, "a thread's buffer is taken at its first span while tracing, and recording allocates nothing after that");
+});
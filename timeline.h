@@ -0,0 +1,87 @@
+/* Keyframe baking for imod timelines.
+ * ----------
+ * Instead of computing the eased intensity every tick and pushing it through Trigger strength, an overlay's curve
+ * can be baked into the keyframes of its imod form once at load. The engine's own (linear) key interpolation then
+ * evaluates the curve shape, and the tick only has to drive a single time parameter.
+ *
+ * Timeline time is normalized 0 to 1: 0 is no effect (stat at Range start), 1 is full effect (stat at Range end).
+ * On the imod it is stretched over span seconds, since the engine ages a live instance by real time every frame and
+ * the tick only puts it back every UpdateInterval (or after a breaker's backoff): over an hour long timeline that is
+ * a hair of the curve, where over the form's usual 1 sec it would be a visible creep and then the instance's end.
+ * Keys are placed adaptively, so steep parts of a curve (expo, bounce, elastic) get more keys than flat ones.
+*/
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "easing.h"
+
+namespace timeline
+{
+    // hard cap on keys per track, to keep the imod forms small
+    constexpr int maxKeys = 64;
+
+    // seconds of imod time the normalized timeline is stretched over (the form's duration, while baked)
+    constexpr float span = 3600.0f;
+
+    // a baked track: key times and the eased progress (0 to 1) at each key
+    struct Track {
+        std::vector<float> times;
+        std::vector<float> values;
+        int size() const { return static_cast<int>(times.size()); }
+    };
+
+    // timeline time for a stat value: 0 above start, 1 below end, linear in between
+    inline float progress(float value, float start, float end) {
+        if (value >= start) { return 0.0f; }
+        if (value <= end) { return 1.0f; }
+        return (start - value) / (start - end);
+    }
+
+    // imod instance age for a stat value, on the span long timeline
+    inline float age(float value, float start, float end) { return progress(value, start, end) * span; }
+
+    // evaluate a baked track at time t the same way the engine interpolates linear keys
+    inline float evaluate(const Track &track, float t) {
+        if (track.times.empty()) { return 0.0f; }
+        if (t <= track.times.front()) { return track.values.front(); }
+        if (t >= track.times.back()) { return track.values.back(); }
+        auto it = std::upper_bound(track.times.begin(), track.times.end(), t);
+        auto i = static_cast<std::size_t>(it - track.times.begin());
+        float t0 = track.times[i-1], t1 = track.times[i];
+        float v0 = track.values[i-1], v1 = track.values[i];
+        return v0 + (v1 - v0) * (t - t0) / (t1 - t0);
+    }
+
+    // bake an easing curve into keyCount keys (at least 2, at most maxKeys).
+    // Starts from the two end keys, then repeatedly splits the segment whose midpoint is furthest off the curve
+    inline Track bake(easing::easingFunction easeF, int keyCount) {
+        keyCount = std::clamp(keyCount, 2, maxKeys);
+        auto curve = [easeF](float t) -> float { return static_cast<float>(easeF(t)); };
+        Track track;
+        track.times = {0.0f, 1.0f};
+        track.values = {curve(0.0f), curve(1.0f)};
+        while (track.size() < keyCount) {
+            std::size_t worst = 0; float worstError = -1.0f;
+            for (std::size_t i = 0; i + 1 < track.times.size(); i++) {
+                float mid = 0.5f * (track.times[i] + track.times[i+1]);
+                float error = std::abs(curve(mid) - 0.5f * (track.values[i] + track.values[i+1]));
+                if (error > worstError) { worstError = error; worst = i; }
+            }
+            float mid = 0.5f * (track.times[worst] + track.times[worst+1]);
+            track.times.insert(track.times.begin() + worst + 1, mid);
+            track.values.insert(track.values.begin() + worst + 1, curve(mid));
+        }
+        return track;
+    }
+
+    // largest difference between the baked track and the analytic curve, sampled at n points
+    inline float maxError(const Track &track, easing::easingFunction easeF, int n = 1024) {
+        float worst = 0.0f;
+        for (int i = 0; i <= n; i++) {
+            float t = static_cast<float>(i) / n;
+            worst = std::max(worst, std::abs(evaluate(track, t) - static_cast<float>(easeF(t))));
+        }
+        return worst;
+    }
+}
@@ -0,0 +1,194 @@
+/* Hierarchical timer wheel that schedules each overlay's updates on the overlay thread.
+ * ----------
+ * Time is in whole milliseconds. Level 0 has 64 one-millisecond slots, and every level above covers 64 times the
+ * span of the one below (64 ms, 4 s, 4.6 min slots). A timer goes into the lowest level whose span reaches its
+ * deadline, and drops a level each time the wheel reaches its slot, until it fires from level 0. Occupied slots
+ * are tracked in a bitmask per level, so finding the next deadline or jumping over idle time never walks empty
+ * slots. Timers live in a fixed array linked into their slots by index: no allocation after construction.
+ *
+ * usage:
+ * timerwheel::Wheel wheel(3);
+ * wheel.schedule(actors::Health, nowMs + 16);
+ * wheel.advance(nowMs, [&](std::size_t id) { due[id] = true; });
+ * wheel.schedule(actors::Health, timerwheel::periodic(wheel.deadline(actors::Health), 16, nowMs));
+ * sleep until wheel.nextDeadline()
+*/
+#pragma once
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace timerwheel
+{
+    constexpr int slotBits = 6;
+    constexpr int slots = 1 << slotBits;
+    constexpr int levels = 4;
+    constexpr std::uint64_t never = std::numeric_limits<std::uint64_t>::max();
+
+    // next deadline of a periodic timer that was due at previous: one interval later, so the rate doesn't drift with
+    // wakeup latency, or one interval from now if it fell more than an interval behind (e.g. after the thread was parked)
+    inline std::uint64_t periodic(std::uint64_t previous, std::uint64_t interval, std::uint64_t now) {
+        auto next = previous + interval;
+        return next > now ? next : now + interval;
+    }
+
+    // how well the owner of a wheel keeps to its deadlines
+    struct Stats {
+        std::uint64_t wakeups = 0;  // times the owner woke up with at least one timer due
+        std::uint64_t fired = 0;    // timers that came due
+        std::uint64_t lateMs = 0;   // total time between each timer's deadline and it being processed
+        std::uint64_t maxLateMs = 0;
+
+        void record(std::uint64_t deadline, std::uint64_t now) {
+            auto late = now > deadline ? now - deadline : 0;
+            fired++;
+            lateMs += late;
+            if (late > maxLateMs) { maxLateMs = late; }
+        }
+        double averageLateMs() const { return fired ? static_cast<double>(lateMs) / static_cast<double>(fired) : 0.0; }
+    };
+
+    class Wheel {
+    public:
+        explicit Wheel(std::size_t timers) : timers(timers) {
+            for (auto &level: heads) { level.fill(none); }
+        }
+
+        // current wheel time: every millisecond before it has been processed
+        std::uint64_t now() const { return current; }
+
+        bool armed(std::size_t id) const { return timers[id].armed; }
+        std::uint64_t deadline(std::size_t id) const { return timers[id].deadline; }
+
+        // (re)arm a timer. A deadline that has already passed fires on the next advance
+        void schedule(std::size_t id, std::uint64_t deadline) {
+            cancel(id);
+            timers[id].deadline = deadline < current ? current : deadline;
+            timers[id].armed = true;
+            insert(id);
+        }
+
+        void cancel(std::size_t id) {
+            if (timers[id].armed) { unlink(id); timers[id].armed = false; }
+        }
+
+        // process every millisecond up to and including to, calling fire(id) for each timer that comes due (in
+        // deadline order). A fired timer is disarmed, fire may schedule it again
+        template <class Fire>
+        void advance(std::uint64_t to, Fire &&fire) {
+            while (current <= to) {
+                auto tick = nextEvent();
+                if (tick > to) { current = to + 1; break; }
+                current = tick;
+                // bring down every higher level slot that starts on this tick, highest first
+                for (int level = levels - 1; level > 0; level--) {
+                    if (current & (span(level) - 1)) continue;
+                    auto slot = slotOf(current, level);
+                    auto id = heads[level][slot];
+                    heads[level][slot] = none;
+                    occupied[level] &= ~(std::uint64_t(1) << slot);
+                    while (id != none) {
+                        auto next = timers[id].next;
+                        insert(id);
+                        id = next;
+                    }
+                }
+                auto slot = slotOf(current, 0);
+                auto id = heads[0][slot];
+                heads[0][slot] = none;
+                occupied[0] &= ~(std::uint64_t(1) << slot);
+                current++;
+                while (id != none) {
+                    auto next = timers[id].next;
+                    timers[id].armed = false;
+                    fire(static_cast<std::size_t>(id));
+                    id = next;
+                }
+            }
+        }
+
+        // earliest deadline of any armed timer, or never
+        std::uint64_t nextDeadline() const {
+            std::uint64_t earliest = never;
+            for (int level = 0; level < levels; level++) {
+                // slots come up in deadline order within a level, so its earliest timer is in the first occupied slot.
+                // Except on the top level, where timers past its reach are parked out of order: look at all of those
+                for (auto bits = occupied[level]; bits; bits = level == levels - 1 ? bits & (bits - 1) : 0) {
+                    auto slot = level == levels - 1 ? std::countr_zero(bits) : firstOccupied(level);
+                    for (auto id = heads[level][slot]; id != none; id = timers[id].next) {
+                        if (timers[id].deadline < earliest) { earliest = timers[id].deadline; }
+                    }
+                }
+            }
+            return earliest;
+        }
+
+    private:
+        static constexpr std::int32_t none = -1;
+
+        struct Timer {
+            std::uint64_t deadline = 0;
+            std::int32_t next = none, prev = none;
+            std::int8_t level = 0, slot = 0;
+            bool armed = false;
+        };
+
+        static constexpr std::uint64_t span(int level) { return std::uint64_t(1) << (slotBits * level); }
+        static int slotOf(std::uint64_t time, int level) { return static_cast<int>((time >> (slotBits * level)) & (slots - 1)); }
+
+        // first occupied slot of a level, counting from the slot the wheel is on
+        int firstOccupied(int level) const {
+            auto start = slotOf(current, level);
+            auto rotated = std::rotr(occupied[level], start);
+            return (start + std::countr_zero(rotated)) & (slots - 1);
+        }
+
+        // next millisecond at which anything fires or drops a level
+        std::uint64_t nextEvent() const {
+            std::uint64_t earliest = never;
+            for (int level = 0; level < levels; level++) {
+                if (!occupied[level]) continue;
+                auto size = span(level);
+                auto base = (current + size - 1) & ~(size - 1); // first slot boundary at or after now
+                auto distance = static_cast<std::uint64_t>((firstOccupied(level) - slotOf(base, level)) & (slots - 1));
+                auto tick = base + distance * size;
+                if (tick < earliest) { earliest = tick; }
+            }
+            return earliest;
+        }
+
+        void insert(std::int32_t id) {
+            auto &timer = timers[id];
+            // lowest level where the deadline's slot comes up within one turn of the wheel (counted in whole slots, so
+            // it is never the slot the wheel is already in)
+            auto slotsAway = [&](int level) { return (timer.deadline >> (slotBits * level)) - (current >> (slotBits * level)); };
+            int level = 0;
+            while (level < levels - 1 && slotsAway(level) >= slots) { level++; }
+            // past the top level's reach: park in its furthest slot and re-sort when that comes up
+            auto slot = slotsAway(level) >= slots ? slotOf(current, level) + slots - 1 : slotOf(timer.deadline, level);
+            timer.level = static_cast<std::int8_t>(level);
+            timer.slot = static_cast<std::int8_t>(slot & (slots - 1));
+            timer.prev = none;
+            timer.next = heads[level][timer.slot];
+            if (timer.next != none) { timers[timer.next].prev = id; }
+            heads[level][timer.slot] = id;
+            occupied[level] |= std::uint64_t(1) << timer.slot;
+        }
+
+        void unlink(std::size_t id) {
+            auto &timer = timers[id];
+            if (timer.prev != none) { timers[timer.prev].next = timer.next; }
+            else { heads[timer.level][timer.slot] = timer.next; }
+            if (timer.next != none) { timers[timer.next].prev = timer.prev; }
+            if (heads[timer.level][timer.slot] == none) { occupied[timer.level] &= ~(std::uint64_t(1) << timer.slot); }
+        }
+
+        std::vector<Timer> timers;
+        std::array<std::array<std::int32_t, slots>, levels> heads;
+        std::array<std::uint64_t, levels> occupied = {};
+        std::uint64_t current = 0;
+    };
+}
@@ -0,0 +1,70 @@
+// StatFX actor sampling benchmark: a tick's batched sampling and aggregation of the player, the combat target and a
+// follower set of 1, 10 and 100 actors, then every aggregate read back the way the overlays read it (the aggregates'
+// correctness is in actors_test.cpp).
+// usage: StatFXActorsBench
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <spdlog/spdlog.h>
+#include "../overlay.h"
+
+// stand-in actor values: stats that drift a little every sample, like actors in a fight
+class DriftingValues : public game::ActorValues {
+public:
+    explicit DriftingValues(std::size_t followers) : stats(3 * (followers + 2)), followers(followers) {
+        for (auto &stat: stats) { stat = unit(random); }
+    }
+    void sample(actors::Target target, actors::SampleBatch &batch) override {
+        std::size_t first = 0, count = 1;
+        if (target == actors::Target::CombatTarget) { first = 1; }
+        if (target == actors::Target::Followers) { first = 2; count = followers; }
+        for (std::size_t i = first; i < first + count; i++) {
+            auto stat = &stats[3 * i];
+            for (int s = 0; s < actors::StatCount; s++) { stat[s] = stat[s] < 0.99f ? stat[s] + 0.001f : 0.0f; }
+            batch.push(stat[actors::Health], stat[actors::Stamina], stat[actors::Magicka]);
+        }
+    }
+
+private:
+    std::mt19937 random{28};
+    std::uniform_real_distribution<float> unit{0.0f, 1.0f};
+    std::vector<float> stats;
+    std::size_t followers;
+};
+
+void Benchmark() {
+    const long ticks = 200000;
+    std::printf("%-10s %14s %14s %14s\n", "followers", "player ns", "+target ns", "+followers ns");
+    for (std::size_t followers: {1, 10, 100}) {
+        DriftingValues values(followers);
+        overlay::ActorSets sets;
+        Settings::OverlayData stat;
+        volatile float sink = 0.0f;
+        auto perTick = [&](bool wantCombatTarget, bool wantFollowers) {
+            auto start = std::chrono::steady_clock::now();
+            for (long tick = 0; tick < ticks; tick++) {
+                sets.sample(values, true, wantCombatTarget, wantFollowers);
+                // every overlay's read: each target and aggregate of its stat
+                for (auto target: {actors::Target::Player, actors::Target::CombatTarget, actors::Target::Followers}) {
+                    stat.target = target;
+                    for (auto aggregate: {actors::Aggregate::Min, actors::Aggregate::Max, actors::Aggregate::Average, actors::Aggregate::LowestHealth}) {
+                        stat.aggregate = aggregate;
+                        sink = sink + sets.value(stat, actors::Health);
+                    }
+                }
+            }
+            return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ticks;
+        };
+        auto player = perTick(false, false);
+        auto target = perTick(true, false);
+        auto all = perTick(true, true);
+        std::printf("%-10zu %14.1f %14.1f %14.1f\n", followers, player, target, all);
+    }
+}
+
+int main() {
+    spdlog::set_level(spdlog::level::off);
+    Benchmark();
+    return 0;
+}
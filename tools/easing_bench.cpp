@@ -0,0 +1,36 @@
+// StatFX easing benchmark: times the float32 curves in easingf.h against their double precision references per call,
+// next to each one's max absolute error over [0, 1] and the error it states (the tests hold it to that, easing_test.cpp).
+// usage: StatFXEasingBench [samples]
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "../easingf.h"
+
+// average ns per call of a curve over every input, summing the results so the calls can't be optimized away
+double NsPerCall(easing::easingFunction function, const std::vector<double> &inputs, double &sink) {
+    auto start = std::chrono::steady_clock::now();
+    double sum = 0.0;
+    for (auto t: inputs) { sum += function(t); }
+    auto secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    sink += sum;
+    return secs * 1e9 / inputs.size();
+}
+
+int main(int argc, char **argv) {
+    int samples = argc > 1 ? std::max(2, std::atoi(argv[1])) : 1 << 20;
+    std::vector<double> inputs(samples);
+    for (int i = 0; i < samples; i++) { inputs[i] = static_cast<double>(i) / (samples - 1); }
+    double sink = 0.0;
+    std::printf("%-18s %12s %12s %12s %12s\n", "curve", "max error", "stated", "ref ns/call", "f32 ns/call");
+    for (auto &curve: easingf::curves) {
+        double worst = 0.0;
+        for (auto t: inputs) { worst = std::max(worst, std::abs(curve.approx(t) - curve.reference(t))); }
+        double refNs = NsPerCall(curve.reference, inputs, sink);
+        double approxNs = NsPerCall(curve.approx, inputs, sink);
+        std::printf("%-18s %12.3g %12.3g %12.2f %12.2f\n", easing::getStringEasingFunction(curve.reference), worst, curve.maxError, refNs, approxNs);
+    }
+    std::printf("(checksum %g)\n", sink);
+    return 0;
+}
@@ -0,0 +1,39 @@
+// StatFX expression benchmark: Intensity programs against the native code they replace (the default program against
+// overlay::EasedValue, which overlay::Tick calls in its place, and a written-out formula against the same formula in
+// C++). The programs' correctness is in expr_test.cpp.
+// usage: StatFXExprBench
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <spdlog/spdlog.h>
+#include "../overlay.h"
+
+template <class Run>
+double NsPerCall(Run run) {
+    constexpr int calls = 2000000;
+    float sink = 0.0f;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < calls; i++) { sink += run(static_cast<float>(i % 1000) / 1000.0f); }
+    auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / calls;
+    return sink == -1.0f ? 0.0 : ns;
+}
+
+void Benchmark() {
+    expr::Context context{0.6f, 0.1f, easing::easeInQuad};
+    auto byDefault = expr::defaultProgram(context);
+    auto example = *expr::compile("ease(quad, 1 - health) * max(0, 1 - stamina*2)", context);
+    expr::Vars vars = {};
+    std::printf("%-50s %10s %10s\n", "intensity", "program", "native");
+    auto defaultNs = NsPerCall([&](float x) { vars[expr::Stat] = x; return byDefault.run(vars); });
+    auto easedNs = NsPerCall([&](float x) { return overlay::EasedValue(x, context.start, context.end, context.curve); });
+    std::printf("%-50s %9.2fns %9.2fns\n", byDefault.source.c_str(), defaultNs, easedNs);
+    auto exampleNs = NsPerCall([&](float x) { vars[expr::Health] = x; vars[expr::Stamina] = 1.0f - x; return example.run(vars); });
+    auto handNs = NsPerCall([&](float x) { return static_cast<float>(easing::easeInQuad(1.0f - x)) * std::max(0.0f, 1.0f - (1.0f - x) * 2.0f); });
+    std::printf("%-50s %9.2fns %9.2fns\n", example.source.c_str(), exampleNs, handNs);
+}
+
+int main() {
+    spdlog::set_level(spdlog::level::err);
+    Benchmark();
+    return 0;
+}
@@ -0,0 +1,150 @@
+// StatFX filter replay: runs a stat trace through an overlay's tick once per noise filter (none, ema, oneeuro,
+// hysteresis) and reports how many imod updates each one makes and how much later it reacts to big hits.
+// The trace is a CSV written by StatFXTelemetryReader, or a generated one: slow regeneration with sampling jitter
+// and a big hit every 12 seconds.
+// usage: StatFXFilterReplay [telemetry.csv] [--stat health] [--ini StatFx.ini] [--overlay health] [--tick 25]
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <spdlog/spdlog.h>
+#include "../overlay.h"
+
+// stand-in imod that counts what the tick asks of it
+class CountingImod : public game::Imod {
+public:
+    bool loaded() const override { return true; }
+    bool live() const override { return on; }
+    void trigger(float) override { on = true; updates++; }
+    void drive(float, float) override { on = true; updates++; }
+    void hold() override {}
+    void stop() override { if (on) { updates++; } on = false; }
+    void apply(const overlay::ImodParams&) override {}
+    bool on = false;
+    int updates = 0;
+};
+
+// stand-in actor values: the player's stat is whatever the trace says right now
+class TraceValues : public game::ActorValues {
+public:
+    void sample(actors::Target target, actors::SampleBatch &batch) override {
+        if (target == actors::Target::Player) { batch.push(value, value, value); }
+    }
+    float value = 1.0f;
+};
+
+// one stat column of a telemetry CSV (health, stamina or magicka)
+bool ReadTrace(const std::string &path, const std::string &stat, std::vector<float> &trace) {
+    std::ifstream file(path);
+    std::string line;
+    if (!file || !std::getline(file, line)) { return false; }
+    std::vector<std::string> header;
+    std::stringstream names(line);
+    for (std::string name; std::getline(names, name, ',');) { header.push_back(name); }
+    auto column = std::find(header.begin(), header.end(), stat) - header.begin();
+    if (column == static_cast<long>(header.size())) { return false; }
+    while (std::getline(file, line)) {
+        std::stringstream fields(line);
+        std::string field;
+        for (long i = 0; i <= column && std::getline(fields, field, ','); i++) {}
+        if (!field.empty()) { trace.push_back(std::strtof(field.c_str(), nullptr)); }
+    }
+    return !trace.empty();
+}
+
+// a minute of regeneration from 40% with +-0.3% jitter, and a 30% hit every 12 seconds
+std::vector<float> GenerateTrace(float tickSeconds) {
+    std::vector<float> trace;
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> jitter(-0.003f, 0.003f);
+    float value = 0.4f;
+    auto ticks = static_cast<int>(60.0f / tickSeconds), hitEvery = static_cast<int>(12.0f / tickSeconds);
+    for (int i = 0; i < ticks; i++) {
+        if (i > 0 && i % hitEvery == 0) { value = std::max(0.0f, value - 0.3f); }
+        value = std::min(1.0f, value + 0.02f * tickSeconds); // 2% a second
+        trace.push_back(std::clamp(value + jitter(random), 0.0f, 1.0f));
+    }
+    return trace;
+}
+
+int main(int argc, char **argv) {
+    spdlog::set_level(spdlog::level::warn);
+    std::vector<std::string> positional;
+    std::map<std::string, std::string> options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.starts_with("--") && i + 1 < argc) { options[arg.substr(2)] = argv[++i]; }
+        else { positional.push_back(arg); }
+    }
+    auto option = [&options](const std::string &name, const std::string &fallback) { return options.contains(name) ? options[name] : fallback; };
+    // overlay settings: the defaults, or an overlay from a config read the same way the plugin does
+    Settings settings;
+    Profiles profiles;
+    Settings::OverlayData stat;
+    if (options.contains("ini")) {
+        mINI::INIFile iniFile(options["ini"]);
+        mINI::INIStructure iniStruct;
+        if (!iniFile.read(iniStruct)) { std::fprintf(stderr, "Could not read '%s'\n", options["ini"].c_str()); return 1; }
+        ReadSettings(iniStruct, settings, profiles);
+        auto name = option("overlay", "health");
+        stat = name == "stamina" ? settings.stamina : name == "magicka" ? settings.magicka : settings.health;
+    }
+    float tickSeconds = static_cast<float>(std::max(1, std::atoi(option("tick", std::to_string(stat.updateInterval)).c_str()))) / 1000.0f;
+    std::vector<float> trace;
+    if (!positional.empty()) {
+        if (!ReadTrace(positional[0], option("stat", "health"), trace)) {
+            std::fprintf(stderr, "Could not read a '%s' column from '%s'\n", option("stat", "health").c_str(), positional[0].c_str());
+            return 1;
+        }
+    } else {
+        trace = GenerateTrace(tickSeconds);
+    }
+    // hits: drops of at least the spike threshold from one sample to the next
+    float spike = stat.filter.spike > 0.0f ? stat.filter.spike : 0.1f;
+    std::vector<std::size_t> hits;
+    for (std::size_t i = 1; i < trace.size(); i++) { if (trace[i - 1] - trace[i] >= spike) { hits.push_back(i); } }
+    std::printf("%zu samples every %.0f ms, %zu hits of at least %.2f\n", trace.size(), tickSeconds * 1000.0f, hits.size(), spike);
+    std::printf("%-12s %8s %10s %16s\n", "filter", "updates", "vs none", "hit response ms");
+    double baseUpdates = 0.0, baseResponse = 0.0;
+    for (auto kind: {filter::Kind::None, filter::Kind::Ema, filter::Kind::OneEuro, filter::Kind::Hysteresis}) {
+        auto filtered = stat;
+        filtered.filter.kind = kind;
+        TraceValues values;
+        overlay::ActorSets sets;
+        CountingImod imod;
+        oscillator::Oscillator osc;
+        filter::Filter noise;
+        predict::Predictor lead;
+        expr::Vars shared = {};
+        lifecycle::Phase phase = lifecycle::Phase::Inactive;
+        float current = trace.front(), actual = current, emitted = 0.0f;
+        std::vector<float> currents;
+        currents.reserve(trace.size());
+        for (auto sample: trace) {
+            values.value = sample;
+            sets.sample(values, true, false, false);
+            expr::setShared(shared, sample, sample, sample, 0);
+            overlay::Tick(&current, &actual, actors::Health, filtered, sets, shared, imod, &osc, &noise, &lead, &phase, &emitted, tickSeconds);
+            currents.push_back(current);
+        }
+        // time until the smoothed stat has moved halfway down each hit
+        double response = 0.0;
+        for (auto hit: hits) {
+            float halfway = trace[hit - 1] - (trace[hit - 1] - trace[hit]) * 0.5f;
+            auto reached = hit;
+            while (reached < currents.size() && currents[reached] > halfway) { reached++; }
+            response += static_cast<double>(reached - hit) * tickSeconds * 1000.0;
+        }
+        response = hits.empty() ? 0.0 : response / hits.size();
+        if (kind == filter::Kind::None) { baseUpdates = imod.updates; baseResponse = response; }
+        std::printf("%-12s %8d %9.0f%% %10.0f (%+.0f)\n", filter::getStringKind(kind), imod.updates,
+            baseUpdates > 0.0 ? 100.0 * imod.updates / baseUpdates : 0.0, response, response - baseResponse);
+    }
+    return 0;
+}
@@ -0,0 +1,61 @@
+// StatFX layers benchmark: loading the config plus 0, 9 and 49 presets, both typical (a handful of keys) and whole
+// copies of the config, parsed on one thread and on the pool (discovery and merge order are in layers_test.cpp).
+// usage: StatFXLayersBench [StatFx.ini] [iterations]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <spdlog/spdlog.h>
+#include "../layers.h"
+#include "../settings.h"
+
+void WriteFile(const std::filesystem::path &path, const std::string &text) {
+    std::ofstream file(path, std::ios::binary);
+    file << text;
+}
+
+template <class Load>
+double MsPerLoad(int iterations, Load load) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) { load(); }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+void Benchmark(const std::filesystem::path &folder, const std::string &config, int iterations) {
+    // a typical preset: a few keys of each overlay
+    const std::string preset = "[Health]\nTint = 0.3,0,0,0.6\nRange = 0.6,0.1\nCurve = quad\n[Magicka]\nSaturationMult = 0.4\n[Stamina]\nFadeTime = 0.5\nPredict = 1\n";
+    std::printf("%u threads, %zu byte config, %d iterations\n", std::max(1u, std::thread::hardware_concurrency()), config.size(), iterations);
+    std::printf("%-8s %-6s %12s %12s %10s %12s\n", "presets", "files", "serial ms", "pool ms", "merge ms", "settings ms");
+    for (auto [kind, text]: {std::pair{"typical", &preset}, std::pair{"copies", &config}}) {
+        for (int count: {1, 10, 50}) {
+            std::filesystem::remove_all(folder);
+            std::filesystem::create_directories(folder);
+            WriteFile(folder / "StatFx.ini", config);
+            for (int i = 1; i < count; i++) { WriteFile(folder / ("StatFx_Preset" + std::to_string(i) + ".ini"), *text); }
+            auto files = layers::Discover(folder / "StatFx.ini");
+            auto serial = MsPerLoad(iterations, [&]() { layers::Read(files, 1); });
+            auto pool = MsPerLoad(iterations, [&]() { layers::Read(files); });
+            auto read = layers::Read(files);
+            auto merge = MsPerLoad(iterations, [&]() { layers::Merge(read); });
+            auto merged = layers::Merge(read);
+            auto load = MsPerLoad(iterations, [&]() { Settings settings; Profiles profiles; ReadSettings(merged.ini, settings, profiles); });
+            std::printf("%-8s %-6d %12.3f %12.3f %10.3f %12.3f\n", kind, static_cast<int>(files.size()), serial, pool, merge, load);
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    spdlog::set_level(spdlog::level::err);
+    auto folder = std::filesystem::temp_directory_path() / "statfx_layers_bench";
+    std::string path = argc > 1 ? argv[1] : STATFX_SOURCE_DIR "/StatFx.ini";
+    std::ifstream file(path, std::ios::binary);
+    std::string config((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (config.empty()) { std::fprintf(stderr, "Could not read '%s'\n", path.c_str()); return 1; }
+    Benchmark(folder / "bench", config, argc > 2 ? std::max(1, std::atoi(argv[2])) : 20);
+    std::filesystem::remove_all(folder);
+    return 0;
+}
@@ -0,0 +1,78 @@
+// StatFX logging benchmark: a config load (ReadSettings on the shipped StatFx.ini, every line it logs at trace level)
+// and a burst of log lines, with the plugin's asynchronous logger (SetupLog in logger.h: bounded queue, a background
+// thread writes the file) against a synchronous file logger. Reports the time the logging thread spends, which is
+// what the load path and the overlay thread wait on (rate limiting is in ratelimit_test.cpp).
+// usage: StatFXLoggingBench [StatFx.ini] [iterations]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <spdlog/async.h>
+#include <spdlog/sinks/basic_file_sink.h>
+#include <spdlog/spdlog.h>
+#include "../ini.h"
+#include "../settings.h"
+
+template <class Run>
+double MsPer(int iterations, Run run) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) { run(); }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+// the file logger the plugin would log through, asynchronous the way SetupLog builds it or synchronous
+std::shared_ptr<spdlog::logger> MakeLogger(const std::filesystem::path &path, bool async) {
+    auto sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(path.string(), true);
+    if (!async) { return std::make_shared<spdlog::logger>("sync", std::move(sink)); }
+    return std::make_shared<spdlog::async_logger>("async", std::move(sink), spdlog::thread_pool(), spdlog::async_overflow_policy::overrun_oldest);
+}
+
+void Benchmark(const mINI::INIStructure &ini, const std::filesystem::path &folder, int iterations) {
+    spdlog::init_thread_pool(8192, 1);
+    constexpr int burst = 20000;
+    std::printf("%d loads, then a burst of %d lines\n", iterations, burst);
+    std::printf("%-6s %12s %14s %12s %14s\n", "logger", "load ms", "burst us/line", "on disk ms", "lines written");
+    for (bool async: {false, true}) {
+        auto logger = MakeLogger(folder / (async ? "async.log" : "sync.log"), async);
+        logger->set_level(spdlog::level::trace);
+        spdlog::set_default_logger(logger);
+        Settings settings;
+        Profiles profiles;
+        ReadSettings(ini, settings, profiles); // warm up
+        logger->flush();
+        auto load = MsPer(iterations, [&]() { Settings s; Profiles p; ReadSettings(ini, s, p); });
+        // a burst like a misbehaving overlay logging every tick without a limiter
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < burst; i++) { spdlog::warn("Main thread: Health overlay fault ({}): Backing off for {} ticks ({}/{} faults)", "actor value read returned a non-finite value", 10, i % 10, 10); }
+        auto burstUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / burst;
+        // until everything is on disk: the async logger's flush is queued behind the lines, so wait for the queue to drain
+        auto flushed = MsPer(1, [&]() {
+            logger->flush();
+            while (async && spdlog::thread_pool()->queue_size() > 0) { std::this_thread::yield(); }
+        });
+        spdlog::set_default_logger(std::make_shared<spdlog::logger>("off"));
+        // a full queue drops the oldest lines instead of blocking, so the async log can come up short
+        std::ifstream log(folder / (async ? "async.log" : "sync.log"), std::ios::binary);
+        std::size_t lines = 0;
+        for (std::string line; std::getline(log, line);) { lines++; }
+        std::printf("%-6s %12.3f %14.3f %12.3f %14zu\n", async ? "async" : "sync", load, burstUs, flushed, lines);
+    }
+    spdlog::shutdown();
+}
+
+int main(int argc, char **argv) {
+    std::string path = argc > 1 ? argv[1] : STATFX_SOURCE_DIR "/StatFx.ini";
+    mINI::INIFile file(path);
+    mINI::INIStructure ini;
+    if (!file.read(ini)) { std::fprintf(stderr, "Could not read '%s'\n", path.c_str()); return 1; }
+    auto folder = std::filesystem::temp_directory_path() / "statfx_logging_bench";
+    std::filesystem::remove_all(folder);
+    std::filesystem::create_directories(folder);
+    Benchmark(ini, folder, argc > 2 ? std::max(1, std::atoi(argv[2])) : 50);
+    std::filesystem::remove_all(folder);
+    return 0;
+}
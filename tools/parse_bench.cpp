@@ -0,0 +1,77 @@
+// StatFX parse benchmark: parse.h's from_chars parsers against the std::stof / std::stoi code they replaced, on
+// good and bad numbers, pairs and hex colors (the parsers' behavior is in parse_test.cpp).
+// usage: StatFXParseBench [iterations]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../parse.h"
+
+template <class Op>
+double NsPerValue(int iterations, const std::vector<std::string> &values, Op op) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) { for (auto &value: values) { op(value); } }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (static_cast<double>(iterations) * values.size());
+}
+
+std::size_t Bytes(const std::vector<std::string> &values) {
+    std::size_t bytes = 0;
+    for (auto &value: values) { bytes += value.size(); }
+    return bytes;
+}
+
+// the replaced code: std::stof, with a try for the values it throws on
+float OldNumber(const std::string &value) {
+    try { return std::stof(value); } catch (const std::exception&) { return 0.0f; }
+}
+
+// "a, b" by splitting on the comma and std::stof on each half
+float OldPair(const std::string &value) {
+    auto comma = value.find(',');
+    if (comma == std::string::npos) { return 0.0f; }
+    auto trim = [](std::string part) { return part.substr(part.find_first_not_of(" ()"), part.find_last_not_of(" ()") - part.find_first_not_of(" ()") + 1); };
+    return OldNumber(trim(value.substr(0, comma))) + OldNumber(trim(value.substr(comma + 1)));
+}
+
+// "#rrggbbaa" by std::stoi on each two digit substring
+float OldColor(const std::string &value) {
+    float sum = 0.0f;
+    try {
+        for (std::size_t i = 1; i + 1 < value.size(); i += 2) { sum += static_cast<float>(std::stoi(value.substr(i, 2), nullptr, 16)) / 255.0f; }
+    } catch (const std::exception&) {}
+    return sum;
+}
+
+void Benchmark(int iterations) {
+    std::mt19937 random(32);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<std::string> numbers, bad, pairs, colors;
+    char hex[10];
+    for (int i = 0; i < 1000; i++) {
+        numbers.push_back(std::to_string(unit(random)));
+        bad.push_back(i % 2 ? "none" : "fast");
+        pairs.push_back("(" + std::to_string(unit(random)) + ", " + std::to_string(unit(random)) + ")");
+        std::snprintf(hex, sizeof(hex), "#%08x", static_cast<unsigned>(random()));
+        colors.push_back(hex);
+    }
+    volatile float sink = 0.0f;
+    std::printf("%-8s %12s %12s %12s %12s\n", "values", "parse ns", "parse MB/s", "stof ns", "stof MB/s");
+    auto row = [&](const char *name, const std::vector<std::string> &values, auto newOp, auto oldOp) {
+        auto parsed = NsPerValue(iterations, values, newOp);
+        auto old = NsPerValue(iterations, values, oldOp);
+        double bytes = static_cast<double>(Bytes(values)) / values.size();
+        std::printf("%-8s %12.1f %12.1f %12.1f %12.1f\n", name, parsed, bytes / parsed * 1000.0, old, bytes / old * 1000.0);
+    };
+    row("numbers", numbers, [&](const std::string &v) { sink = sink + parse::number(v).value_or(0.0f); }, [&](const std::string &v) { sink = sink + OldNumber(v); });
+    row("bad", bad, [&](const std::string &v) { sink = sink + parse::number(v).value_or(0.0f); }, [&](const std::string &v) { sink = sink + OldNumber(v); });
+    row("pairs", pairs, [&](const std::string &v) { auto p = parse::pair(v); sink = sink + (p ? p->first + p->second : 0.0f); }, [&](const std::string &v) { sink = sink + OldPair(v); });
+    row("colors", colors, [&](const std::string &v) { auto c = parse::color(v); sink = sink + (c ? c->r + c->a : 0.0f); }, [&](const std::string &v) { sink = sink + OldColor(v); });
+}
+
+int main(int argc, char **argv) {
+    Benchmark(argc > 1 ? std::max(1, std::atoi(argv[1])) : 200);
+    return 0;
+}
@@ -0,0 +1,206 @@
+// StatFX predict replay: runs ground truth stat traces (the stat as the game has it, every millisecond) through an
+// overlay's tick, sampled once per update, with prediction off and on, and reports how far the effect's smoothed stat
+// trails the truth: mean error, the lag (the time shift of the truth that best matches it) and the worst overshoot
+// (how far it strays outside what the stat has been over the last second).
+// The traces are generated (a sprint's stamina drain, a channelled spell's magicka, health taking hits between regen,
+// all moving in 60 fps frame steps), or a column of a CSV written by StatFXTelemetryReader, interpolated between rows.
+// usage: StatFXPredictReplay [telemetry.csv --stat stamina --rows 25] [--ini StatFx.ini] [--overlay stamina] [--tick 25]
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <spdlog/spdlog.h>
+#include "../overlay.h"
+
+// stand-in imod: the replay only looks at the smoothed stat
+class NullImod : public game::Imod {
+public:
+    bool loaded() const override { return true; }
+    bool live() const override { return on; }
+    void trigger(float) override { on = true; }
+    void drive(float, float) override { on = true; }
+    void hold() override {}
+    void stop() override { on = false; }
+    void apply(const overlay::ImodParams&) override {}
+    bool on = false;
+};
+
+// stand-in actor values: the player's stat is whatever the truth is right now
+class TraceValues : public game::ActorValues {
+public:
+    void sample(actors::Target target, actors::SampleBatch &batch) override {
+        if (target == actors::Target::Player) { batch.push(value, value, value); }
+    }
+    float value = 1.0f;
+};
+
+struct Scenario {
+    std::string name;
+    std::vector<float> truth; // stat every ms
+};
+
+// piecewise rates (stat per second) held for a duration, applied in 60 fps frame steps like the game does
+Scenario Generate(const std::string &name, float start, const std::vector<std::pair<float, float>> &phases, int repeat) {
+    Scenario scenario{name, {}};
+    constexpr int frameMs = 16;
+    float value = start, stepped = start;
+    for (int r = 0; r < repeat; r++) {
+        for (auto [seconds, rate]: phases) {
+            auto ms = static_cast<int>(seconds * 1000.0f);
+            for (int i = 0; i < ms; i++) {
+                value = std::clamp(value + rate / 1000.0f, 0.0f, 1.0f);
+                if (scenario.truth.size() % frameMs == 0) { stepped = value; }
+                scenario.truth.push_back(stepped);
+            }
+        }
+    }
+    return scenario;
+}
+
+std::vector<Scenario> GenerateScenarios() {
+    return {
+        // sprint until nearly out of stamina, stop, regen, sprint again before it's full
+        Generate("sprint", 1.0f, {{1.0f, 0.0f}, {3.5f, -0.25f}, {0.8f, 0.0f}, {4.0f, 0.12f}}, 6),
+        // channel a spell for two seconds, then regen with pauses between casts
+        Generate("channel", 1.0f, {{2.0f, -0.15f}, {0.5f, 0.0f}, {3.0f, 0.08f}, {1.0f, 0.0f}}, 8),
+        // a hit (a 25% drop over one frame), then slow regen
+        Generate("hits", 0.9f, {{0.016f, -15.0f}, {6.0f, 0.03f}, {2.0f, 0.0f}}, 6),
+    };
+}
+
+// one column of a telemetry CSV, interpolated from rows rowMs apart to every ms
+bool ReadTrace(const std::string &path, const std::string &stat, int rowMs, Scenario &scenario) {
+    std::ifstream file(path);
+    std::string line;
+    if (!file || !std::getline(file, line)) { return false; }
+    std::vector<std::string> header;
+    std::stringstream names(line);
+    for (std::string name; std::getline(names, name, ',');) { header.push_back(name); }
+    auto column = std::find(header.begin(), header.end(), stat) - header.begin();
+    if (column == static_cast<long>(header.size())) { return false; }
+    std::vector<float> rows;
+    while (std::getline(file, line)) {
+        std::stringstream fields(line);
+        std::string field;
+        for (long i = 0; i <= column && std::getline(fields, field, ','); i++) {}
+        if (!field.empty()) { rows.push_back(std::strtof(field.c_str(), nullptr)); }
+    }
+    if (rows.size() < 2) { return false; }
+    scenario.name = stat;
+    for (std::size_t i = 0; i + 1 < rows.size(); i++) {
+        for (int ms = 0; ms < rowMs; ms++) { scenario.truth.push_back(rows[i] + (rows[i + 1] - rows[i]) * ms / rowMs); }
+    }
+    return true;
+}
+
+struct Result {
+    double meanError = 0.0; // fraction of the stat
+    int lagMs = 0;
+    double overshoot = 0.0; // fraction of the stat
+};
+
+// the overlay's smoothed stat every ms, updated once per tick and held in between
+std::vector<float> Replay(const Scenario &scenario, const Settings::OverlayData &stat, int tickMs) {
+    TraceValues values;
+    overlay::ActorSets sets;
+    NullImod imod;
+    oscillator::Oscillator osc;
+    filter::Filter noise;
+    predict::Predictor lead;
+    expr::Vars shared = {};
+    lifecycle::Phase phase = lifecycle::Phase::Inactive;
+    float current = scenario.truth.front(), actual = current, emitted = 0.0f;
+    std::vector<float> smoothed(scenario.truth.size());
+    for (std::size_t ms = 0; ms < scenario.truth.size(); ms++) {
+        if (ms % tickMs == 0) {
+            values.value = scenario.truth[ms];
+            sets.sample(values, true, false, false);
+            expr::setShared(shared, values.value, values.value, values.value, 0);
+            overlay::Tick(&current, &actual, actors::Health, stat, sets, shared, imod, &osc, &noise, &lead, &phase, &emitted, tickMs / 1000.0f);
+        }
+        smoothed[ms] = current;
+    }
+    return smoothed;
+}
+
+Result Measure(const std::vector<float> &truth, const std::vector<float> &smoothed) {
+    Result result;
+    auto n = truth.size();
+    for (std::size_t t = 0; t < n; t++) { result.meanError += std::abs(smoothed[t] - truth[t]); }
+    result.meanError /= n;
+    // the shift of the truth that the smoothed stat follows most closely
+    double best = result.meanError;
+    for (int shift = 1; shift <= 1000 && static_cast<std::size_t>(shift) < n / 2; shift++) {
+        double error = 0.0;
+        for (std::size_t t = shift; t < n; t++) { error += std::abs(smoothed[t] - truth[t - shift]); }
+        error /= n - shift;
+        if (error < best) { best = error; result.lagMs = shift; }
+    }
+    // outside the range the truth has covered over the last second: a prediction that ran past a reversal
+    std::deque<std::size_t> low, high; // monotonic queues over the window
+    constexpr std::size_t windowMs = 1000;
+    for (std::size_t t = 0; t < n; t++) {
+        while (!low.empty() && truth[low.back()] >= truth[t]) { low.pop_back(); }
+        while (!high.empty() && truth[high.back()] <= truth[t]) { high.pop_back(); }
+        low.push_back(t);
+        high.push_back(t);
+        if (low.front() + windowMs < t) { low.pop_front(); }
+        if (high.front() + windowMs < t) { high.pop_front(); }
+        double outside = std::max({0.0, static_cast<double>(truth[low.front()] - smoothed[t]), static_cast<double>(smoothed[t] - truth[high.front()])});
+        result.overshoot = std::max(result.overshoot, outside);
+    }
+    return result;
+}
+
+int main(int argc, char **argv) {
+    spdlog::set_level(spdlog::level::warn);
+    std::vector<std::string> positional;
+    std::map<std::string, std::string> options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.starts_with("--") && i + 1 < argc) { options[arg.substr(2)] = argv[++i]; }
+        else { positional.push_back(arg); }
+    }
+    auto option = [&options](const std::string &name, const std::string &fallback) { return options.contains(name) ? options[name] : fallback; };
+    Settings settings;
+    Profiles profiles;
+    Settings::OverlayData stat;
+    if (options.contains("ini")) {
+        mINI::INIFile iniFile(options["ini"]);
+        mINI::INIStructure iniStruct;
+        if (!iniFile.read(iniStruct)) { std::fprintf(stderr, "Could not read '%s'\n", options["ini"].c_str()); return 1; }
+        ReadSettings(iniStruct, settings, profiles);
+        auto name = option("overlay", "stamina");
+        stat = name == "health" ? settings.health : name == "magicka" ? settings.magicka : settings.stamina;
+    }
+    int tickMs = std::max(1, std::atoi(option("tick", std::to_string(stat.updateInterval)).c_str()));
+    std::vector<Scenario> scenarios;
+    if (!positional.empty()) {
+        Scenario scenario;
+        if (!ReadTrace(positional[0], option("stat", "stamina"), std::max(1, std::atoi(option("rows", "25").c_str())), scenario)) {
+            std::fprintf(stderr, "Could not read a '%s' column from '%s'\n", option("stat", "stamina").c_str(), positional[0].c_str());
+            return 1;
+        }
+        scenarios.push_back(std::move(scenario));
+    } else {
+        scenarios = GenerateScenarios();
+    }
+    std::printf("updates every %d ms, MinDelta %.3f, MaxDelta %.3f/%.3f, PredictLimit %.2f\n", tickMs, stat.minDelta, stat.maxDelta, stat.maxDeltaPos, stat.predict.limit);
+    std::printf("%-9s %-9s %12s %8s %10s\n", "trace", "predict", "mean error", "lag ms", "overshoot");
+    for (auto &scenario: scenarios) {
+        for (float lead: {0.0f, 1.0f, 2.0f}) {
+            auto predicted = stat;
+            predicted.predict.lead = lead;
+            auto result = Measure(scenario.truth, Replay(scenario, predicted, tickMs));
+            std::printf("%-9s %-9.0f %11.2f%% %8d %9.2f%%\n", scenario.name.c_str(), lead, result.meanError * 100.0, result.lagMs, result.overshoot * 100.0);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,208 @@
+// StatFX preview renderer: applies an overlay's look from StatFx.ini to an image at stat levels across its Range, as a
+// strip or contact sheet, so a preset can be judged without running the game. Images are binary PPM (P6) or PFM.
+// usage: StatFXPreview <StatFx.ini> <input.ppm|pfm> <output.ppm|pfm> [--overlay health] [--profile name]
+//                      [--steps 5] [--columns steps] [--threads 0]
+//        StatFXPreview --bench [input.ppm|pfm] [--iterations 20]   (kernel benchmark, a 4K gradient without input)
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include <spdlog/spdlog.h>
+#include "../preview.h"
+
+// read a binary PPM (8 or 16 bit) or a color PFM. Returns false if it isn't one
+bool ReadImage(const std::string &path, preview::Image &image) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) { return false; }
+    std::string magic;
+    file >> magic;
+    // header fields, skipping '#' comments between them
+    auto field = [&file]() -> std::string {
+        std::string token;
+        while (file >> token && token.starts_with("#")) { std::string rest; std::getline(file, rest); }
+        return token;
+    };
+    if (magic == "P6") {
+        int width = std::atoi(field().c_str()), height = std::atoi(field().c_str()), maxval = std::atoi(field().c_str());
+        if (width <= 0 || height <= 0 || maxval <= 0 || maxval > 65535) { return false; }
+        file.get(); // single whitespace before the raster
+        int bytes = maxval > 255 ? 2 : 1;
+        std::vector<unsigned char> raster(static_cast<std::size_t>(width) * height * 3 * bytes);
+        if (!file.read(reinterpret_cast<char*>(raster.data()), raster.size())) { return false; }
+        image.resize(width, height);
+        for (std::size_t i = 0; i < image.pixels(); i++) {
+            for (int p = 0; p < preview::PlaneCount; p++) {
+                auto at = (i * 3 + p) * bytes;
+                int value = bytes == 2 ? (raster[at] << 8 | raster[at + 1]) : raster[at];
+                image.planes[p][i] = static_cast<float>(value) / maxval;
+            }
+        }
+        return true;
+    }
+    if (magic == "PF") {
+        int width = std::atoi(field().c_str()), height = std::atoi(field().c_str());
+        float scale = std::strtof(field().c_str(), nullptr);
+        if (width <= 0 || height <= 0 || scale >= 0.0f) { return false; } // only little endian (negative scale)
+        file.get();
+        std::vector<float> raster(static_cast<std::size_t>(width) * height * 3);
+        if (!file.read(reinterpret_cast<char*>(raster.data()), raster.size() * sizeof(float))) { return false; }
+        image.resize(width, height);
+        for (int y = 0; y < height; y++) { // rows are stored bottom to top
+            for (int x = 0; x < width; x++) {
+                auto from = (static_cast<std::size_t>(height - 1 - y) * width + x) * 3;
+                for (int p = 0; p < preview::PlaneCount; p++) { image.planes[p][static_cast<std::size_t>(y) * width + x] = raster[from + p]; }
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+// write a PFM (full float range) if the path ends in .pfm, otherwise an 8 bit PPM clamped to 0-1
+bool WriteImage(const std::string &path, const preview::Image &image) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) { return false; }
+    if (path.ends_with(".pfm")) {
+        file << "PF\n" << image.width << " " << image.height << "\n-1.0\n";
+        std::vector<float> raster(image.pixels() * 3);
+        for (int y = 0; y < image.height; y++) {
+            for (int x = 0; x < image.width; x++) {
+                auto to = (static_cast<std::size_t>(image.height - 1 - y) * image.width + x) * 3;
+                for (int p = 0; p < preview::PlaneCount; p++) { raster[to + p] = image.planes[p][static_cast<std::size_t>(y) * image.width + x]; }
+            }
+        }
+        file.write(reinterpret_cast<const char*>(raster.data()), raster.size() * sizeof(float));
+    } else {
+        file << "P6\n" << image.width << " " << image.height << "\n255\n";
+        std::vector<unsigned char> raster(image.pixels() * 3);
+        for (std::size_t i = 0; i < image.pixels(); i++) {
+            for (int p = 0; p < preview::PlaneCount; p++) {
+                raster[i * 3 + p] = static_cast<unsigned char>(std::lround(std::clamp(image.planes[p][i], 0.0f, 1.0f) * 255.0f));
+            }
+        }
+        file.write(reinterpret_cast<const char*>(raster.data()), raster.size());
+    }
+    return static_cast<bool>(file);
+}
+
+// time the kernel single threaded (scalar and vector) and over every core, and check the vector path against the scalar one
+int Bench(preview::Image input, int iterations) {
+    if (input.pixels() == 0) {
+        input.resize(3840, 2160);
+        for (std::size_t i = 0; i < input.pixels(); i++) {
+            float t = static_cast<float>(i % input.width) / input.width;
+            input.planes[preview::Red][i] = t;
+            input.planes[preview::Green][i] = 1.0f - t;
+            input.planes[preview::Blue][i] = 0.5f * t;
+        }
+    }
+    Settings::OverlayData stat;
+    stat.tint = {0.8f, 0.1f, 0.1f, 0.5f};
+    stat.contrastMult = 1.3f; stat.brightnessMult = 0.8f; stat.saturationMult = 0.2f;
+    auto grade = preview::GradeFor(stat, 0.75f);
+    preview::Image scalar, vector;
+    scalar.resize(input.width, input.height);
+    vector.resize(input.width, input.height);
+    auto planes = [](const preview::Image &image) { return std::array<const float*, preview::PlaneCount>{image.planes[0].data(), image.planes[1].data(), image.planes[2].data()}; };
+    auto outPlanes = [](preview::Image &image) { return std::array<float*, preview::PlaneCount>{image.planes[0].data(), image.planes[1].data(), image.planes[2].data()}; };
+    auto time = [iterations, &input](const char *name, auto &&run) {
+        run();
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) { run(); }
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / iterations;
+        std::printf("%-28s %8.3f ms/frame %10.1f Mpix/s\n", name, secs * 1000.0, input.pixels() / secs / 1e6);
+    };
+    std::printf("%dx%d, %d iterations, vector unit: %s, %u threads\n", input.width, input.height, iterations, preview::KernelName(), std::max(1u, std::thread::hardware_concurrency()));
+    time("scalar, 1 thread", [&]() { preview::KernelScalar(grade, planes(input), outPlanes(scalar), input.pixels()); });
+    time("vector, 1 thread", [&]() { preview::Kernel(grade, planes(input), outPlanes(vector), input.pixels()); });
+    time("vector, all threads", [&]() { preview::Apply(grade, input, vector); });
+    float worst = 0.0f;
+    for (int p = 0; p < preview::PlaneCount; p++) {
+        for (std::size_t i = 0; i < input.pixels(); i++) { worst = std::max(worst, std::abs(scalar.planes[p][i] - vector.planes[p][i])); }
+    }
+    std::printf("max difference vector vs scalar: %g\n", worst);
+    return worst > 1e-6f ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+    spdlog::set_level(spdlog::level::warn);
+    std::vector<std::string> positional;
+    std::map<std::string, std::string> options;
+    bool bench = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--bench") { bench = true; }
+        else if (arg.starts_with("--") && i + 1 < argc) { options[arg.substr(2)] = argv[++i]; }
+        else { positional.push_back(arg); }
+    }
+    auto option = [&options](const std::string &name, const std::string &fallback) { return options.contains(name) ? options[name] : fallback; };
+    if (bench) {
+        preview::Image input;
+        if (!positional.empty() && !ReadImage(positional[0], input)) {
+            std::fprintf(stderr, "Could not read '%s' (binary PPM or PFM)\n", positional[0].c_str());
+            return 1;
+        }
+        return Bench(std::move(input), std::max(1, std::atoi(option("iterations", "20").c_str())));
+    }
+    if (positional.size() < 3) {
+        std::fprintf(stderr, "usage: StatFXPreview <StatFx.ini> <input.ppm|pfm> <output.ppm|pfm> [--overlay health] [--profile name] [--steps 5] [--columns steps] [--threads 0]\n"
+                             "       StatFXPreview --bench [input.ppm|pfm] [--iterations 20]\n");
+        return 1;
+    }
+    // read the config the same way the plugin does
+    mINI::INIFile iniFile(positional[0]);
+    mINI::INIStructure iniStruct;
+    if (!iniFile.read(iniStruct)) {
+        std::fprintf(stderr, "Could not read '%s'\n", positional[0].c_str());
+        return 1;
+    }
+    Settings settings;
+    Profiles profiles;
+    ReadSettings(iniStruct, settings, profiles);
+    auto lower = [](std::string str) { std::transform(str.begin(), str.end(), str.begin(), ::tolower); return str; };
+    const Profile *profile = profiles.bank.front().get();
+    if (options.contains("profile")) {
+        auto found = std::find_if(profiles.bank.begin(), profiles.bank.end(), [&](auto &p) { return p->name == lower(options["profile"]); });
+        if (found == profiles.bank.end()) { std::fprintf(stderr, "No profile named '%s'\n", options["profile"].c_str()); return 1; }
+        profile = found->get();
+    }
+    auto overlayName = lower(option("overlay", "health"));
+    const std::map<std::string, const Settings::OverlayData*> overlays = {{"health", &profile->health}, {"magicka", &profile->magicka}, {"stamina", &profile->stamina}};
+    if (!overlays.contains(overlayName)) { std::fprintf(stderr, "No overlay named '%s' (health, magicka or stamina)\n", overlayName.c_str()); return 1; }
+    auto &stat = *overlays.at(overlayName);
+    preview::Image input;
+    if (!ReadImage(positional[1], input)) {
+        std::fprintf(stderr, "Could not read '%s' (binary PPM or PFM)\n", positional[1].c_str());
+        return 1;
+    }
+    int steps = std::max(1, std::atoi(option("steps", "5").c_str()));
+    int columns = std::clamp(std::atoi(option("columns", std::to_string(steps)).c_str()), 1, steps);
+    int rows = (steps + columns - 1) / columns;
+    int threads = std::atoi(option("threads", "0").c_str());
+    // one tile per stat level, from the start of the Range (no effect) down to its end (full effect)
+    preview::Image sheet, tile;
+    sheet.resize(input.width * columns, input.height * rows);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < steps; i++) {
+        float value = steps == 1 ? stat.endFraction : stat.startFraction - (stat.startFraction - stat.endFraction) * i / (steps - 1);
+        auto grade = preview::GradeAt(stat, value);
+        preview::Apply(grade, input, tile, threads);
+        preview::Blit(tile, sheet, (i % columns) * input.width, (i / columns) * input.height);
+        std::printf("tile %d: %s %.0f%% -> saturation %.3f brightness %.3f contrast %.3f tint (%.2f, %.2f, %.2f) x %.3f\n", i + 1, overlayName.c_str(),
+            value * 100.0f, grade.saturation, grade.brightness, grade.contrast, grade.tint.red, grade.tint.green, grade.tint.blue, grade.tint.alpha);
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!WriteImage(positional[2], sheet)) {
+        std::fprintf(stderr, "Could not write '%s'\n", positional[2].c_str());
+        return 1;
+    }
+    std::printf("%dx%d %s sheet of profile '%s' written to %s in %.1f ms (%s kernel)\n", sheet.width, sheet.height, overlayName.c_str(), profile->name.c_str(), positional[2].c_str(), secs * 1000.0, preview::KernelName());
+    return 0;
+}
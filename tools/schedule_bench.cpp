@@ -0,0 +1,65 @@
+// StatFX schedule benchmark: runs overlays on the given update intervals the way the main thread does, on the real
+// clock, sleeping until each next deadline, and reports wakeups and how late they were (the wheel's correctness is in
+// timerwheel_test.cpp).
+// usage: StatFXScheduleBench [intervals ms, e.g. 16,50,200] [seconds]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../timerwheel.h"
+
+int main(int argc, char **argv) {
+    std::vector<std::uint64_t> intervals;
+    std::stringstream list(argc > 1 ? argv[1] : "16,50,200");
+    for (std::string item; std::getline(list, item, ',');) {
+        if (auto ms = std::atoi(item.c_str()); ms > 0) { intervals.push_back(static_cast<std::uint64_t>(ms)); }
+    }
+    double seconds = argc > 2 ? std::atof(argv[2]) : 2.0;
+    if (intervals.empty() || seconds <= 0.0) {
+        std::fprintf(stderr, "usage: StatFXScheduleBench [intervals ms, e.g. 16,50,200] [seconds]\n");
+        return 1;
+    }
+    timerwheel::Wheel wheel(intervals.size());
+    timerwheel::Stats stats;
+    std::vector<std::uint64_t> updates(intervals.size(), 0);
+    std::uint64_t wakes = 0;
+    auto duration = static_cast<std::uint64_t>(seconds * 1000.0);
+    auto clockStart = std::chrono::steady_clock::now();
+    auto elapsedMs = [clockStart]() { return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - clockStart).count()); };
+    for (std::size_t i = 0; i < intervals.size(); i++) { wheel.schedule(i, 0); }
+    for (auto now = elapsedMs(); now < duration; now = elapsedMs()) {
+        wakes++;
+        bool anyDue = false;
+        std::vector<std::size_t> due;
+        wheel.advance(now, [&](std::size_t which) { due.push_back(which); stats.record(wheel.deadline(which), now); });
+        for (auto which: due) {
+            anyDue = true;
+            updates[which]++;
+            wheel.schedule(which, timerwheel::periodic(wheel.deadline(which), intervals[which], now));
+        }
+        if (anyDue) { stats.wakeups++; }
+        std::this_thread::sleep_until(clockStart + std::chrono::milliseconds(wheel.nextDeadline()));
+    }
+    // a fixed-rate loop would wake every (shortest) interval; the wheel should wake at most once per distinct deadline
+    std::set<std::uint64_t> deadlines;
+    for (auto interval: intervals) {
+        for (std::uint64_t t = 0; t < duration; t += interval) { deadlines.insert(t); }
+    }
+    auto shortest = *std::min_element(intervals.begin(), intervals.end());
+    std::printf("%.1f s: %llu wakeups (%llu with work) for %llu updates, %zu distinct deadlines, %llu at a fixed %llu ms\n", seconds,
+        static_cast<unsigned long long>(wakes), static_cast<unsigned long long>(stats.wakeups), static_cast<unsigned long long>(stats.fired),
+        deadlines.size(), static_cast<unsigned long long>((duration + shortest - 1) / shortest), static_cast<unsigned long long>(shortest));
+    for (std::size_t i = 0; i < intervals.size(); i++) {
+        std::printf("  every %4llu ms: %llu updates, expected %llu\n", static_cast<unsigned long long>(intervals[i]), static_cast<unsigned long long>(updates[i]),
+            static_cast<unsigned long long>((duration + intervals[i] - 1) / intervals[i]));
+    }
+    std::printf("late: %.2f ms on average, %llu ms at most\n", stats.averageLateMs(), static_cast<unsigned long long>(stats.maxLateMs));
+    // more wakeups than deadlines means the loop woke with nothing to do
+    if (wakes > deadlines.size()) { std::printf("%llu wakeups with nothing due\n", static_cast<unsigned long long>(wakes - deadlines.size())); }
+    return 0;
+}
@@ -0,0 +1,76 @@
+// StatFX sequence benchmark: a tick of the coroutine executor in sequence.h with a few releasing overlays among many
+// idle ones, against polling every overlay's fade state each tick (the executor's correctness is in sequence_test.cpp).
+// The executor only wins when few of many overlays are fading; each sequence it resumes costs far more than a poll.
+// usage: StatFXSequenceBench [ticks]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+#include "../sequence.h"
+
+// the fade a release sequence runs, as a state machine the loop polls for every overlay
+struct PolledFade {
+    bool releasing = false;
+    std::uint64_t start = 0;
+    float strength = 0.0f;
+};
+
+sequence::Task Fade(sequence::Executor &executor, std::uint64_t releaseMs, float *strength) {
+    auto start = executor.now();
+    while (executor.now() - start < releaseMs) {
+        *strength = 1.0f - static_cast<float>(executor.now() - start) / releaseMs;
+        co_await executor.nextTick();
+    }
+    *strength = 0.0f;
+}
+
+sequence::Task Idle(sequence::Executor &executor) {
+    while (true) { co_await executor.sleep(1000000000); }
+}
+
+void Benchmark(int ticks) {
+    constexpr std::uint64_t releaseMs = 500, tickMs = 25;
+    std::printf("%-9s %-9s %16s %16s\n", "overlays", "fading", "polled ns/tick", "sequence ns/tick");
+    for (auto [overlays, fading]: {std::pair<std::size_t, std::size_t>{3, 0}, {3, 1}, {32, 1}, {32, 4}, {256, 1}, {256, 32}, {2048, 1}, {2048, 256}}) {
+        // some overlays fading out, the rest idle
+        std::vector<PolledFade> polled(overlays);
+        std::vector<float> strengths(overlays);
+        float sink = 0.0f;
+        auto start = std::chrono::steady_clock::now();
+        for (int t = 0; t < ticks; t++) {
+            std::uint64_t now = t * tickMs;
+            // the loop today: every overlay's state checked every tick
+            for (std::size_t i = 0; i < overlays; i++) {
+                auto &fade = polled[i];
+                if (!fade.releasing && i < fading && now % releaseMs == 0) { fade.releasing = true; fade.start = now; }
+                if (!fade.releasing) continue;
+                if (now - fade.start >= releaseMs) { fade.releasing = false; fade.strength = 0.0f; continue; }
+                fade.strength = 1.0f - static_cast<float>(now - fade.start) / releaseMs;
+            }
+            sink += polled[0].strength;
+        }
+        auto polledNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ticks;
+        sequence::Executor executor;
+        for (std::size_t i = fading; i < overlays; i++) { executor.spawn(static_cast<sequence::Executor::Owner>(i), Idle(executor)); }
+        start = std::chrono::steady_clock::now();
+        for (int t = 0; t < ticks; t++) {
+            std::uint64_t now = t * tickMs;
+            executor.tick(now);
+            if (now % releaseMs == 0) {
+                for (std::size_t i = 0; i < fading; i++) {
+                    if (!executor.running(static_cast<sequence::Executor::Owner>(i))) { executor.spawn(static_cast<sequence::Executor::Owner>(i), Fade(executor, releaseMs, &strengths[i])); }
+                }
+            }
+            sink += strengths[0];
+        }
+        auto sequenceNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ticks;
+        std::printf("%-9zu %-9zu %16.1f %16.1f%s\n", overlays, fading, polledNs, sequenceNs, sink < 0.0f ? " " : "");
+    }
+}
+
+int main(int argc, char **argv) {
+    int ticks = argc > 1 ? std::atoi(argv[1]) : 20000;
+    Benchmark(ticks);
+    return 0;
+}
@@ -0,0 +1,48 @@
+// StatFX sources benchmark: a push and a read of the plugin API's source table (sources.h), and a reader tick over
+// every source while producers push (binding and the concurrent producers check are in sources_test.cpp).
+// usage: StatFXSourcesBench [producers]
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../sources.h"
+
+template <class Op>
+double NsPerOp(long iterations, Op op) {
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; i++) { op(i); }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+void Benchmark(int producers) {
+    sources::Registry registry;
+    std::array<int, sources::maxSources> all;
+    for (std::size_t i = 0; i < sources::maxSources; i++) { all[i] = registry.bind("bench" + std::to_string(i)); }
+    const long iterations = 20000000;
+    volatile float sink = 0.0f;
+    auto push = NsPerOp(iterations, [&](long i) { registry.push(all[i & 31], static_cast<float>(i & 1023) / 1024.0f); });
+    auto read = NsPerOp(iterations, [&](long i) { sink = sink + registry.value(all[i & 31]); });
+    // the overlay thread's share: one read of every source per tick, while producers push flat out
+    std::atomic<bool> stop = false;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&, p]() {
+            for (long k = 0; !stop.load(std::memory_order_relaxed); k++) { registry.push(all[p % sources::maxSources], static_cast<float>(k & 1023) / 1024.0f); }
+        });
+    }
+    auto contended = NsPerOp(iterations / 32, [&](long) { for (auto source: all) { sink = sink + registry.value(source); } });
+    stop = true;
+    for (auto &thread: threads) { thread.join(); }
+    std::printf("%u threads: push %.2f ns, read %.2f ns, reading all %zu sources with %d producers pushing %.2f ns\n", std::max(1u, std::thread::hardware_concurrency()), push, read, sources::maxSources, producers, contended);
+}
+
+int main(int argc, char **argv) {
+    int producers = argc > 1 ? std::max(1, std::min(16, std::atoi(argv[1]))) : 8;
+    Benchmark(producers);
+    return 0;
+}
@@ -0,0 +1,98 @@
+// StatFX stage benchmark: the segment lookup of the stage tables in stages.h (a binary search over random values, and
+// the search hinted with the last segment over a minute of regeneration and hits) against classifying every stage
+// from its range, and the imod updates per tick for 1 to 32 stages against driving every stage every tick (the tables'
+// correctness is in stages_test.cpp).
+// usage: StatFXStageBench
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include <spdlog/spdlog.h>
+#include "../overlay.h"
+
+// stand-in imod that remembers what it was last driven to
+class StageImod : public game::Imod {
+public:
+    bool loaded() const override { return true; }
+    bool live() const override { return on; }
+    void trigger(float value) override { on = true; strength = value; updates++; }
+    void drive(float, float value) override { on = true; strength = value; updates++; }
+    void hold() override {}
+    void stop() override { on = false; strength = 0.0f; updates++; }
+    void apply(const overlay::ImodParams&) override {}
+    bool on = false;
+    float strength = 0.0f;
+    long updates = 0;
+};
+
+// a minute at 25 ms ticks: regeneration from 5% with jitter, a big hit every 12 seconds
+std::vector<float> Trace() {
+    std::vector<float> trace;
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> jitter(-0.003f, 0.003f);
+    float value = 0.05f;
+    for (int i = 0; i < 2400; i++) {
+        if (i > 0 && i % 480 == 0) { value = std::max(0.0f, value - 0.5f); }
+        value = std::min(1.0f, value + 0.0005f);
+        trace.push_back(std::clamp(value + jitter(random), 0.0f, 1.0f));
+    }
+    return trace;
+}
+
+void Benchmark() {
+    std::mt19937 random(32);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<float> values(1 << 16);
+    for (auto &value: values) { value = unit(random); }
+    auto trace = Trace();
+    std::printf("%-7s %12s %12s %12s %16s %16s\n", "stages", "find ns", "hinted ns", "scan ns", "updates/tick", "all stages/tick");
+    for (std::size_t n: {1, 2, 4, 8, 16, 32}) {
+        // evenly spread stages, each blending into the next, like a 60/30/10 ladder
+        Settings::Stages statStages;
+        std::vector<stages::Range> ranges;
+        for (std::size_t i = 0; i < n; i++) {
+            Settings::OverlayData look;
+            look.startFraction = 1.0f - static_cast<float>(i) / n * 0.9f;
+            look.endFraction = std::max(0.0f, look.startFraction - 0.9f / n * 1.5f);
+            statStages.looks.push_back(look);
+            ranges.push_back({look.startFraction, look.endFraction});
+        }
+        statStages.table.compile(ranges);
+        // segment lookup by binary search, hinted with the last tick's segment, and against classifying every stage
+        constexpr int rounds = 50;
+        std::size_t sink = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) { for (auto value: values) { sink += statStages.table.find(value); } }
+        auto findNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (rounds * values.size());
+        // as many lookups again, over the trace
+        auto traceRounds = rounds * values.size() / trace.size();
+        start = std::chrono::steady_clock::now();
+        for (std::size_t r = 0; r < traceRounds; r++) {
+            auto hint = stages::Table::none;
+            for (auto value: trace) { hint = statStages.table.find(value, hint); sink += hint; }
+        }
+        auto hintedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (traceRounds * trace.size());
+        start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            for (auto value: values) { for (auto &range: ranges) { sink += static_cast<std::size_t>(stages::classify(range, value)); } }
+        }
+        auto scanNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (rounds * values.size());
+        // imod updates over the trace
+        std::vector<StageImod> imods(n);
+        std::vector<game::Imod*> pointers;
+        for (auto &imod: imods) { pointers.push_back(&imod); }
+        stages::Cursor cursor;
+        long updates = 0;
+        for (auto value: trace) { updates += overlay::TickStages(value, statStages, &cursor, pointers); }
+        std::printf("%-7zu %12.2f %12.2f %12.2f %16.2f %16zu%s\n", n, findNs, hintedNs, scanNs, static_cast<double>(updates) / trace.size(), n, sink == 0 ? " " : "");
+    }
+}
+
+int main() {
+    spdlog::set_level(spdlog::level::warn);
+    Benchmark();
+    return 0;
+}
@@ -0,0 +1,33 @@
+// StatFX telemetry reader: prints the live feed published by the plugin (Telemetry = true in [Global]) as CSV.
+// usage: StatFXTelemetryReader [poll interval ms] [feed name]
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include "../telemetry.h"
+
+int main(int argc, char **argv) {
+    int intervalMs = argc > 1 ? std::atoi(argv[1]) : 100;
+    std::string name = argc > 2 ? argv[2] : telemetry::defaultName;
+    telemetry::Consumer feed;
+    while (!feed.open(name)) {
+        std::fprintf(stderr, "Waiting for StatFX telemetry feed '%s'...\n", name.c_str());
+        std::this_thread::sleep_for(std::chrono::seconds(2));
+    }
+    std::printf("timestamp_ns,tick,health,stamina,magicka,health_smoothed,stamina_smoothed,magicka_smoothed,health_intensity,stamina_intensity,magicka_intensity\n");
+    telemetry::Record r;
+    for (;;) {
+        while (feed.poll(r)) {
+            std::printf("%llu,%llu,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f\n",
+                static_cast<unsigned long long>(r.timestampNs), static_cast<unsigned long long>(r.tick),
+                r.actual[0], r.actual[1], r.actual[2], r.current[0], r.current[1], r.current[2],
+                r.intensity[0], r.intensity[1], r.intensity[2]);
+        }
+        if (feed.dropped) {
+            std::fprintf(stderr, "%llu records skipped (reader too slow)\n", static_cast<unsigned long long>(feed.dropped));
+            feed.dropped = 0;
+        }
+        std::fflush(stdout);
+        std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+    }
+}
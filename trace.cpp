@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "trace.h"
+
+namespace trace
+{
+    namespace
+    {
+        struct Event {
+            const char *name;
+            std::uint64_t startNs;
+            std::uint64_t durationNs;
+        };
+
+        // one thread's events. Only that thread writes; a dump reads the first count entries
+        struct Buffer {
+            std::unique_ptr<Event[]> events; // allocated on the first event after a start
+            std::size_t capacity = 0;        // of events
+            std::atomic<std::size_t> count = 0;
+            std::atomic<std::size_t> dropped = 0;
+            std::atomic<std::uint32_t> epoch = 0; // Enable(true) call the events belong to, the writer clears them on a new one
+            std::uint32_t id = 0;
+            std::string name;
+        };
+
+        // buffers are registered once per thread and live until exit (threads may end before the dump)
+        std::mutex registryLock;
+        std::vector<std::unique_ptr<Buffer>> registry;
+        std::atomic<std::uint32_t> epoch = 0;
+        std::atomic<std::size_t> requested = defaultCapacity; // buffer size of the current epoch, set before it starts
+
+        Buffer& local() {
+            thread_local Buffer *buffer = nullptr;
+            if (!buffer) {
+                std::lock_guard guard(registryLock);
+                registry.push_back(std::make_unique<Buffer>());
+                buffer = registry.back().get();
+                buffer->id = static_cast<std::uint32_t>(registry.size());
+                buffer->epoch.store(epoch.load(std::memory_order_acquire), std::memory_order_relaxed);
+                buffer->capacity = requested.load(std::memory_order_relaxed);
+            }
+            return *buffer;
+        }
+
+        // JSON string contents (names are our own literals and thread names, so only quotes and backslashes matter)
+        void escape(std::string &out, const char *text) {
+            for (; *text; text++) {
+                if (*text == '"' || *text == '\\') { out += '\\'; }
+                out += *text;
+            }
+        }
+    }
+
+    void Enable(bool on, std::size_t capacity) {
+        if (on) {
+            requested.store(std::max<std::size_t>(capacity, 1), std::memory_order_relaxed);
+            epoch.fetch_add(1, std::memory_order_acq_rel);
+        }
+        enabled.store(on, std::memory_order_relaxed);
+    }
+
+    void NameThread(const char *name) {
+        auto &buffer = local();
+        std::lock_guard guard(registryLock);
+        buffer.name = name;
+    }
+
+    void Record(const char *name, std::uint64_t startNs, std::uint64_t endNs) {
+        auto &buffer = local();
+        auto current = epoch.load(std::memory_order_acquire);
+        if (buffer.epoch.load(std::memory_order_relaxed) != current) {
+            buffer.count.store(0, std::memory_order_release);
+            buffer.dropped.store(0, std::memory_order_relaxed);
+            // a start that asked for another size gets a new buffer
+            if (auto capacity = requested.load(std::memory_order_relaxed); capacity != buffer.capacity) {
+                buffer.events.reset();
+                buffer.capacity = capacity;
+            }
+            buffer.epoch.store(current, std::memory_order_release);
+        }
+        auto index = buffer.count.load(std::memory_order_relaxed);
+        if (!buffer.events) { buffer.events = std::make_unique<Event[]>(buffer.capacity); }
+        if (index >= buffer.capacity) {
+            buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        buffer.events[index] = Event{name, startNs, endNs - startNs};
+        buffer.count.store(index + 1, std::memory_order_release);
+    }
+
+    std::size_t EventCount() {
+        std::lock_guard guard(registryLock);
+        std::size_t total = 0;
+        auto current = epoch.load(std::memory_order_acquire);
+        for (auto &buffer: registry) { if (buffer->epoch.load(std::memory_order_acquire) == current) { total += buffer->count.load(std::memory_order_acquire); } }
+        return total;
+    }
+
+    std::size_t DroppedCount() {
+        std::lock_guard guard(registryLock);
+        std::size_t total = 0;
+        auto current = epoch.load(std::memory_order_acquire);
+        for (auto &buffer: registry) { if (buffer->epoch.load(std::memory_order_acquire) == current) { total += buffer->dropped.load(std::memory_order_relaxed); } }
+        return total;
+    }
+
+    std::string Json() {
+        std::lock_guard guard(registryLock);
+        auto current = epoch.load(std::memory_order_acquire);
+        std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        auto separator = [&out, &first]() { if (!first) { out += ",\n"; } first = false; };
+        // timestamps relative to the earliest event, in microseconds with ns precision
+        std::uint64_t origin = ~std::uint64_t(0);
+        for (auto &buffer: registry) {
+            if (buffer->epoch.load(std::memory_order_acquire) != current) continue;
+            auto count = buffer->count.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < count; i++) { origin = std::min(origin, buffer->events[i].startNs); }
+        }
+        auto micros = [](std::uint64_t ns) { return std::to_string(ns / 1000) + "." + std::to_string(ns % 1000 + 1000).substr(1); };
+        for (auto &buffer: registry) {
+            auto tid = std::to_string(buffer->id);
+            if (!buffer->name.empty()) {
+                separator();
+                out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid + ",\"args\":{\"name\":\"";
+                escape(out, buffer->name.c_str());
+                out += "\"}}";
+            }
+            if (buffer->epoch.load(std::memory_order_acquire) != current) continue;
+            auto count = buffer->count.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < count; i++) {
+                auto &event = buffer->events[i];
+                separator();
+                out += "{\"name\":\"";
+                escape(out, event.name);
+                out += "\",\"ph\":\"X\",\"pid\":1,\"tid\":" + tid + ",\"ts\":" + micros(event.startNs - origin) + ",\"dur\":" + micros(event.durationNs) + "}";
+            }
+        }
+        out += "]}\n";
+        return out;
+    }
+
+    bool Write(const std::string &path) {
+        std::ofstream file(path, std::ios::binary);
+        if (!file) { return false; }
+        file << Json();
+        return static_cast<bool>(file);
+    }
+}
@@ -0,0 +1,77 @@
+/* Optional timeline tracer: spans of what each thread was doing, written out as Chrome trace-event JSON.
+ * ----------
+ * A span is recorded as one complete ("X") event when it ends, into a buffer owned by the thread that ran it: a
+ * single writer, so recording takes no lock and never waits on the dump. Buffers have the fixed size Enable asked
+ * for, allocated at a thread's first event after tracing starts (a thread that records nothing allocates nothing),
+ * and events past it are counted as dropped instead of growing anything. Write() turns every buffer into a JSON file that opens in
+ * chrome://tracing or ui.perfetto.dev.
+ *
+ * Built in unless STATFX_TRACE is off. While tracing isn't enabled, a span costs one relaxed atomic load and two
+ * branches: one when it starts, and one on its own start time when it ends (no second load of the flag). A span has to
+ * know at its end whether it started recording, so the second branch stays; it is on a register, and predicted.
+ *
+ * usage:
+ * trace::Enable(true);
+ * { STATFX_TRACE_SPAN("sample actors"); ... }
+ * trace::Write("StatFX.trace.json");
+*/
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace trace
+{
+    // events kept per thread between two Enable(true) calls, unless Enable asks for another number (24 bytes each)
+    constexpr std::size_t defaultCapacity = 1 << 16;
+
+    inline std::atomic<bool> enabled = false;
+
+    inline bool IsEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    // nanoseconds on the trace clock (steady, shared by every thread)
+    inline std::uint64_t Now() {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // start (clearing everything recorded so far, and keeping up to capacity events per thread) or stop recording
+    void Enable(bool on, std::size_t capacity = defaultCapacity);
+
+    // name the calling thread in the trace, e.g. "Overlay thread"
+    void NameThread(const char *name);
+
+    // record a finished span on the calling thread. name must outlive the trace (a string literal)
+    void Record(const char *name, std::uint64_t startNs, std::uint64_t endNs);
+
+    // events recorded since tracing was enabled, and events that didn't fit in their thread's buffer
+    std::size_t EventCount();
+    std::size_t DroppedCount();
+
+    // the trace as Chrome trace-event JSON
+    std::string Json();
+
+    // write Json() to a file. Returns false if it couldn't be written
+    bool Write(const std::string &path);
+
+    // times its scope as one span, if tracing was enabled when it started
+    class Span {
+    public:
+        explicit Span(const char *name) : name(name), start(IsEnabled() ? Now() : 0) {}
+        ~Span() { if (start) { Record(name, start, Now()); } }
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+    private:
+        const char *name;
+        std::uint64_t start;
+    };
+}
+
+#define STATFX_TRACE_CONCAT_(a, b) a##b
+#define STATFX_TRACE_CONCAT(a, b) STATFX_TRACE_CONCAT_(a, b)
+#ifdef STATFX_TRACE
+#define STATFX_TRACE_SPAN(name) trace::Span STATFX_TRACE_CONCAT(statfxTraceSpan, __LINE__)(name)
+#else
+#define STATFX_TRACE_SPAN(name) ((void)0)
+#endif